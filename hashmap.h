@@ -3,6 +3,7 @@
 #define HASHMAP_H
 
 #include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,13 +20,69 @@
  * different types of hashmaps as you want.
  *
  * HASHMAP_DECLARE() takes six arguments: the struct name, the function prefix,
- * the key type, the value type, an optional hash function (NULL for default
- * FNV-1a), and an optional key comparison function (NULL for memcmp).
+ * the key type, the value type, an optional hash function (NULL for
+ * hashmap_hash_buf() over the key's bytes), and an optional key comparison
+ * function (NULL for memcmp). Both are called directly, not through a pointer
+ * kept at runtime, so the compiler may inline them into lookups.
+ *
+ * HASHMAP_DECLARE_SEEDED() and HASHMAP_DEFINE_SEEDED() take the same six
+ * arguments, except that the hash function also takes the seed of the map:
+ * unsigned long hash(CustomKey key, unsigned long seed). Each map picks its
+ * own seed in hashmap_init() (see HASHMAP_SEED_SOURCE), so that keys chosen
+ * to collide, such as strings from the network, cannot be precomputed. The
+ * default hash over the key's bytes, and the hash of the string macros
+ * below, are seeded. A hash function passed to HASHMAP_DECLARE() ignores the
+ * seed.
  *
  * HASHMAP_DECLARE_STRING() takes three arguments: the struct name, the function
  * prefix, and the value type. The key type is automatically set to const char *,
- * the hash function to FNV-1a (reads string content instead of raw pointer),
- * and the comparison function to strcmp.
+ * the hash function to hashmap_hash_str_seeded() (reads string content
+ * instead of raw pointer), and the comparison function to strcmp.
+ *
+ * HASHMAP_DECLARE_STRING_VIEW() and HASHMAP_DEFINE_STRING_VIEW() take the same
+ * three arguments, for keys that are not NUL-terminated, such as fields
+ * parsed out of a network buffer. The key type is a generated struct holding
+ * a pointer and a length, e.g. HashmapStringView { const char *ptr;
+ * size_t len; }, hashed with hashmap_hash_buf_seeded() over len bytes and
+ * compared with memcmp.
+ * Looking up a key in place only takes a view of the buffer, built with the
+ * generated hashmap_string_view(ptr, len), with no copy. The map stores
+ * views, so the bytes of inserted keys must outlive them.
+ *
+ * HASHMAP_DECLARE_INT() and HASHMAP_DEFINE_INT() take four arguments: the
+ * struct name, the function prefix, the integer key type and the value type.
+ * Keys are compared with != and hashed with the MurmurHash3 finalizer, two
+ * rounds of xorshift and multiply in which every key bit reaches the low
+ * bits that select the bucket. Keys differing only in their high bits, or
+ * in the same stride as the capacity, spread like random ones instead of
+ * sharing buckets. Keys wider than unsigned long are folded into it first,
+ * and the seed of the map is xored in before mixing.
+ *
+ * HASHMAP_DECLARE_STRING_KEY() and HASHMAP_DEFINE_STRING_KEY() take the same
+ * three arguments as the string macros. Keys are generated records holding
+ * the pointer, length and hash of a string, e.g. HashmapStringKey {
+ * const char *ptr; size_t len; unsigned long hash; }, built once with
+ * hashmap_string_key(map, str) or hashmap_string_key_len(map, ptr, len).
+ * Operations then never scan the string again: hashing returns the stored
+ * hash, and comparisons reject on hash or length before comparing bytes
+ * with memcmp, 32 or 16 bytes at a time with AVX2 or SSE2. The hash is
+ * seeded, so a key is only valid for the map it was built with, which is
+ * initialized if needed, or maps sharing its seed. As with
+ * HASHMAP_DECLARE_STRING(), the map stores the pointers, not the bytes.
+ *
+ * HASHMAP_DECLARE_EQUAL() and HASHMAP_DEFINE_EQUAL() take six arguments: the
+ * struct name, the function prefix, the key type, the value type, an
+ * optional seeded hash function (NULL to hash the key's bytes), and the name
+ * of a function-like macro EQUAL(key1, key2) that is true when two keys are
+ * equal. It is expanded into the generated comparison function, so a chain
+ * walk compares keys without any call. HASHMAP_EQUAL_SCALAR compares with
+ * ==, for integer, enum and pointer keys. For structs, whose padding bytes
+ * memcmp would compare, pass a macro comparing their fields, such as
+ * #define POINT_EQUAL(a, b) ((a).x == (b).x && (a).y == (b).y), with a hash
+ * function over the same fields. A NULL hash function hashes every byte of
+ * the key, padding included, so keys equal under EQUAL may land in different
+ * buckets and never be found. Pass NULL only for keys without padding, or
+ * whose padding is always zeroed, e.g. with memset() before setting fields.
  *
  * Note that with HASHMAP_DECLARE() and HASHMAP_DEFINE() by default, the key
  * value itself is compared and hashed. For instance, if the key is a char * and
@@ -49,7 +106,53 @@
  * This library uses separate chaining with linked lists for collision
  * resolution.
  *
- * Load factor is set at 0.75, with capacity growing by powers of 2.
+ * Capacity grows once size / capacity exceeds the map's max_load_factor
+ * (default 0.75), multiplied by its growth_factor (default 2). It shrinks
+ * by the same factor once size / capacity falls below min_load_factor
+ * (default 0, never). These fields are set by hashmap_init(), and may be
+ * changed afterwards. growth_factor must be a power of 2, and
+ * min_load_factor * growth_factor must stay below max_load_factor.
+ *
+ * Alternative engines generate the same API (init, grow, insert, remove, get,
+ * has, size, free, iterate, duplicate, clear) from the same six arguments, so
+ * a map can switch engine by changing which macro pair generates it. Their
+ * maps also hold a seed picked by hashmap_init() and copied by
+ * hashmap_duplicate(), mixed into the default hash of the key's bytes. A hash
+ * function passed to them ignores it, and keys chosen to collide under that
+ * function collide in every map:
+ *
+ * - HASHMAP_DECLARE_ROBINHOOD() and HASHMAP_DEFINE_ROBINHOOD(): open
+ *   addressing over a flat slot array with Robin Hood displacement and
+ *   backward shift deletion. No per-entry allocation, and lookups scan
+ *   contiguous memory. Load factor is set at 0.9. The struct holds slots
+ *   instead of buckets and has no buckets_filled field.
+ *
+ * - HASHMAP_DECLARE_SWISS() and HASHMAP_DEFINE_SWISS(): SwissTable-style open
+ *   addressing. Slots are grouped by 16, each with a control byte holding a
+ *   7-bit hash fingerprint, so a lookup tests a whole group with one SSE2
+ *   compare (or portable SWAR code) before comparing any key. Load factor is
+ *   set at 0.875, and capacity is at least 16. The struct holds slots, ctrl
+ *   and a count of deleted slots instead of buckets and buckets_filled.
+ *
+ * - HASHMAP_DECLARE_CUCKOO() and HASHMAP_DEFINE_CUCKOO(): bucketized cuckoo
+ *   hashing. Buckets hold 4 entries, and a key lives in one of two buckets
+ *   derived from its hash, so a lookup reads at most two buckets. Inserting
+ *   into two full buckets evicts entries to their other bucket, at most 128
+ *   times. An entry still left out goes to a stash of 8 entries scanned by
+ *   lookups, and the table grows once the stash is full. Keys sharing a hash
+ *   that no capacity tells apart panic instead of growing it without bound.
+ *   Load factor is set at 0.9. The capacity field counts buckets, not
+ *   entries, there is no buckets_filled field, and the struct also holds
+ *   stash and stash_size.
+ *
+ * - HASHMAP_DECLARE_HOPSCOTCH() and HASHMAP_DEFINE_HOPSCOTCH(): hopscotch
+ *   hashing. Every key lives within 31 slots of its home slot, and each home
+ *   slot keeps a 32-bit hop word with a bitmap of where its keys are and a
+ *   flag of its own occupancy, so a lookup only compares the keys flagged in
+ *   one bitmap. Keys finding no slot go to a stash of 8 entries, growing the
+ *   table once it is full, as with the cuckoo engine. Load factor is set at
+ *   0.9, and capacity is at least 32. The struct holds slots instead of
+ *   buckets, stash and stash_size, and has no buckets_filled field.
  *
  * To configure this library #define the symbols before including the library.
  * This is usually done in the header file where HASHMAP_DECLARE() is called.
@@ -65,6 +168,42 @@
  * - HASHMAP_FREE (default free(3)): specify the deallocator. If using a
  *   custom deallocator, must also specify HASHMAP_REALLOC.
  *
+ * - HASHMAP_INCREMENTAL_REHASH (default 0): if non-zero, growing the default
+ *   engine keeps the old bucket array next to the new one instead of moving
+ *   every entry at once. Each insert and remove then migrates this many old
+ *   buckets, bounding the cost of any single operation. Get, remove and
+ *   iterate look into both arrays until the migration is done. The load
+ *   factor is not checked while migrating.
+ *
+ * - HASHMAP_SLAB_SIZE (default 0): if non-zero, the default engine carves
+ *   chain nodes from slabs of this many nodes instead of allocating them one
+ *   by one. Removed nodes go to a per-map free list for reuse, and slabs are
+ *   only released by hashmap_clear() and hashmap_free(), in one call per slab.
+ *
+ * - HASHMAP_CACHE_HASH (default 0): if true (1), chain nodes of the default
+ *   engine store the full hash of their key. Chain walks then only call the
+ *   comparison function on nodes with an equal hash, and growing or
+ *   shrinking never calls the hash function. Costs one unsigned long per
+ *   node. Must be defined before including the library.
+ *
+ * - HASHMAP_SEED_SOURCE(map) (default mixes time(), clock() and the address
+ *   of map): expression giving the entropy hashmap_init() picks the seed of
+ *   map from. The default is cheap but guessable without address space
+ *   layout randomization, define it to a call to getrandom(2), arc4random(3)
+ *   or the like where keys come from untrusted input. A constant makes
+ *   hashes reproducible, and 0 makes seeded hashes equal unseeded ones.
+ *
+ * - HASHMAP_NO_SSE2 (default undefined): if defined, the SwissTable engine
+ *   probes groups with portable SWAR code even where SSE2 is available, and
+ *   HASHMAP_DECLARE_STRING_KEY() maps compare bytes with memcmp() instead of
+ *   SSE2 or AVX2. Must be defined before including the library.
+ *
+ * - HASHMAP_INLINE (default inline in C99, __inline__ with GCC or Clang,
+ *   __inline with MSVC, empty otherwise): marks the functions calling the
+ *   hash and comparison functions of a map, so that the calls are inlined
+ *   into lookups. Define it empty to keep them out of line. Must be defined
+ *   before including the library.
+ *
  * - HASHMAP_LONG_JUMP_NO_ABORT (default undefined): for testing only. Jump to
  *   externally defined "jmp_buf abort_jmp" instead of panicking. Unlike other
  *   configuration options, must be defined before including the library.
@@ -73,7 +212,7 @@
  * API Functions:
  *
  * The following documentation takes this generated hashmap for instance:
- * HASHMAP_DECLARE(Hashmap, hashmap, const char *, int, fnv1a_32_str, strcmp)
+ * HASHMAP_DECLARE(Hashmap, hashmap, const char *, int, hash_str, strcmp)
  *
  * All functions panic if map is NULL (unless HASHMAP_NO_PANIC_ON_NULL).
  *
@@ -81,26 +220,99 @@
  *   Initialize empty hashmap with default capacity. Leaks memory if initializes
  *   an already initialized hashmap.
  *
+ * void hashmap_init_seeded(Hashmap *map, unsigned long seed)
+ *   Same, with seed as the seed of map instead of one picked from
+ *   HASHMAP_SEED_SOURCE, so that map shares the hashes of another map.
+ *
  * void hashmap_free(Hashmap *map)
  *   Deallocate hashmap memory. Safe to call on already-freed hashmaps.
  *
  * void hashmap_grow(Hashmap *map)
- *   Increase capacity to next power of 2. Auto-initializes empty hashmaps.
- *   No-op if growth would cause overflow.
+ *   Multiply capacity by growth_factor. Auto-initializes empty hashmaps.
+ *   No-op if growth would cause overflow. With HASHMAP_INCREMENTAL_REHASH,
+ *   completes any pending migration, then starts a new one.
+ *
+ * void hashmap_reserve(Hashmap *map, size_t count)
+ *   Grow capacity to the smallest power of 2 holding count elements within
+ *   max_load_factor, so that inserting up to count elements never grows.
+ *   All nodes are relinked at once, even with HASHMAP_INCREMENTAL_REHASH.
+ *   No-op if capacity is already large enough, or up to the largest
+ *   capacity that does not overflow. Auto-initializes empty hashmaps.
+ *
+ * void hashmap_shrink_to_fit(Hashmap *map)
+ *   Shrink capacity to the smallest power of 2, at least the default
+ *   capacity, holding the current elements within max_load_factor. Nodes are
+ *   relinked, never reallocated. Keeps the current capacity if allocating
+ *   the smaller bucket array fails. No-op on uninitialized hashmaps.
  *
  * int hashmap_insert(Hashmap *map, const char *key, int value)
  *   Insert or update key-value pair. Auto-initializes empty hashmaps.
- *   Grows capacity if load factor exceeds 0.75. Returns 1 if key existed
- *   and value was overwritten, 0 if new key was inserted.
+ *   Grows capacity if load factor exceeds max_load_factor. Returns 1 if key
+ *   existed and value was overwritten, 0 if new key was inserted.
+ *
+ * void hashmap_insert_unique(Hashmap *map, const char *key, int value)
+ *   Insert a key known to be missing from the hashmap, pushing it at the
+ *   head of its chain without comparing any key, e.g. for bulk loading
+ *   deduplicated data. Inserting an existing key this way is undefined
+ *   behavior, which assert() catches in debug builds. Grows and
+ *   auto-initializes like hashmap_insert().
+ *
+ * void hashmap_build_from_arrays(Hashmap *map, const char *const *keys,
+ *                                const int *values, size_t count)
+ *   Insert count key-value pairs from two parallel arrays, as hashmap_insert()
+ *   would one by one: a key appearing twice keeps its last value. Capacity is
+ *   reserved once, every key hashed in one pass, then sorted by bucket
+ *   (counting sort) so that nodes are allocated chain after chain, and with
+ *   HASHMAP_SLAB_SIZE laid out contiguously. Temporarily allocates two
+ *   arrays of count elements and one of capacity + 1. Auto-initializes empty
+ *   hashmaps.
+ *
+ * int *hashmap_get_or_insert(Hashmap *map, const char *key, int default_value,
+ *                            int *inserted)
+ *   Return a pointer to the value of key, inserting default_value first if
+ *   key is missing, with a single hash and chain walk. If inserted is
+ *   non-NULL, stores 1 if key was inserted, 0 if it existed. The pointer
+ *   follows the rules of hashmap_get_ptr(). Auto-initializes empty hashmaps.
+ *
+ * int hashmap_upsert(Hashmap *map, const char *key,
+ *                    void (*callback)(const char *key, int *value, int existed,
+ *                                     void *context),
+ *                    void *context)
+ *   Call callback once on the value of key, with a single hash and chain walk.
+ *   If key is missing, it is first inserted with a zero-filled value and
+ *   existed is 0, so the callback can tell initializing from merging. The
+ *   callback must not modify the hashmap. Returns 1 if key existed, 0 if it
+ *   was inserted. Panics if callback is NULL (unless
+ *   HASHMAP_NO_PANIC_ON_NULL). Auto-initializes empty hashmaps.
  *
  * int hashmap_remove(Hashmap *map, const char *key, int *out)
  *   Remove key-value pair. If out is non-NULL, stores removed value.
+ *   Divides capacity by growth_factor (halves it by default) if load factor
+ *   falls below min_load_factor, which never happens unless it is set.
  *   Returns 1 if key was found and removed, 0 otherwise.
  *
  * int hashmap_get(const Hashmap *map, const char *key, int *out)
  *   Get value for key. If out is non-NULL, stores value.
  *   Returns 1 if key found, 0 otherwise.
  *
+ * size_t hashmap_get_many(const Hashmap *map, const char *const *keys,
+ *                         size_t count, int *out_values, int *out_found)
+ *   Get the values of count keys at once. Keys are hashed and their buckets
+ *   and first nodes prefetched 16 at a time before any chain is walked, so
+ *   the cache misses of a batch overlap instead of adding up. If out_values
+ *   is non-NULL, stores the value of each found key at the same index, and
+ *   leaves the others untouched. If out_found is non-NULL, stores 1 for
+ *   found keys and 0 for the others. Returns the number of keys found.
+ *
+ * int *hashmap_get_ptr(Hashmap *map, const char *key)
+ *   Return a pointer to the value stored for key, NULL if not found, to read
+ *   or update it in place without a second lookup. Nodes never move, so the
+ *   pointer stays valid across inserts, hashmap_grow(), hashmap_reserve()
+ *   and shrinking, in every configuration. It is invalidated by removing
+ *   this key (its node may then be reused with HASHMAP_SLAB_SIZE), and by
+ *   hashmap_clear() and hashmap_free(). Alternative engines move entries
+ *   and do not provide it.
+ *
  * int hashmap_has(const Hashmap *map, const char *key)
  *   Check if key exists in hashmap. Returns 1 if found, 0 otherwise.
  *
@@ -113,13 +325,72 @@
  *   Callback should return 1 to continue iteration, 0 to stop.
  *   No-op if iteration_callback is NULL.
  *
+ * void hashmap_iter_begin(Hashmap *map, HashmapIter *iter)
+ *   Start iterating over map with an external iterator, in the same order
+ *   as hashmap_iterate(). Unlike it, no callback is involved, iteration can
+ *   stop and resume at will, and several maps can be walked in lockstep.
+ *   Inserting or removing through other functions invalidates iterators,
+ *   and so does growing, shrinking or clearing. Uninitialized hashmaps
+ *   have no elements.
+ *
+ * int hashmap_iter_next(HashmapIter *iter, const char *const **key,
+ *                       int **value)
+ *   Advance iter to the next element. Returns 1 and, if key and value are
+ *   non-NULL, stores pointers to the element's key and value, which may be
+ *   modified in place. Returns 0 once every element was visited.
+ *
+ * int hashmap_iter_remove(HashmapIter *iter)
+ *   Remove the element last returned by hashmap_iter_next(), without
+ *   looking it up again. Iteration then continues with the next element.
+ *   Its key and value pointers are invalidated. Never shrinks the hashmap.
+ *   Returns 1 if removed, 0 if there is no current element.
+ *
  * void hashmap_duplicate(Hashmap *dest, const Hashmap *src)
  *   Copy src hashmap to dest. dest must be uninitialized. Overwrites existing
  *   dest data without freeing it.
  *
  * void hashmap_clear(Hashmap *map)
  *   Remove all elements without deallocating capacity. Safe to call on
- *   uninitialized hashmaps.
+ *   uninitialized hashmaps. Call hashmap_shrink_to_fit() afterwards to
+ *   release the bucket array down to the default capacity.
+ *
+ * unsigned long hashmap_hash(const Hashmap *map, const char *key)
+ *   Return the full hash of key, as computed by the hash function the
+ *   hashmap was generated with and the seed of map. It does not depend on
+ *   the capacity, so it stays valid across grows, and for every hashmap
+ *   generated with the same hash function holding the same seed field.
+ *   hashmap_init() picks the seed, so map must be initialized first.
+ *   hashmap_duplicate() copies the seed. To share it with a new map, pass it
+ *   to hashmap_init_seeded(): assigning the seed field of a map before it is
+ *   initialized does nothing, since the first insert initializes the map
+ *   and picks a new seed.
+ *
+ * unsigned long hashmap_hash_buf(const void *buf, size_t len)
+ * unsigned long hashmap_hash_str(const char *str)
+ *   Default hash functions, over len bytes of buf or over the characters of
+ *   str. They read a word at a time (8 bytes where unsigned long has 64 bits,
+ *   4 otherwise) and return a full unsigned long, so short strings cost a
+ *   few multiplies instead of one per byte. hashmap_hash_str(str) equals
+ *   hashmap_hash_buf(str, strlen(str)). The former hashmap_fnv1a_32_buf()
+ *   and hashmap_fnv1a_32_str() are still generated.
+ *
+ * unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+ *                                       unsigned long seed)
+ * unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+ *   Same with a seed, mixed into every word, for seeded hash functions.
+ *   Seed 0 gives the same hashes as hashmap_hash_buf() and
+ *   hashmap_hash_str().
+ *
+ * int hashmap_insert_hashed(Hashmap *map, const char *key, unsigned long hash,
+ *                           int value)
+ * int hashmap_get_hashed(const Hashmap *map, const char *key,
+ *                        unsigned long hash, int *out)
+ * int hashmap_remove_hashed(Hashmap *map, const char *key, unsigned long hash,
+ *                           int *out)
+ *   Same as hashmap_insert(), hashmap_get() and hashmap_remove(), with the
+ *   hash of key computed beforehand by hashmap_hash(), so that a key is
+ *   hashed only once for several operations or hashmaps. Passing any other
+ *   hash is undefined behavior, which assert() catches in debug builds.
  *
  *
  * Example:
@@ -163,6 +434,42 @@
 #define HASHMAP_NO_PANIC_ON_NULL 0
 #endif
 
+#ifndef HASHMAP_INCREMENTAL_REHASH
+#define HASHMAP_INCREMENTAL_REHASH 0
+#endif
+
+#ifndef HASHMAP_SLAB_SIZE
+#define HASHMAP_SLAB_SIZE 0
+#endif
+
+#ifndef HASHMAP_CACHE_HASH
+#define HASHMAP_CACHE_HASH 0
+#endif
+
+/* Access to the hash cached in chain nodes, or the hash recomputed with
+ * hash_func and the seed of map when nodes do not cache it */
+#if HASHMAP_CACHE_HASH
+#define HASHMAP_NODE_HASH_FIELD unsigned long hash;
+#define HASHMAP_NODE_SET_HASH(node, hash_) ((node)->hash = (hash_))
+#define HASHMAP_NODE_HASH(node, hash_func, map) ((void)(map), (node)->hash)
+#define HASHMAP_NODE_HASH_DIFFERS(node, hash_) ((node)->hash != (hash_))
+#else
+#define HASHMAP_NODE_HASH_FIELD
+#define HASHMAP_NODE_SET_HASH(node, hash_) ((void)(hash_))
+#define HASHMAP_NODE_HASH(node, hash_func, map) (hash_func((map), (node)->key))
+#define HASHMAP_NODE_HASH_DIFFERS(node, hash_) ((void)(hash_), 0)
+#endif
+
+/* Default entropy for the seed of each map: the time, the processor time and
+ * the map address, which differs from run to run with address space layout
+ * randomization */
+#ifndef HASHMAP_SEED_SOURCE
+#include <time.h>
+#define HASHMAP_SEED_SOURCE(map)                                    \
+	((unsigned long)time(NULL) ^ (unsigned long)clock() << 16 ^ \
+	 (unsigned long)(size_t)(const void *)(map))
+#endif
+
 #ifdef HASHMAP_LONG_JUMP_NO_ABORT
 #include <setjmp.h>
 extern jmp_buf abort_jmp;
@@ -178,6 +485,103 @@ extern jmp_buf abort_jmp;
 #define HASHMAP_NORETURN
 #endif
 
+#ifndef HASHMAP_INLINE
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define HASHMAP_INLINE inline
+#elif defined(__GNUC__) || defined(__clang__)
+#define HASHMAP_INLINE __inline__
+#elif defined(_MSC_VER)
+#define HASHMAP_INLINE __inline
+#else
+#define HASHMAP_INLINE
+#endif
+#endif /* HASHMAP_INLINE */
+
+#if !defined(HASHMAP_NO_SSE2) &&                                      \
+	(defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+	 (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define HASHMAP_SSE2 1
+#define HASHMAP_SSE2_MATCH(group, byte)                                        \
+	((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(                       \
+		_mm_loadu_si128((const __m128i *)(const void *)(group)),       \
+		_mm_set1_epi8((char)(byte)))))
+#define HASHMAP_SSE2_MATCH_HIGH(group)   \
+	((unsigned int)_mm_movemask_epi8( \
+		_mm_loadu_si128((const __m128i *)(const void *)(group))))
+#else
+#define HASHMAP_SSE2 0
+#define HASHMAP_SSE2_MATCH(group, byte) 0U
+#define HASHMAP_SSE2_MATCH_HIGH(group) 0U
+#endif
+
+/* Equality of HASHMAP_KEY_BLOCK bytes at a and b, for long string keys: one
+ * AVX2 or SSE2 compare, or memcmp() */
+#if defined(__AVX2__) && !defined(HASHMAP_NO_SSE2)
+#include <immintrin.h>
+#define HASHMAP_KEY_BLOCK 32
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b)                                      \
+	(_mm256_movemask_epi8(_mm256_cmpeq_epi8(                           \
+		 _mm256_loadu_si256((const __m256i *)(const void *)(a)),   \
+		 _mm256_loadu_si256((const __m256i *)(const void *)(b)))) == \
+	 -1)
+#elif HASHMAP_SSE2
+#define HASHMAP_KEY_BLOCK 16
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b)                                    \
+	(_mm_movemask_epi8(_mm_cmpeq_epi8(                               \
+		 _mm_loadu_si128((const __m128i *)(const void *)(a)),     \
+		 _mm_loadu_si128((const __m128i *)(const void *)(b)))) == \
+	 0xFFFF)
+#else
+#define HASHMAP_KEY_BLOCK 16
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b) (memcmp((a), (b), HASHMAP_KEY_BLOCK) == 0)
+#endif
+
+/* Start loading the cache line at addr, or nothing where unsupported */
+#if defined(__GNUC__) || defined(__clang__)
+#define HASHMAP_PREFETCH(addr) (__builtin_prefetch((const void *)(addr)))
+#elif HASHMAP_SSE2
+#define HASHMAP_PREFETCH(addr) \
+	(_mm_prefetch((const char *)(const void *)(addr), _MM_HINT_T0))
+#else
+#define HASHMAP_PREFETCH(addr) ((void)(addr))
+#endif
+
+/* Word-at-a-time default hash, see hashmap_hash_buf(). Uses 64-bit words and
+ * output where unsigned long has 64 bits, otherwise MurmurHash3_x86_32 on
+ * 32-bit words. Words are read little-endian so that hashes do not depend on
+ * the platform's byte order. HASHMAP_HASH_FMIX, the MurmurHash3 finalizer,
+ * also hashes integer keys. */
+#define HASHMAP_HASH_ROTL(x, r, bits) (((x) << (r)) | ((x) >> ((bits) - (r))))
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define HASHMAP_HASH_WORD_SIZE 8
+#define HASHMAP_HASH_LOAD(p)                                                  \
+	((unsigned long)(p)[0] | (unsigned long)(p)[1] << 8 |                 \
+	 (unsigned long)(p)[2] << 16 | (unsigned long)(p)[3] << 24 |          \
+	 (unsigned long)(p)[4] << 32 | (unsigned long)(p)[5] << 40 |          \
+	 (unsigned long)(p)[6] << 48 | (unsigned long)(p)[7] << 56)
+#define HASHMAP_HASH_MIX(k)                                                    \
+	(HASHMAP_HASH_ROTL((k) * 0x87C37B91114253D5UL, 31, 64) *               \
+	 0x4CF5AD432745937FUL)
+#define HASHMAP_HASH_STEP(h) \
+	(HASHMAP_HASH_ROTL((h), 27, 64) * 5 + 0x52DCE729UL)
+#define HASHMAP_HASH_FMIX(h)                                           \
+	((h) ^= (h) >> 33, (h) *= 0xFF51AFD7ED558CCDUL, (h) ^= (h) >> 33, \
+	 (h) *= 0xC4CEB9FE1A85EC53UL, (h) ^= (h) >> 33)
+#else
+#define HASHMAP_HASH_WORD_SIZE 4
+#define HASHMAP_HASH_LOAD(p)                                  \
+	((unsigned long)(p)[0] | (unsigned long)(p)[1] << 8 | \
+	 (unsigned long)(p)[2] << 16 | (unsigned long)(p)[3] << 24)
+#define HASHMAP_HASH_MIX(k) \
+	(HASHMAP_HASH_ROTL((k) * 0xCC9E2D51UL, 15, 32) * 0x1B873593UL)
+#define HASHMAP_HASH_STEP(h) \
+	(HASHMAP_HASH_ROTL((h), 13, 32) * 5 + 0xE6546B64UL)
+#define HASHMAP_HASH_FMIX(h)                                      \
+	((h) ^= (h) >> 16, (h) *= 0x85EBCA6BUL, (h) ^= (h) >> 13, \
+	 (h) *= 0xC2B2AE35UL, (h) ^= (h) >> 16)
+#endif
+
 #ifndef __STDC_VERSION__
 #define RESTRICT
 #else
@@ -186,28 +590,308 @@ extern jmp_buf abort_jmp;
 
 
 
+
 #define HASHMAP_LOAD_FACTOR 0.75f
-enum { HASHMAP_DEFAULT_CAPACITY = 8, HASHMAP_GROWTH_FACTOR = 2 };
+#define HASHMAP_MIN_LOAD_FACTOR 0.0f
+#define HASHMAP_ROBINHOOD_LOAD_FACTOR 0.9f
+#define HASHMAP_SWISS_LOAD_FACTOR 0.875f
+#define HASHMAP_CUCKOO_LOAD_FACTOR 0.9f
+#define HASHMAP_HOPSCOTCH_LOAD_FACTOR 0.9f
+enum {
+	HASHMAP_DEFAULT_CAPACITY = 8,
+	HASHMAP_GROWTH_FACTOR = 2,
+	HASHMAP_SWISS_GROUP_SIZE = 16,
+	HASHMAP_CUCKOO_BUCKET_SIZE = 4,
+	HASHMAP_CUCKOO_MAX_KICKS = 128,
+	HASHMAP_CUCKOO_STASH_SIZE = 8,
+	HASHMAP_HOPSCOTCH_NEIGHBORHOOD = 31,
+	HASHMAP_HOPSCOTCH_STASH_SIZE = 8,
+	HASHMAP_PREFETCH_BATCH = 16,
+	HASHMAP_STASH_MAX_SPREAD = 64
+};
+enum { HASHMAP_SWISS_EMPTY = 0x80, HASHMAP_SWISS_DELETED = 0xFE };
+
+/* Hop word of a hopscotch slot: the neighborhood bitmap, then the flag of an
+ * occupied slot. 32 bits keep a slot with a pointer key and an int value at
+ * 16 bytes on 64-bit targets. */
+#if UINT_MAX >= 0xFFFFFFFFUL
+#define HASHMAP_HOP unsigned int
+#else
+#define HASHMAP_HOP unsigned long
+#endif
+#define HASHMAP_HOPSCOTCH_OCCUPIED \
+	((HASHMAP_HOP)1 << HASHMAP_HOPSCOTCH_NEIGHBORHOOD)
+
 
+#define HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			Custom_Value_Type_, Custom_Hash_Func_,             \
+			Custom_Comparison_Func_)                           \
+	HASHMAP_DECLARE_IMPL(Struct_Name_, Functions_Prefix_,              \
+			     Custom_Key_Type_, Custom_Value_Type_,         \
+			     Custom_Hash_Func_, NULL, Custom_Comparison_Func_)
+
+#define HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_,      \
+		       Custom_Value_Type_, Custom_Hash_Func_,                  \
+		       Custom_Comparison_Func_)                                \
+	HASHMAP_DEFINE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			    Custom_Value_Type_, Custom_Hash_Func_, NULL,       \
+			    Custom_Comparison_Func_)
+
+#define HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,          \
+			       Custom_Key_Type_, Custom_Value_Type_,     \
+			       Custom_Seeded_Hash_Func_,                 \
+			       Custom_Comparison_Func_)                  \
+	HASHMAP_DECLARE_IMPL(Struct_Name_, Functions_Prefix_,            \
+			     Custom_Key_Type_, Custom_Value_Type_, NULL, \
+			     Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)
+
+#define HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Custom_Key_Type_, Custom_Value_Type_,            \
+			      Custom_Seeded_Hash_Func_,                        \
+			      Custom_Comparison_Func_)                         \
+	HASHMAP_DEFINE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			    Custom_Value_Type_, NULL,                          \
+			    Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)
 
 #define HASHMAP_DECLARE_STRING(Struct_Name_, Functions_Prefix_,               \
 			       Custom_Value_Type_)                            \
-	HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, const char *,        \
-			Custom_Value_Type_, Functions_Prefix_##_fnv1a_32_str, \
-			strcmp)
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_, const char *, \
+			       Custom_Value_Type_,                            \
+			       Functions_Prefix_##_hash_str_seeded, strcmp)
 
 #define HASHMAP_DEFINE_STRING(Struct_Name_, Functions_Prefix_,               \
 			      Custom_Value_Type_)                            \
-	HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, const char *,        \
-		       Custom_Value_Type_, Functions_Prefix_##_fnv1a_32_str, \
-		       strcmp)
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_, const char *, \
+			      Custom_Value_Type_,                            \
+			      Functions_Prefix_##_hash_str_seeded, strcmp)
+
+#define HASHMAP_DECLARE_STRING_VIEW(Struct_Name_, Functions_Prefix_,           \
+				    Custom_Value_Type_)                        \
+	typedef struct Struct_Name_##StringView {                              \
+		const char *ptr;                                               \
+		size_t len;                                                    \
+	} Struct_Name_##StringView;                                            \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			       Struct_Name_##StringView, Custom_Value_Type_,   \
+			       Functions_Prefix_##_string_view_hash,           \
+			       Functions_Prefix_##_string_view_compare)        \
+	Struct_Name_##StringView Functions_Prefix_##_string_view(              \
+		const char *ptr, size_t len);                                  \
+	unsigned long Functions_Prefix_##_string_view_hash(                    \
+		Struct_Name_##StringView key, unsigned long seed);             \
+	int Functions_Prefix_##_string_view_compare(                           \
+		Struct_Name_##StringView key1, Struct_Name_##StringView key2);
+
+#define HASHMAP_DEFINE_STRING_VIEW(Struct_Name_, Functions_Prefix_,            \
+				   Custom_Value_Type_)                         \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Struct_Name_##StringView, Custom_Value_Type_,    \
+			      Functions_Prefix_##_string_view_hash,            \
+			      Functions_Prefix_##_string_view_compare)         \
+	Struct_Name_##StringView Functions_Prefix_##_string_view(              \
+		const char *ptr, size_t len)                                   \
+	{                                                                      \
+		Struct_Name_##StringView ret;                                  \
+		ret.ptr = ptr;                                                 \
+		ret.len = len;                                                 \
+		return ret;                                                    \
+	}                                                                      \
+	unsigned long Functions_Prefix_##_string_view_hash(                    \
+		Struct_Name_##StringView key, unsigned long seed)              \
+	{                                                                      \
+		return Functions_Prefix_##_hash_buf_seeded(key.ptr, key.len,   \
+							   seed);              \
+	}                                                                      \
+	int Functions_Prefix_##_string_view_compare(                           \
+		Struct_Name_##StringView key1, Struct_Name_##StringView key2)  \
+	{                                                                      \
+		if (key1.len != key2.len) {                                    \
+			return key1.len < key2.len ? -1 : 1;                   \
+		}                                                              \
+		if (key1.len == 0) {                                           \
+			return 0;                                              \
+		}                                                              \
+		return memcmp(key1.ptr, key2.ptr, key1.len);                   \
+	}
+
+#define HASHMAP_DECLARE_INT(Struct_Name_, Functions_Prefix_,                \
+			    Custom_Key_Type_, Custom_Value_Type_)           \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,             \
+			       Custom_Key_Type_, Custom_Value_Type_,        \
+			       Functions_Prefix_##_hash_int,                \
+			       Functions_Prefix_##_compare_int)             \
+	unsigned long Functions_Prefix_##_hash_int(Custom_Key_Type_ key,    \
+						   unsigned long seed);     \
+	int Functions_Prefix_##_compare_int(Custom_Key_Type_ key1,          \
+					    Custom_Key_Type_ key2);
+
+#define HASHMAP_DEFINE_INT(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			   Custom_Value_Type_)                                \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			      Custom_Key_Type_, Custom_Value_Type_,           \
+			      Functions_Prefix_##_hash_int,                   \
+			      Functions_Prefix_##_compare_int)                \
+	unsigned long Functions_Prefix_##_hash_int(Custom_Key_Type_ key,      \
+						   unsigned long seed)        \
+	{                                                                     \
+		unsigned long word = (unsigned long)key;                      \
+		size_t half = HASHMAP_HASH_WORD_SIZE * CHAR_BIT / 2;          \
+		if (sizeof(Custom_Key_Type_) > sizeof(unsigned long)) {       \
+			/* Fold bits that do not fit, such as 64-bit keys     \
+			 * where long has 32 bits. Never shifts narrower      \
+			 * keys by their width. */                            \
+			word ^= (unsigned long)(key >> half >> half);         \
+		}                                                             \
+		/* Xorshift-multiply finalizer over the whole word, so that   \
+		 * the low bits bucket indexes are masked from depend on      \
+		 * every key bit */                                           \
+		word ^= seed;                                                 \
+		HASHMAP_HASH_FMIX(word);                                      \
+		return word;                                                  \
+	}                                                                     \
+	int Functions_Prefix_##_compare_int(Custom_Key_Type_ key1,            \
+					    Custom_Key_Type_ key2)            \
+	{                                                                     \
+		return key1 != key2;                                          \
+	}
+
+#define HASHMAP_DECLARE_STRING_KEY(Struct_Name_, Functions_Prefix_,            \
+				   Custom_Value_Type_)                         \
+	typedef struct Struct_Name_##StringKey {                               \
+		const char *ptr;                                               \
+		size_t len;                                                    \
+		unsigned long hash;                                            \
+	} Struct_Name_##StringKey;                                             \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			       Struct_Name_##StringKey, Custom_Value_Type_,    \
+			       Functions_Prefix_##_string_key_hash,            \
+			       Functions_Prefix_##_string_key_compare)         \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key(                \
+		Struct_Name_ *map, const char *str);                           \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key_len(            \
+		Struct_Name_ *map, const char *ptr, size_t len);               \
+	unsigned long Functions_Prefix_##_string_key_hash(                     \
+		Struct_Name_##StringKey key, unsigned long seed);              \
+	int Functions_Prefix_##_string_key_compare(                            \
+		Struct_Name_##StringKey key1, Struct_Name_##StringKey key2);   \
+	int Functions_Prefix_##_bytes_equal(const char *ptr1,                  \
+					    const char *ptr2, size_t len);
+
+#define HASHMAP_DEFINE_STRING_KEY(Struct_Name_, Functions_Prefix_,             \
+				  Custom_Value_Type_)                          \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Struct_Name_##StringKey, Custom_Value_Type_,     \
+			      Functions_Prefix_##_string_key_hash,             \
+			      Functions_Prefix_##_string_key_compare)          \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key(                \
+		Struct_Name_ *map, const char *str)                            \
+	{                                                                      \
+		return Functions_Prefix_##_string_key_len(map, str,            \
+							  strlen(str));        \
+	}                                                                      \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key_len(            \
+		Struct_Name_ *map, const char *ptr, size_t len)                \
+	{                                                                      \
+		Struct_Name_##StringKey ret;                                   \
+		/* The hash depends on the seed hashmap_init() picks */        \
+		if (map != NULL && map->buckets == NULL) {                     \
+			Functions_Prefix_##_init(map);                         \
+		}                                                              \
+		ret.ptr = ptr;                                                 \
+		ret.len = len;                                                 \
+		ret.hash = Functions_Prefix_##_hash_buf_seeded(                \
+			ptr, len, map != NULL ? map->seed : 0);                \
+		return ret;                                                    \
+	}                                                                      \
+	unsigned long Functions_Prefix_##_string_key_hash(                     \
+		Struct_Name_##StringKey key, unsigned long seed)               \
+	{                                                                      \
+		/* Debug test for a key made for a map with another seed */    \
+		assert(key.hash ==                                             \
+		       Functions_Prefix_##_hash_buf_seeded(key.ptr, key.len,   \
+							   seed));             \
+		(void)seed;                                                    \
+		return key.hash;                                               \
+	}                                                                      \
+	int Functions_Prefix_##_string_key_compare(                            \
+		Struct_Name_##StringKey key1, Struct_Name_##StringKey key2)    \
+	{                                                                      \
+		/* Most different keys differ by hash or length */             \
+		if (key1.hash != key2.hash || key1.len != key2.len) {          \
+			return 1;                                              \
+		}                                                              \
+		return !Functions_Prefix_##_bytes_equal(key1.ptr, key2.ptr,    \
+							key1.len);             \
+	}                                                                      \
+	int Functions_Prefix_##_bytes_equal(const char *ptr1,                  \
+					    const char *ptr2, size_t len)      \
+	{                                                                      \
+		size_t pos = 0;                                                \
+		if (len < HASHMAP_KEY_BLOCK) {                                 \
+			return len == 0 || memcmp(ptr1, ptr2, len) == 0;       \
+		}                                                              \
+		for (; pos + HASHMAP_KEY_BLOCK < len;                          \
+		     pos += HASHMAP_KEY_BLOCK) {                               \
+			if (!HASHMAP_KEY_BLOCK_EQUAL(ptr1 + pos,               \
+						     ptr2 + pos)) {            \
+				return 0;                                      \
+			}                                                      \
+		}                                                              \
+		/* Last block, overlapping the previous one if len is not a    \
+		 * multiple of the block size */                               \
+		pos = len - HASHMAP_KEY_BLOCK;                                 \
+		return HASHMAP_KEY_BLOCK_EQUAL(ptr1 + pos, ptr2 + pos);        \
+	}
+
+/* Key equality for HASHMAP_DECLARE_EQUAL(), for keys == compares by value */
+#define HASHMAP_EQUAL_SCALAR(key1, key2) ((key1) == (key2))
+
+/* With a NULL hash function, keys are hashed by their bytes, padding
+ * included: struct keys need a hash over the fields Equal_Macro_ compares,
+ * or zeroed padding */
+
+#define HASHMAP_DECLARE_EQUAL(Struct_Name_, Functions_Prefix_,               \
+			      Custom_Key_Type_, Custom_Value_Type_,          \
+			      Custom_Seeded_Hash_Func_, Equal_Macro_)        \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,              \
+			       Custom_Key_Type_, Custom_Value_Type_,         \
+			       Custom_Seeded_Hash_Func_,                     \
+			       Functions_Prefix_##_compare_equal)            \
+	int Functions_Prefix_##_compare_equal(Custom_Key_Type_ key1,         \
+					      Custom_Key_Type_ key2);
+
+#define HASHMAP_DEFINE_EQUAL(Struct_Name_, Functions_Prefix_,         \
+			     Custom_Key_Type_, Custom_Value_Type_,    \
+			     Custom_Seeded_Hash_Func_, Equal_Macro_)  \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,        \
+			      Custom_Key_Type_, Custom_Value_Type_,   \
+			      Custom_Seeded_Hash_Func_,               \
+			      Functions_Prefix_##_compare_equal)      \
+	int Functions_Prefix_##_compare_equal(Custom_Key_Type_ key1,  \
+					      Custom_Key_Type_ key2)  \
+	{                                                             \
+		return !(Equal_Macro_(key1, key2));                   \
+	}
 
-#define HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+#define HASHMAP_DECLARE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)\
 \
 struct Struct_Name_##ListNode {\
 	struct Struct_Name_##ListNode *next;\
 	Custom_Key_Type_ key;\
 	Custom_Value_Type_ value;\
+	/* Full hash of key, with HASHMAP_CACHE_HASH */\
+	HASHMAP_NODE_HASH_FIELD\
+};\
+\
+/* Header of a slab, followed by HASHMAP_SLAB_SIZE nodes. The union keeps\
+ * these nodes aligned. */\
+union Struct_Name_##Slab {\
+	struct {\
+		union Struct_Name_##Slab *next;\
+		/* Nodes carved so far */\
+		size_t used;\
+	} header;\
+	struct Struct_Name_##ListNode align;\
 };\
 \
 typedef struct Struct_Name_ {\
@@ -217,48 +901,140 @@ typedef struct Struct_Name_ {\
 	size_t size;\
 	size_t capacity;\
 	size_t buckets_filled;\
+	/* Grow when size / capacity exceeds this */\
+	float max_load_factor;\
+	/* Shrink when size / capacity falls below this, 0 to never shrink */\
+	float min_load_factor;\
+	/* Power of 2 by which capacity grows or shrinks */\
+	size_t growth_factor;\
+	/* Mixed into every hash, picked by Functions_Prefix_##_init() */\
+	unsigned long seed;\
+	/* Buckets not migrated yet by incremental rehashing, or NULL */\
+	struct Struct_Name_##ListNode **old_buckets;\
+	size_t old_capacity;\
+	/* Old buckets below this index are migrated */\
+	size_t rehash_idx;\
+	/* Slabs nodes are carved from, with HASHMAP_SLAB_SIZE */\
+	union Struct_Name_##Slab *slabs;\
+	/* Removed nodes waiting for reuse, with HASHMAP_SLAB_SIZE */\
+	struct Struct_Name_##ListNode *free_nodes;\
 } Struct_Name_;\
 \
+/* External iterator, see Functions_Prefix_##_iter_begin() */\
+typedef struct Struct_Name_##Iter {\
+	struct Struct_Name_ *map;\
+	/* Link to the current node: a bucket or the previous node's next\
+	 * field. NULL before the first node. */\
+	struct Struct_Name_##ListNode **link;\
+	/* Bucket of the current node */\
+	size_t bucket;\
+	/* Walking old buckets, not migrated yet */\
+	int in_old;\
+	/* Current node was removed, link already leads to the next one */\
+	int removed;\
+} Struct_Name_##Iter;\
+\
 /* API functions */\
 void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_init_seeded(Struct_Name_ *map, unsigned long seed);\
 void Functions_Prefix_##_grow(Struct_Name_ *map);\
+void Functions_Prefix_##_reserve(Struct_Name_ *map, size_t count);\
+void Functions_Prefix_##_shrink_to_fit(Struct_Name_ *map);\
 int Functions_Prefix_##_insert(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_insert_hashed(Struct_Name_ *map, Custom_Key_Type_ key, unsigned long hash,\
+			  Custom_Value_Type_ value);\
+void Functions_Prefix_##_insert_unique(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+void Functions_Prefix_##_build_from_arrays(Struct_Name_ *RESTRICT map,\
+			       Custom_Key_Type_ const *RESTRICT keys,\
+			       Custom_Value_Type_ const *RESTRICT values,\
+			       size_t count);\
+Custom_Value_Type_ *Functions_Prefix_##_get_or_insert(Struct_Name_ *map, Custom_Key_Type_ key,\
+				   Custom_Value_Type_ default_value, int *inserted);\
+int Functions_Prefix_##_upsert(Struct_Name_ *map, Custom_Key_Type_ key,\
+		   void (*callback)(Custom_Key_Type_ key, Custom_Value_Type_ *value,\
+				    int existed, void *context),\
+		   void *context);\
 int Functions_Prefix_##_remove(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
 		   Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_remove_hashed(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+			  unsigned long hash, Custom_Value_Type_ *RESTRICT out);\
 int Functions_Prefix_##_get(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
 		Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_get_hashed(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		       unsigned long hash, Custom_Value_Type_ *RESTRICT out);\
+size_t Functions_Prefix_##_get_many(const Struct_Name_ *RESTRICT map,\
+			Custom_Key_Type_ const *RESTRICT keys, size_t count,\
+			Custom_Value_Type_ *RESTRICT out_values,\
+			int *RESTRICT out_found);\
+Custom_Value_Type_ *Functions_Prefix_##_get_ptr(Struct_Name_ *map, Custom_Key_Type_ key);\
 int Functions_Prefix_##_has(const Struct_Name_ *map, Custom_Key_Type_ key);\
 size_t Functions_Prefix_##_size(const Struct_Name_ *map);\
 void Functions_Prefix_##_free(Struct_Name_ *map);\
 void Functions_Prefix_##_iterate(Struct_Name_ *map, void *context);\
 void Functions_Prefix_##_duplicate(Struct_Name_ *RESTRICT dest, Struct_Name_ *RESTRICT src);\
 void Functions_Prefix_##_clear(Struct_Name_ *map);\
+unsigned long Functions_Prefix_##_hash(const Struct_Name_ *map, Custom_Key_Type_ key);\
+void Functions_Prefix_##_iter_begin(Struct_Name_ *RESTRICT map, Struct_Name_##Iter *RESTRICT iter);\
+int Functions_Prefix_##_iter_next(Struct_Name_##Iter *RESTRICT iter,\
+		      Custom_Key_Type_ const **RESTRICT key,\
+		      Custom_Value_Type_ **RESTRICT value);\
+int Functions_Prefix_##_iter_remove(Struct_Name_##Iter *iter);\
 \
 /* Internal functions */\
 void Functions_Prefix_##_assert(const Struct_Name_ *map);\
 void Functions_Prefix_##_assert_internal(const struct Struct_Name_ *map);\
-struct Struct_Name_##ListNode *Functions_Prefix_##_list_new(struct Struct_Name_##ListNode *next,\
-					 Custom_Key_Type_ key, Custom_Value_Type_ value);\
+struct Struct_Name_##ListNode *Functions_Prefix_##_node_alloc(Struct_Name_ *map);\
+void Functions_Prefix_##_node_free(Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT node);\
+void Functions_Prefix_##_nodes_free(Struct_Name_ *map);\
+struct Struct_Name_##ListNode *Functions_Prefix_##_list_new(Struct_Name_ *map,\
+					 struct Struct_Name_##ListNode *next,\
+					 Custom_Key_Type_ key, unsigned long hash,\
+					 Custom_Value_Type_ value);\
 int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_,\
 								Custom_Key_Type_);\
-int Functions_Prefix_##_grow_internal(Custom_Key_Type_ key, Custom_Value_Type_ value, void *new_map);\
 int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2);\
-int Functions_Prefix_##_list_insert(struct Struct_Name_##ListNode *head, Custom_Key_Type_ key,\
-			Custom_Value_Type_ value);\
-int Functions_Prefix_##_list_find(struct Struct_Name_##ListNode *RESTRICT head, Custom_Key_Type_ key,\
-		      Custom_Value_Type_ *RESTRICT out);\
-int Functions_Prefix_##_list_remove(struct Struct_Name_##ListNode **RESTRICT list, Custom_Key_Type_ key,\
-			Custom_Value_Type_ *RESTRICT out);\
+struct Struct_Name_##ListNode *\
+Functions_Prefix_##_list_insert(Struct_Name_ *RESTRICT map, struct Struct_Name_##ListNode *head,\
+		    Custom_Key_Type_ key, unsigned long hash, Custom_Value_Type_ value,\
+		    int *RESTRICT inserted);\
+struct Struct_Name_##ListNode *Functions_Prefix_##_list_find(struct Struct_Name_##ListNode *head,\
+					  Custom_Key_Type_ key, unsigned long hash);\
+void Functions_Prefix_##_make_room(Struct_Name_ *map);\
+struct Struct_Name_##ListNode *Functions_Prefix_##_entry(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+				      unsigned long hash, Custom_Value_Type_ value,\
+				      int *RESTRICT inserted);\
+int Functions_Prefix_##_list_remove(Struct_Name_ *RESTRICT map,\
+			struct Struct_Name_##ListNode **RESTRICT list, Custom_Key_Type_ key,\
+			unsigned long hash, Custom_Value_Type_ *RESTRICT out);\
 int Functions_Prefix_##_list_iterate(struct Struct_Name_##ListNode *head,\
 			 int (*callback)(Custom_Key_Type_ key, Custom_Value_Type_ value,\
 					 void *context),\
 			 void *context);\
-void Functions_Prefix_##_list_free(struct Struct_Name_##ListNode *head);\
-struct Struct_Name_##ListNode *Functions_Prefix_##_list_duplicate(struct Struct_Name_##ListNode *head);\
+void Functions_Prefix_##_list_free(Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT head);\
+void Functions_Prefix_##_list_split(const Struct_Name_ *map, struct Struct_Name_##ListNode *head,\
+			size_t bit, struct Struct_Name_##ListNode **RESTRICT stay,\
+			struct Struct_Name_##ListNode **RESTRICT move);\
+struct Struct_Name_##ListNode *\
+Functions_Prefix_##_list_duplicate(Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT head);\
 unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_);\
+unsigned long (*Functions_Prefix_##_compare_seeded_hash_callback(void))(Custom_Key_Type_,\
+							     unsigned long);\
 size_t Functions_Prefix_##_hash_index(const Struct_Name_ *map, Custom_Key_Type_ key);\
+struct Struct_Name_##ListNode **Functions_Prefix_##_bucket(const Struct_Name_ *map,\
+					unsigned long hash);\
+void Functions_Prefix_##_rehash_step(Struct_Name_ *map, size_t steps);\
+void Functions_Prefix_##_expand(Struct_Name_ *map, size_t new_capacity);\
+void Functions_Prefix_##_shrink(Struct_Name_ *map, size_t new_capacity);\
 unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len);\
-unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_hash_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed);\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed);
 
 #ifdef HASHMAP_LONG_JUMP_NO_ABORT
 #define HASHMAP_DEFINE_PANIC(Function_Prefix_)                              \
@@ -277,7 +1053,7 @@ unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);
 	}
 #endif
 
-#define HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+#define HASHMAP_DEFINE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)\
 struct Struct_Name_;\
 struct Struct_Name_##ListNode;\
 HASHMAP_DEFINE_PANIC(Functions_Prefix_)\
@@ -289,6 +1065,7 @@ void Functions_Prefix_##_assert(const struct Struct_Name_ *map)\
 		assert(map->size == 0);\
 		assert(map->buckets_filled == 0);\
 		assert(map->capacity == 0);\
+		assert(map->old_buckets == NULL);\
 		return;\
 	}\
 \
@@ -301,24 +1078,119 @@ void Functions_Prefix_##_assert_internal(const struct Struct_Name_ *map)\
 	/* Capacity must be a power of 2 and non-zero */\
 	assert(map->capacity > 0);\
 	assert((map->capacity & (map->capacity - 1)) == 0);\
+\
+	/* Tuning invariants */\
+	assert(map->max_load_factor > 0.0f);\
+	assert(map->min_load_factor >= 0.0f);\
+	assert(map->growth_factor >= 2);\
+	assert((map->growth_factor & (map->growth_factor - 1)) == 0);\
+	assert(map->min_load_factor * (float)map->growth_factor <\
+	       map->max_load_factor);\
 \
 	/* Size invariants */\
 	assert(map->size >= map->buckets_filled);\
-	assert(map->buckets_filled <= map->capacity);\
+	assert(map->buckets_filled <= map->capacity + map->old_capacity);\
+\
+	/* Migration invariants */\
+	if (map->old_buckets == NULL) {\
+		assert(map->old_capacity == 0);\
+		assert(map->rehash_idx == 0);\
+	} else {\
+		assert((map->old_capacity & (map->old_capacity - 1)) == 0);\
+		assert(map->rehash_idx < map->old_capacity);\
+	}\
 }\
 \
-struct Struct_Name_##ListNode *Functions_Prefix_##_list_new(struct Struct_Name_##ListNode *next,\
-					 Custom_Key_Type_ key, Custom_Value_Type_ value)\
+struct Struct_Name_##ListNode *Functions_Prefix_##_node_alloc(struct Struct_Name_ *map)\
 {\
-	struct Struct_Name_##ListNode *ret = (struct Struct_Name_##ListNode *)HASHMAP_REALLOC(\
-		NULL, sizeof(struct Struct_Name_##ListNode));\
-	if (ret == NULL) {\
-		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	struct Struct_Name_##ListNode *ret = NULL;\
+	union Struct_Name_##Slab *slab = NULL;\
+\
+	if (!HASHMAP_SLAB_SIZE) {\
+		ret = (struct Struct_Name_##ListNode *)HASHMAP_REALLOC(\
+			NULL, sizeof(struct Struct_Name_##ListNode));\
+		if (ret == NULL) {\
+			Functions_Prefix_##_panic("Out of memory. Panic.");\
+		}\
+		return ret;\
+	}\
+\
+	if (map->free_nodes != NULL) {\
+		ret = map->free_nodes;\
+		map->free_nodes = ret->next;\
+		return ret;\
+	}\
+\
+	if (map->slabs == NULL ||\
+	    map->slabs->header.used == (size_t)HASHMAP_SLAB_SIZE) {\
+		slab = (union Struct_Name_##Slab *)HASHMAP_REALLOC(\
+			NULL, sizeof(union Struct_Name_##Slab) +\
+				      (size_t)HASHMAP_SLAB_SIZE *\
+					      sizeof(struct Struct_Name_##ListNode));\
+		if (slab == NULL) {\
+			Functions_Prefix_##_panic("Out of memory. Panic.");\
+		}\
+\
+		slab->header.next = map->slabs;\
+		slab->header.used = 0;\
+		map->slabs = slab;\
+	}\
+\
+	ret = (struct Struct_Name_##ListNode *)(void *)(map->slabs + 1) +\
+	      map->slabs->header.used;\
+	map->slabs->header.used++;\
+\
+	return ret;\
+}\
+\
+void Functions_Prefix_##_node_free(struct Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT node)\
+{\
+	if (!HASHMAP_SLAB_SIZE) {\
+		HASHMAP_FREE(node);\
+		return;\
+	}\
+\
+	node->next = map->free_nodes;\
+	map->free_nodes = node;\
+}\
+\
+/* Release every node of the map, in both bucket arrays */\
+void Functions_Prefix_##_nodes_free(struct Struct_Name_ *map)\
+{\
+	union Struct_Name_##Slab *next = NULL;\
+	size_t idx = 0;\
+\
+	if (HASHMAP_SLAB_SIZE) {\
+		/* Whole slabs at once, without walking the chains */\
+		for (; map->slabs != NULL; map->slabs = next) {\
+			next = map->slabs->header.next;\
+			HASHMAP_FREE((void *)map->slabs);\
+		}\
+		map->free_nodes = NULL;\
+		return;\
+	}\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		Functions_Prefix_##_list_free(map, map->buckets[idx]);\
+	}\
+\
+	for (idx = map->rehash_idx; idx < map->old_capacity; idx++) {\
+		Functions_Prefix_##_list_free(map, map->old_buckets[idx]);\
 	}\
+}\
+\
+struct Struct_Name_##ListNode *Functions_Prefix_##_list_new(struct Struct_Name_ *map,\
+					 struct Struct_Name_##ListNode *next,\
+					 Custom_Key_Type_ key, unsigned long hash,\
+					 Custom_Value_Type_ value)\
+{\
+	struct Struct_Name_##ListNode *ret = Functions_Prefix_##_node_alloc(map);\
 \
 	ret->next = next;\
 	ret->key = key;\
 	ret->value = value;\
+	HASHMAP_NODE_SET_HASH(ret, hash);\
 \
 	return ret;\
 }\
@@ -345,6 +1217,14 @@ void Functions_Prefix_##_init(struct Struct_Name_ *map)\
 \
 	map->capacity = HASHMAP_DEFAULT_CAPACITY;\
 	assert(map->capacity > 0);\
+\
+	map->max_load_factor = HASHMAP_LOAD_FACTOR;\
+	map->min_load_factor = HASHMAP_MIN_LOAD_FACTOR;\
+	map->growth_factor = HASHMAP_GROWTH_FACTOR;\
+\
+	/* Spread the raw entropy over every bit */\
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));\
+	HASHMAP_HASH_FMIX(map->seed);\
 \
 	memset((void *)map->buckets, 0,\
 	       map->capacity * sizeof(struct Struct_Name_##ListNode *));\
@@ -352,16 +1232,31 @@ void Functions_Prefix_##_init(struct Struct_Name_ *map)\
 	Functions_Prefix_##_assert(map);\
 }\
 \
+void Functions_Prefix_##_init_seeded(struct Struct_Name_ *map, unsigned long seed)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_init_seeded but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_init(map);\
+	map->seed = seed;\
+}\
+\
 int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_,\
 								Custom_Key_Type_)\
 {\
 	return Custom_Comparison_Func_;\
 }\
 \
-int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
+HASHMAP_INLINE int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
 {\
-	int (*callback)(Custom_Key_Type_, Custom_Key_Type_) =\
-		Functions_Prefix_##_compare_comparison_callback();\
+	/* Known when the Functions_Prefix_## is generated: the compiler drops the NULL\
+	 * test and calls, or inlines, the function directly */\
+	int (*const callback)(Custom_Key_Type_, Custom_Key_Type_) = Custom_Comparison_Func_;\
 \
 	if (callback == NULL) {\
 		return memcmp((void *)&key1, (void *)&key2, sizeof(Custom_Key_Type_));\
@@ -369,9 +1264,12 @@ int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key
 	return callback(key1, key2);\
 }\
 \
-/* Assume the first node isn't NULL */\
-int Functions_Prefix_##_list_insert(struct Struct_Name_##ListNode *head, Custom_Key_Type_ key,\
-			Custom_Value_Type_ value)\
+/* Return the node of key, appending one holding value if there is none.\
+ * head must not be NULL. */\
+struct Struct_Name_##ListNode *\
+Functions_Prefix_##_list_insert(struct Struct_Name_ *RESTRICT map, struct Struct_Name_##ListNode *head,\
+		    Custom_Key_Type_ key, unsigned long hash, Custom_Value_Type_ value,\
+		    int *RESTRICT inserted)\
 {\
 	struct Struct_Name_##ListNode *prev = NULL;\
 	size_t iter = 0;\
@@ -382,20 +1280,21 @@ int Functions_Prefix_##_list_insert(struct Struct_Name_##ListNode *head, Custom_
 		/* Debug test for infinite loops */\
 		assert(iter < 0xFFFFFFFFUL);\
 \
-		if (Functions_Prefix_##_compare_keys(key, head->key) == 0) {\
-			/* Override existing value */\
-			head->value = value;\
-			return 1;\
+		if (!HASHMAP_NODE_HASH_DIFFERS(head, hash) &&\
+		    Functions_Prefix_##_compare_keys(key, head->key) == 0) {\
+			*inserted = 0;\
+			return head;\
 		}\
 	}\
 \
 	/* Append to end of list */\
-	prev->next = Functions_Prefix_##_list_new(NULL, key, value);\
-	return 0;\
+	prev->next = Functions_Prefix_##_list_new(map, NULL, key, hash, value);\
+	*inserted = 1;\
+	return prev->next;\
 }\
 \
-int Functions_Prefix_##_list_find(struct Struct_Name_##ListNode *RESTRICT head, Custom_Key_Type_ key,\
-		      Custom_Value_Type_ *RESTRICT out)\
+struct Struct_Name_##ListNode *Functions_Prefix_##_list_find(struct Struct_Name_##ListNode *head,\
+					  Custom_Key_Type_ key, unsigned long hash)\
 {\
 	size_t iter = 0;\
 \
@@ -403,19 +1302,18 @@ int Functions_Prefix_##_list_find(struct Struct_Name_##ListNode *RESTRICT head,
 		/* Debug test for infinite loops */\
 		assert(iter < 0xFFFFFFFFUL);\
 \
-		if (Functions_Prefix_##_compare_keys(head->key, key) == 0) {\
-			if (out != NULL) {\
-				*out = head->value;\
-			}\
-			return 1;\
+		if (!HASHMAP_NODE_HASH_DIFFERS(head, hash) &&\
+		    Functions_Prefix_##_compare_keys(head->key, key) == 0) {\
+			return head;\
 		}\
 	}\
 \
-	return 0;\
+	return NULL;\
 }\
 \
-int Functions_Prefix_##_list_remove(struct Struct_Name_##ListNode **RESTRICT list, Custom_Key_Type_ key,\
-			Custom_Value_Type_ *RESTRICT out)\
+int Functions_Prefix_##_list_remove(struct Struct_Name_ *RESTRICT map,\
+			struct Struct_Name_##ListNode **RESTRICT list, Custom_Key_Type_ key,\
+			unsigned long hash, Custom_Value_Type_ *RESTRICT out)\
 {\
 	struct Struct_Name_##ListNode *head = NULL;\
 	struct Struct_Name_##ListNode *prev = NULL;\
@@ -431,7 +1329,8 @@ int Functions_Prefix_##_list_remove(struct Struct_Name_##ListNode **RESTRICT lis
 		/* Debug test for infinite loops */\
 		assert(iter < 0xFFFFFFFFUL);\
 \
-		if (Functions_Prefix_##_compare_keys(head->key, key) != 0) {\
+		if (HASHMAP_NODE_HASH_DIFFERS(head, hash) ||\
+		    Functions_Prefix_##_compare_keys(head->key, key) != 0) {\
 			continue;\
 		}\
 \
@@ -445,7 +1344,7 @@ int Functions_Prefix_##_list_remove(struct Struct_Name_##ListNode **RESTRICT lis
 			prev->next = head->next;\
 		}\
 \
-		HASHMAP_FREE(head);\
+		Functions_Prefix_##_node_free(map, head);\
 		return 1;\
 	}\
 \
@@ -473,7 +1372,8 @@ int Functions_Prefix_##_list_iterate(struct Struct_Name_##ListNode *head,\
 	return 1;\
 }\
 \
-void Functions_Prefix_##_list_free(struct Struct_Name_##ListNode *head)\
+void Functions_Prefix_##_list_free(struct Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT head)\
 {\
 	struct Struct_Name_##ListNode *next = NULL;\
 	size_t iter = 0;\
@@ -483,12 +1383,40 @@ void Functions_Prefix_##_list_free(struct Struct_Name_##ListNode *head)\
 		assert(iter < 0xFFFFFFFFUL);\
 \
 		next = head->next;\
-		HASHMAP_FREE(head);\
+		Functions_Prefix_##_node_free(map, head);\
 		head = next;\
 	}\
 }\
 \
-struct Struct_Name_##ListNode *Functions_Prefix_##_list_duplicate(struct Struct_Name_##ListNode *head)\
+/* Split a chain by the hash bit that doubling the capacity adds, keeping the\
+ * order of nodes */\
+void Functions_Prefix_##_list_split(const struct Struct_Name_ *map,\
+			struct Struct_Name_##ListNode *head, size_t bit,\
+			struct Struct_Name_##ListNode **RESTRICT stay,\
+			struct Struct_Name_##ListNode **RESTRICT move)\
+{\
+	size_t iter = 0;\
+\
+	for (iter = 0; head != NULL; head = head->next, iter++) {\
+		/* Debug test for infinite loops */\
+		assert(iter < 0xFFFFFFFFUL);\
+\
+		if ((HASHMAP_NODE_HASH(head, Functions_Prefix_##_hash, map) & bit) == 0) {\
+			*stay = head;\
+			stay = &head->next;\
+		} else {\
+			*move = head;\
+			move = &head->next;\
+		}\
+	}\
+\
+	*stay = NULL;\
+	*move = NULL;\
+}\
+\
+struct Struct_Name_##ListNode *\
+Functions_Prefix_##_list_duplicate(struct Struct_Name_ *RESTRICT map,\
+		       struct Struct_Name_##ListNode *RESTRICT head)\
 {\
 	struct Struct_Name_##ListNode *new_head = NULL;\
 	struct Struct_Name_##ListNode *new_next = NULL;\
@@ -498,16 +1426,20 @@ struct Struct_Name_##ListNode *Functions_Prefix_##_list_duplicate(struct Struct_
 		return NULL;\
 	}\
 \
-	new_head = Functions_Prefix_##_list_new(NULL, head->key, head->value);\
+	/* Nodes are copied whole, along with any cached hash */\
+	new_head = Functions_Prefix_##_node_alloc(map);\
+	*new_head = *head;\
 	new_next = new_head;\
 \
 	for (iter = 0; head->next != NULL;\
 	     head = head->next, new_next = new_next->next, iter++) {\
 		/* Debug test for infinite loops */\
 		assert(iter < 0xFFFFFFFFUL);\
-		new_next->next = Functions_Prefix_##_list_new(NULL, head->next->key,\
-						  head->next->value);\
+		new_next->next = Functions_Prefix_##_node_alloc(map);\
+		*new_next->next = *head->next;\
 	}\
+\
+	new_next->next = NULL;\
 \
 	return new_head;\
 }\
@@ -517,30 +1449,140 @@ unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type
 	return Custom_Hash_Func_;\
 }\
 \
+unsigned long (*Functions_Prefix_##_compare_seeded_hash_callback(void))(Custom_Key_Type_,\
+							     unsigned long)\
+{\
+	return Custom_Seeded_Hash_Func_;\
+}\
+\
+HASHMAP_INLINE unsigned long Functions_Prefix_##_hash(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	unsigned long (*const callback)(Custom_Key_Type_) = Custom_Hash_Func_;\
+	unsigned long (*const seeded_callback)(Custom_Key_Type_, unsigned long) =\
+		Custom_Seeded_Hash_Func_;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return 0;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_hash but non-null argument expected.");\
+	}\
+\
+	if (seeded_callback != NULL) {\
+		return seeded_callback(key, map->seed);\
+	}\
+	if (callback != NULL) {\
+		return callback(key);\
+	}\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)&key, sizeof(Custom_Key_Type_),\
+				       map->seed);\
+}\
+\
 size_t Functions_Prefix_##_hash_index(const struct Struct_Name_ *map,\
 					 Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_hash(map, key) & (map->capacity - 1);\
+}\
+\
+/* Bucket of a key's hash, in the old array if it was not migrated yet */\
+struct Struct_Name_##ListNode **Functions_Prefix_##_bucket(const struct Struct_Name_ *map,\
+					unsigned long hash)\
 {\
 	size_t idx = 0;\
-	unsigned long (*callback)(Custom_Key_Type_) = Functions_Prefix_##_compare_hash_callback();\
 \
-	if (callback == NULL) {\
-		idx = Functions_Prefix_##_fnv1a_32_buf((const void *)&key,\
-					   sizeof(Custom_Key_Type_));\
-	} else {\
-		idx = callback(key);\
+	if (map->old_buckets != NULL) {\
+		idx = hash & (map->old_capacity - 1);\
+		if (idx >= map->rehash_idx) {\
+			return &map->old_buckets[idx];\
+		}\
+	}\
+\
+	return &map->buckets[hash & (map->capacity - 1)];\
+}\
+\
+/* Relink the nodes of up to steps old buckets into the new array. Old\
+ * bucket idx spreads over the still empty new buckets idx + n * old_capacity,\
+ * split in halves once per doubling of the capacity. */\
+void Functions_Prefix_##_rehash_step(struct Struct_Name_ *map, size_t steps)\
+{\
+	size_t idx = 0;\
+	size_t bit = 0;\
+	size_t pos = 0;\
+\
+	for (; steps > 0 && map->old_buckets != NULL; steps--) {\
+		assert(map->capacity > map->old_capacity);\
+\
+		idx = map->rehash_idx;\
+\
+		if (map->old_buckets[idx] != NULL) {\
+			assert(map->buckets_filled > 0);\
+			map->buckets_filled--;\
+\
+			assert(map->buckets[idx] == NULL);\
+			map->buckets[idx] = map->old_buckets[idx];\
+			map->old_buckets[idx] = NULL;\
+\
+			for (bit = map->old_capacity; bit < map->capacity;\
+			     bit <<= 1) {\
+				for (pos = idx; pos < bit;\
+				     pos += map->old_capacity) {\
+					assert(map->buckets[pos + bit] == NULL);\
+					Functions_Prefix_##_list_split(\
+						map, map->buckets[pos], bit,\
+						&map->buckets[pos],\
+						&map->buckets[pos + bit]);\
+				}\
+			}\
+\
+			for (pos = idx; pos < map->capacity;\
+			     pos += map->old_capacity) {\
+				map->buckets_filled +=\
+					map->buckets[pos] != NULL;\
+			}\
+		}\
+\
+		map->rehash_idx++;\
+\
+		if (map->rehash_idx == map->old_capacity) {\
+			HASHMAP_FREE((void *)map->old_buckets);\
+			map->old_buckets = NULL;\
+			map->old_capacity = 0;\
+			map->rehash_idx = 0;\
+		}\
 	}\
+}\
+\
+/* Start migrating to a new array of new_capacity buckets, a power of 2 above\
+ * the current capacity. Nodes are relinked into it, never reallocated. */\
+void Functions_Prefix_##_expand(struct Struct_Name_ *map, size_t new_capacity)\
+{\
+	size_t new_capacity_size = 0;\
+	struct Struct_Name_##ListNode **new_buckets = NULL;\
 \
-	idx &= map->capacity - 1;\
+	assert(map->old_buckets == NULL);\
+	assert(new_capacity > map->capacity);\
+	assert((new_capacity & (new_capacity - 1)) == 0);\
 \
-	return idx;\
+	new_capacity_size = new_capacity * sizeof(struct Struct_Name_##ListNode *);\
+	new_buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
+		NULL, new_capacity_size);\
+	if (new_buckets == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+	memset((void *)new_buckets, 0, new_capacity_size);\
+\
+	map->old_buckets = map->buckets;\
+	map->old_capacity = map->capacity;\
+	map->rehash_idx = 0;\
+	map->buckets = new_buckets;\
+	map->capacity = new_capacity;\
 }\
 \
 void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
 {\
 	size_t new_capacity = 0;\
-	struct Struct_Name_ new_map = { 0 };\
-	int (*iteration_callback_backup)(Custom_Key_Type_, Custom_Value_Type_, void *);\
-	size_t new_capacity_size = 0;\
 \
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
@@ -556,76 +1598,40 @@ void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
 		Functions_Prefix_##_init(map);\
 	}\
 \
-	iteration_callback_backup = map->iteration_callback;\
-\
-	/* Calculate the next power of 2 */\
-	new_capacity = map->capacity;\
-	new_capacity |= new_capacity >> 1;\
-	new_capacity |= new_capacity >> 2;\
-	new_capacity |= new_capacity >> 4;\
-	new_capacity |= new_capacity >> 8;\
-	if (sizeof(size_t) >= 4) {\
-		new_capacity |= new_capacity >> 16;\
-	}\
-	if (sizeof(size_t) >= 8) {\
-		new_capacity |= new_capacity >> 32;\
-	}\
-	new_capacity++;\
+	/* Finish the pending migration before starting another */\
+	Functions_Prefix_##_rehash_step(map, map->old_capacity);\
 \
-	if (new_capacity < map->capacity) {\
+	if (map->capacity > ((size_t)-1) / map->growth_factor) {\
 		/* Overflow, do not grow, let separate chaining handle\
 		 * collisions */\
 		return;\
 	}\
+\
+	new_capacity = map->capacity * map->growth_factor;\
+\
 	if (new_capacity > ((size_t)-1) / sizeof(struct Struct_Name_##ListNode *)) {\
 		/* Would overflow, do not grow, let separate chaining handle\
 		 * collisions */\
 		return;\
 	}\
 \
-	new_capacity_size = new_capacity * sizeof(struct Struct_Name_##ListNode *);\
-	new_map.capacity = new_capacity;\
-	new_map.buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
-		NULL, new_capacity_size);\
-	if (new_map.buckets == NULL) {\
-		Functions_Prefix_##_panic("Out of memory. Panic.");\
-	}\
-	memset((void *)new_map.buckets, 0, new_capacity_size);\
-\
-	map->iteration_callback = Functions_Prefix_##_grow_internal;\
-	Functions_Prefix_##_iterate(map, &new_map);\
+	Functions_Prefix_##_expand(map, new_capacity);\
 \
-	assert(map->size >= new_map.size);\
-	if (map->size != new_map.size) {\
-		/* Failed to grow, revert operation */\
-		map->iteration_callback = iteration_callback_backup;\
-		Functions_Prefix_##_free(&new_map);\
-		return;\
+	if (!HASHMAP_INCREMENTAL_REHASH) {\
+		Functions_Prefix_##_rehash_step(map, map->old_capacity);\
 	}\
-\
-	Functions_Prefix_##_free(map);\
-	*map = new_map;\
-	map->iteration_callback = iteration_callback_backup;\
-}\
-\
-int Functions_Prefix_##_grow_internal(Custom_Key_Type_ key, Custom_Value_Type_ value, void *new_map)\
-{\
-	/* Should never overwrite */\
-	assert(Functions_Prefix_##_insert(new_map, key, value) == 0);\
-	return 1;\
 }\
 \
-int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+void Functions_Prefix_##_reserve(struct Struct_Name_ *map, size_t count)\
 {\
-	size_t idx = 0;\
-	int overwritten = 0;\
+	size_t new_capacity = 0;\
 \
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
-			return -1;\
+			return;\
 		}\
 		Functions_Prefix_##_panic(\
-			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+			"Null passed to "#Functions_Prefix_"_reserve but non-null argument expected.");\
 	}\
 \
 	Functions_Prefix_##_assert(map);\
@@ -634,34 +1640,3426 @@ int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, C
 		Functions_Prefix_##_init(map);\
 	}\
 \
-	/* Check for being above load factor */\
-	if ((float)map->buckets_filled / (float)map->capacity >\
-	    HASHMAP_LOAD_FACTOR) {\
-		Functions_Prefix_##_grow(map);\
-	}\
-\
-	idx = Functions_Prefix_##_hash_index(map, key);\
+	/* Finish the pending migration before starting another */\
+	Functions_Prefix_##_rehash_step(map, map->old_capacity);\
 \
-	if (map->buckets[idx] == NULL) {\
-		map->buckets[idx] = Functions_Prefix_##_list_new(NULL, key, value);\
-		map->buckets_filled++;\
-		map->size++;\
-		return 0;\
+	/* Smallest power of 2 holding count within the load factor */\
+	new_capacity = map->capacity;\
+	while ((float)count / (float)new_capacity > map->max_load_factor) {\
+		if (new_capacity >\
+		    ((size_t)-1) / sizeof(struct Struct_Name_##ListNode *) / 2) {\
+			/* Would overflow, keep the largest capacity */\
+			break;\
+		}\
+		new_capacity *= 2;\
 	}\
 \
-	overwritten = Functions_Prefix_##_list_insert(map->buckets[idx], key, value);\
-	if (!overwritten) {\
-		map->size++;\
+	if (new_capacity == map->capacity) {\
+		return;\
 	}\
 \
-	return overwritten;\
+	/* Relink everything at once, reserving is meant to be paid upfront */\
+	Functions_Prefix_##_expand(map, new_capacity);\
+	Functions_Prefix_##_rehash_step(map, map->old_capacity);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+/* Concatenate the chains of buckets idx + n * new_capacity into bucket idx.\
+ * Nodes are relinked, their hash never computed. */\
+void Functions_Prefix_##_shrink(struct Struct_Name_ *map, size_t new_capacity)\
+{\
+	struct Struct_Name_##ListNode **new_buckets = NULL;\
+	struct Struct_Name_##ListNode **tail = NULL;\
+	size_t idx = 0;\
+	size_t old = 0;\
+\
+	assert(map->old_buckets == NULL);\
+	assert(new_capacity > 0 && new_capacity <= map->capacity);\
+	assert((new_capacity & (new_capacity - 1)) == 0);\
+\
+	new_buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
+		NULL, new_capacity * sizeof(struct Struct_Name_##ListNode *));\
+	if (new_buckets == NULL) {\
+		/* Shrinking is optional, keep the current buckets */\
+		return;\
+	}\
+\
+	map->buckets_filled = 0;\
+\
+	for (idx = 0; idx < new_capacity; idx++) {\
+		tail = &new_buckets[idx];\
+\
+		for (old = idx; old < map->capacity; old += new_capacity) {\
+			*tail = map->buckets[old];\
+			while (*tail != NULL) {\
+				tail = &(*tail)->next;\
+			}\
+		}\
+\
+		map->buckets_filled += new_buckets[idx] != NULL;\
+	}\
+\
+	HASHMAP_FREE((void *)map->buckets);\
+	map->buckets = new_buckets;\
+	map->capacity = new_capacity;\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+void Functions_Prefix_##_shrink_to_fit(struct Struct_Name_ *map)\
+{\
+	size_t new_capacity = HASHMAP_DEFAULT_CAPACITY;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_shrink_to_fit but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		return;\
+	}\
+\
+	/* Shrinking concatenates chains of the new array only */\
+	Functions_Prefix_##_rehash_step(map, map->old_capacity);\
+\
+	/* Smallest power of 2 holding size within the load factor */\
+	while (new_capacity < map->capacity &&\
+	       (float)map->size / (float)new_capacity > map->max_load_factor) {\
+		new_capacity *= 2;\
+	}\
+\
+	if (new_capacity < map->capacity) {\
+		Functions_Prefix_##_shrink(map, new_capacity);\
+	}\
+}\
+\
+/* Make room for one more element before inserting it: initialize, then\
+ * either migrate old buckets or grow above the load factor. */\
+void Functions_Prefix_##_make_room(struct Struct_Name_ *map)\
+{\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	if (map->old_buckets != NULL) {\
+		Functions_Prefix_##_rehash_step(map, HASHMAP_INCREMENTAL_REHASH);\
+	} else if ((float)map->size / (float)map->capacity >\
+		   map->max_load_factor) {\
+		/* Above load factor */\
+		Functions_Prefix_##_grow(map);\
+	}\
+}\
+\
+/* Return the node of key, inserting one holding value if there is none. Map\
+ * must not be NULL. */\
+struct Struct_Name_##ListNode *Functions_Prefix_##_entry(struct Struct_Name_ *RESTRICT map,\
+				      Custom_Key_Type_ key, unsigned long hash,\
+				      Custom_Value_Type_ value,\
+				      int *RESTRICT inserted)\
+{\
+	struct Struct_Name_##ListNode **bucket = NULL;\
+	struct Struct_Name_##ListNode *node = NULL;\
+\
+	Functions_Prefix_##_make_room(map);\
+\
+	bucket = Functions_Prefix_##_bucket(map, hash);\
+\
+	if (*bucket == NULL) {\
+		*bucket = Functions_Prefix_##_list_new(map, NULL, key, hash, value);\
+		map->buckets_filled++;\
+		map->size++;\
+		*inserted = 1;\
+		return *bucket;\
+	}\
+\
+	node = Functions_Prefix_##_list_insert(map, *bucket, key, hash, value, inserted);\
+	if (*inserted) {\
+		map->size++;\
+	}\
+\
+	return node;\
+}\
+\
+int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+	}\
+\
+	/* The seed is picked by Functions_Prefix_##_init(), before hashing */\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	return Functions_Prefix_##_insert_hashed(map, key, Functions_Prefix_##_hash(map, key), value);\
+}\
+\
+int Functions_Prefix_##_insert_hashed(struct Struct_Name_ *map, Custom_Key_Type_ key,\
+			  unsigned long hash, Custom_Value_Type_ value)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+	int inserted = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert_hashed but non-null argument expected.");\
+	}\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	/* Debug test for a hash from another function */\
+	assert(hash == Functions_Prefix_##_hash(map, key));\
+\
+	node = Functions_Prefix_##_entry(map, key, hash, value, &inserted);\
+	if (!inserted) {\
+		/* Override existing value */\
+		node->value = value;\
+	}\
+\
+	return !inserted;\
+}\
+\
+void Functions_Prefix_##_insert_unique(struct Struct_Name_ *map, Custom_Key_Type_ key,\
+			   Custom_Value_Type_ value)\
+{\
+	struct Struct_Name_##ListNode **bucket = NULL;\
+	unsigned long hash = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert_unique but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_make_room(map);\
+\
+	hash = Functions_Prefix_##_hash(map, key);\
+	bucket = Functions_Prefix_##_bucket(map, hash);\
+\
+	/* Debug test for duplicate keys */\
+	assert(Functions_Prefix_##_list_find(*bucket, key, hash) == NULL);\
+\
+	/* Push to head of list */\
+	map->buckets_filled += *bucket == NULL;\
+	*bucket = Functions_Prefix_##_list_new(map, *bucket, key, hash, value);\
+	map->size++;\
+}\
+\
+void Functions_Prefix_##_build_from_arrays(struct Struct_Name_ *RESTRICT map,\
+			       Custom_Key_Type_ const *RESTRICT keys,\
+			       Custom_Value_Type_ const *RESTRICT values, size_t count)\
+{\
+	struct Struct_Name_##ListNode **bucket = NULL;\
+	struct Struct_Name_##ListNode *node = NULL;\
+	unsigned long *hashes = NULL;\
+	size_t *order = NULL;\
+	size_t *offsets = NULL;\
+	size_t idx = 0;\
+	size_t key = 0;\
+	int inserted = 0;\
+\
+	if (map == NULL || ((keys == NULL || values == NULL) && count > 0)) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_build_from_arrays but non-null argument expected.");\
+	}\
+\
+	if (count > ((size_t)-1) - map->size) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	/* Size once, this also initializes and ends any migration */\
+	Functions_Prefix_##_reserve(map, map->size + count);\
+\
+	if (count == 0) {\
+		return;\
+	}\
+\
+	if (count > ((size_t)-1) / sizeof(unsigned long) ||\
+	    map->capacity >= ((size_t)-1) / sizeof(size_t)) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	hashes = (unsigned long *)HASHMAP_REALLOC(\
+		NULL, count * sizeof(unsigned long));\
+	order = (size_t *)HASHMAP_REALLOC(NULL, count * sizeof(size_t));\
+	offsets = (size_t *)HASHMAP_REALLOC(\
+		NULL, (map->capacity + 1) * sizeof(size_t));\
+	if (hashes == NULL || order == NULL || offsets == NULL) {\
+		HASHMAP_FREE((void *)hashes);\
+		HASHMAP_FREE((void *)order);\
+		HASHMAP_FREE((void *)offsets);\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+	memset((void *)offsets, 0, (map->capacity + 1) * sizeof(size_t));\
+\
+	/* Counting sort of the keys by bucket, stable to keep the last\
+	 * duplicate winning */\
+	for (idx = 0; idx < count; idx++) {\
+		hashes[idx] = Functions_Prefix_##_hash(map, keys[idx]);\
+		offsets[(hashes[idx] & (map->capacity - 1)) + 1]++;\
+	}\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		offsets[idx + 1] += offsets[idx];\
+	}\
+	for (idx = 0; idx < count; idx++) {\
+		order[offsets[hashes[idx] & (map->capacity - 1)]++] = idx;\
+	}\
+\
+	/* Nodes are allocated bucket after bucket, so each chain is carved\
+	 * contiguously from slabs with HASHMAP_SLAB_SIZE */\
+	for (idx = 0; idx < count; idx++) {\
+		key = order[idx];\
+		bucket = &map->buckets[hashes[key] & (map->capacity - 1)];\
+\
+		if (*bucket == NULL) {\
+			*bucket = Functions_Prefix_##_list_new(map, NULL, keys[key],\
+						   hashes[key], values[key]);\
+			map->buckets_filled++;\
+			map->size++;\
+			continue;\
+		}\
+\
+		node = Functions_Prefix_##_list_insert(map, *bucket, keys[key],\
+					   hashes[key], values[key],\
+					   &inserted);\
+		if (inserted) {\
+			map->size++;\
+		} else {\
+			node->value = values[key];\
+		}\
+	}\
+\
+	HASHMAP_FREE((void *)hashes);\
+	HASHMAP_FREE((void *)order);\
+	HASHMAP_FREE((void *)offsets);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+Custom_Value_Type_ *Functions_Prefix_##_get_or_insert(struct Struct_Name_ *map, Custom_Key_Type_ key,\
+				   Custom_Value_Type_ default_value, int *inserted)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+	int added = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return NULL;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get_or_insert but non-null argument expected.");\
+	}\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	node = Functions_Prefix_##_entry(map, key, Functions_Prefix_##_hash(map, key), default_value,\
+			     &added);\
+	if (inserted != NULL) {\
+		*inserted = added;\
+	}\
+\
+	return &node->value;\
+}\
+\
+int Functions_Prefix_##_upsert(struct Struct_Name_ *map, Custom_Key_Type_ key,\
+		   void (*callback)(Custom_Key_Type_ key, Custom_Value_Type_ *value,\
+				    int existed, void *context),\
+		   void *context)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+	Custom_Value_Type_ zero;\
+	int inserted = 0;\
+\
+	if (map == NULL || callback == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_upsert but non-null argument expected.");\
+	}\
+\
+	memset((void *)&zero, 0, sizeof(Custom_Value_Type_));\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	node = Functions_Prefix_##_entry(map, key, Functions_Prefix_##_hash(map, key), zero, &inserted);\
+	callback(node->key, &node->value, !inserted, context);\
+\
+	return !inserted;\
+}\
+\
+int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_remove but non-null argument expected.");\
+	}\
+\
+	return Functions_Prefix_##_remove_hashed(map, key, Functions_Prefix_##_hash(map, key), out);\
+}\
+\
+int Functions_Prefix_##_remove_hashed(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+			  unsigned long hash, Custom_Value_Type_ *RESTRICT out)\
+{\
+	struct Struct_Name_##ListNode **bucket = NULL;\
+	size_t new_capacity = 0;\
+	int found = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_remove_hashed but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	/* Debug test for a hash from another function */\
+	assert(hash == Functions_Prefix_##_hash(map, key));\
+\
+	if (map->buckets == NULL) {\
+		return 0;\
+	}\
+\
+	Functions_Prefix_##_rehash_step(map, HASHMAP_INCREMENTAL_REHASH);\
+\
+	bucket = Functions_Prefix_##_bucket(map, hash);\
+\
+	found = Functions_Prefix_##_list_remove(map, bucket, key, hash, out);\
+\
+	if (!found) {\
+		return 0;\
+	}\
+\
+	if (*bucket == NULL) {\
+		assert(map->buckets_filled > 0);\
+		map->buckets_filled--;\
+	}\
+	assert(map->size > 0);\
+	map->size--;\
+\
+	/* Below load factor, unless migrating */\
+	if (map->old_buckets == NULL &&\
+	    map->capacity > HASHMAP_DEFAULT_CAPACITY &&\
+	    (float)map->size / (float)map->capacity < map->min_load_factor) {\
+		new_capacity = map->capacity / map->growth_factor;\
+		if (new_capacity < HASHMAP_DEFAULT_CAPACITY) {\
+			new_capacity = HASHMAP_DEFAULT_CAPACITY;\
+		}\
+		Functions_Prefix_##_shrink(map, new_capacity);\
+	}\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get but non-null argument expected.");\
+	}\
+\
+	return Functions_Prefix_##_get_hashed(map, key, Functions_Prefix_##_hash(map, key), out);\
+}\
+\
+int Functions_Prefix_##_get_hashed(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		       unsigned long hash, Custom_Value_Type_ *RESTRICT out)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get_hashed but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	/* Debug test for a hash from another function */\
+	assert(hash == Functions_Prefix_##_hash(map, key));\
+\
+	if (map->buckets == NULL) {\
+		return 0;\
+	}\
+\
+	node = Functions_Prefix_##_list_find(*Functions_Prefix_##_bucket(map, hash), key, hash);\
+\
+	if (node == NULL) {\
+		return 0;\
+	}\
+\
+	if (out != NULL) {\
+		*out = node->value;\
+	}\
+\
+	return 1;\
+}\
+\
+size_t Functions_Prefix_##_get_many(const struct Struct_Name_ *RESTRICT map,\
+			Custom_Key_Type_ const *RESTRICT keys, size_t count,\
+			Custom_Value_Type_ *RESTRICT out_values,\
+			int *RESTRICT out_found)\
+{\
+	struct Struct_Name_##ListNode **buckets[HASHMAP_PREFETCH_BATCH];\
+	struct Struct_Name_##ListNode *heads[HASHMAP_PREFETCH_BATCH];\
+	unsigned long hashes[HASHMAP_PREFETCH_BATCH];\
+	struct Struct_Name_##ListNode *node = NULL;\
+	size_t found = 0;\
+	size_t batch = 0;\
+	size_t base = 0;\
+	size_t idx = 0;\
+\
+	if (map == NULL || (keys == NULL && count > 0)) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return 0;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get_many but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		if (out_found != NULL && count > 0) {\
+			memset((void *)out_found, 0, count * sizeof(int));\
+		}\
+		return 0;\
+	}\
+\
+	for (base = 0; base < count; base += batch) {\
+		batch = count - base;\
+		if (batch > HASHMAP_PREFETCH_BATCH) {\
+			batch = HASHMAP_PREFETCH_BATCH;\
+		}\
+\
+		/* Hash the whole batch, loading every bucket at once */\
+		for (idx = 0; idx < batch; idx++) {\
+			hashes[idx] = Functions_Prefix_##_hash(map, keys[base + idx]);\
+			buckets[idx] = Functions_Prefix_##_bucket(map, hashes[idx]);\
+			HASHMAP_PREFETCH(buckets[idx]);\
+		}\
+\
+		/* Then every first node */\
+		for (idx = 0; idx < batch; idx++) {\
+			heads[idx] = *buckets[idx];\
+			if (heads[idx] != NULL) {\
+				HASHMAP_PREFETCH(heads[idx]);\
+			}\
+		}\
+\
+		for (idx = 0; idx < batch; idx++) {\
+			node = Functions_Prefix_##_list_find(heads[idx], keys[base + idx],\
+						 hashes[idx]);\
+			if (node != NULL) {\
+				if (out_values != NULL) {\
+					out_values[base + idx] = node->value;\
+				}\
+				found++;\
+			}\
+			if (out_found != NULL) {\
+				out_found[base + idx] = node != NULL;\
+			}\
+		}\
+	}\
+\
+	return found;\
+}\
+\
+Custom_Value_Type_ *Functions_Prefix_##_get_ptr(struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+	unsigned long hash = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return NULL;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get_ptr but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		return NULL;\
+	}\
+\
+	hash = Functions_Prefix_##_hash(map, key);\
+	node = Functions_Prefix_##_list_find(*Functions_Prefix_##_bucket(map, hash), key, hash);\
+\
+	return node != NULL ? &node->value : NULL;\
+}\
+\
+int Functions_Prefix_##_has(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_get(map, key, NULL);\
+}\
+\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map)\
+{\
+	return map->size;\
+}\
+\
+void Functions_Prefix_##_free(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_free but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	Functions_Prefix_##_nodes_free(map);\
+\
+	HASHMAP_FREE((void *)map->buckets);\
+	HASHMAP_FREE((void *)map->old_buckets);\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
+{\
+	size_t idx = 0;\
+	int callback_response = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iterate but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->iteration_callback == NULL) {\
+		return;\
+	}\
+\
+	for (idx = map->rehash_idx; idx < map->old_capacity; idx++) {\
+		callback_response =\
+			Functions_Prefix_##_list_iterate(map->old_buckets[idx],\
+					     map->iteration_callback, context);\
+		if (callback_response == 0) {\
+			return;\
+		}\
+	}\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		callback_response = Functions_Prefix_##_list_iterate(\
+			map->buckets[idx], map->iteration_callback, context);\
+		if (callback_response == 0) {\
+			break;\
+		}\
+	}\
+}\
+\
+void Functions_Prefix_##_iter_begin(struct Struct_Name_ *RESTRICT map,\
+			struct Struct_Name_##Iter *RESTRICT iter)\
+{\
+	if (map == NULL || iter == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iter_begin but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	iter->map = map;\
+	iter->link = NULL;\
+	iter->bucket = map->rehash_idx;\
+	iter->in_old = map->old_buckets != NULL;\
+	iter->removed = 0;\
+}\
+\
+int Functions_Prefix_##_iter_next(struct Struct_Name_##Iter *RESTRICT iter,\
+		      Custom_Key_Type_ const **RESTRICT key,\
+		      Custom_Value_Type_ **RESTRICT value)\
+{\
+	struct Struct_Name_##ListNode **buckets = NULL;\
+	struct Struct_Name_ *map = NULL;\
+\
+	if (iter == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return 0;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iter_next but non-null argument expected.");\
+	}\
+\
+	map = iter->map;\
+	Functions_Prefix_##_assert(map);\
+\
+	if (iter->link != NULL) {\
+		if (!iter->removed) {\
+			iter->link = &(*iter->link)->next;\
+		}\
+		iter->removed = 0;\
+\
+		if (*iter->link == NULL) {\
+			/* End of chain */\
+			iter->link = NULL;\
+			iter->bucket++;\
+		}\
+	}\
+\
+	/* Old buckets not migrated yet, then the new ones */\
+	for (; iter->link == NULL; iter->bucket++) {\
+		if (iter->in_old && iter->bucket >= map->old_capacity) {\
+			iter->in_old = 0;\
+			iter->bucket = 0;\
+		}\
+		if (!iter->in_old && iter->bucket >= map->capacity) {\
+			return 0;\
+		}\
+\
+		buckets = iter->in_old ? map->old_buckets : map->buckets;\
+		if (buckets[iter->bucket] != NULL) {\
+			iter->link = &buckets[iter->bucket];\
+			break;\
+		}\
+	}\
+\
+	if (key != NULL) {\
+		*key = &(*iter->link)->key;\
+	}\
+	if (value != NULL) {\
+		*value = &(*iter->link)->value;\
+	}\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_iter_remove(struct Struct_Name_##Iter *iter)\
+{\
+	struct Struct_Name_##ListNode *node = NULL;\
+	struct Struct_Name_ *map = NULL;\
+\
+	if (iter == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return 0;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iter_remove but non-null argument expected.");\
+	}\
+\
+	map = iter->map;\
+	Functions_Prefix_##_assert(map);\
+\
+	if (iter->link == NULL || iter->removed) {\
+		return 0;\
+	}\
+\
+	/* Unlink in place: no rehash step nor shrink, which would move the\
+	 * nodes under the iterator */\
+	node = *iter->link;\
+	*iter->link = node->next;\
+	Functions_Prefix_##_node_free(map, node);\
+\
+	if ((iter->in_old ? map->old_buckets : map->buckets)[iter->bucket] ==\
+	    NULL) {\
+		assert(map->buckets_filled > 0);\
+		map->buckets_filled--;\
+	}\
+	assert(map->size > 0);\
+	map->size--;\
+	iter->removed = 1;\
+\
+	return 1;\
+}\
+\
+void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
+		       struct Struct_Name_ *RESTRICT src)\
+{\
+	size_t idx = 0;\
+\
+	if (dest == NULL || src == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+	}\
+	Functions_Prefix_##_assert(src);\
+\
+	if (src->capacity == 0) {\
+		memset(dest, 0, sizeof(struct Struct_Name_));\
+		return;\
+	}\
+\
+	dest->buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
+		NULL, src->capacity * sizeof(struct Struct_Name_##ListNode *));\
+\
+	if (dest->buckets == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	dest->capacity = src->capacity;\
+	dest->size = src->size;\
+	dest->buckets_filled = src->buckets_filled;\
+	dest->max_load_factor = src->max_load_factor;\
+	dest->min_load_factor = src->min_load_factor;\
+	dest->growth_factor = src->growth_factor;\
+	dest->seed = src->seed;\
+	dest->iteration_callback = src->iteration_callback;\
+\
+	memset((void *)dest->buckets, 0,\
+	       dest->capacity * sizeof(struct Struct_Name_##ListNode *));\
+\
+	dest->slabs = NULL;\
+	dest->free_nodes = NULL;\
+\
+	for (idx = 0; idx < dest->capacity; idx++) {\
+		dest->buckets[idx] =\
+			Functions_Prefix_##_list_duplicate(dest, src->buckets[idx]);\
+	}\
+\
+	dest->old_buckets = NULL;\
+	dest->old_capacity = 0;\
+	dest->rehash_idx = 0;\
+\
+	if (src->old_buckets != NULL) {\
+		dest->old_buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
+			NULL,\
+			src->old_capacity * sizeof(struct Struct_Name_##ListNode *));\
+\
+		if (dest->old_buckets == NULL) {\
+			Functions_Prefix_##_panic("Out of memory. Panic.");\
+		}\
+\
+		dest->old_capacity = src->old_capacity;\
+		dest->rehash_idx = src->rehash_idx;\
+\
+		for (idx = 0; idx < dest->old_capacity; idx++) {\
+			dest->old_buckets[idx] = Functions_Prefix_##_list_duplicate(\
+				dest, src->old_buckets[idx]);\
+		}\
+	}\
+\
+	Functions_Prefix_##_assert(dest);\
+}\
+\
+void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	Functions_Prefix_##_nodes_free(map);\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		map->buckets[idx] = NULL;\
+	}\
+\
+	HASHMAP_FREE((void *)map->old_buckets);\
+	map->old_buckets = NULL;\
+	map->old_capacity = 0;\
+	map->rehash_idx = 0;\
+\
+	map->size = 0;\
+	map->buckets_filled = 0;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	const unsigned char *bend = bptr + len;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; bptr < bend; bptr++) {\
+		hval ^= (unsigned long)bptr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str)\
+{\
+	const unsigned char *ustr = (const unsigned char *)str;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; ustr[0] != '\0'; ustr++) {\
+		hval ^= (unsigned long)ustr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded(buf, len, 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str(const char *str)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	unsigned long hash = seed;\
+	unsigned long word = 0;\
+	size_t left = len;\
+\
+	/* A whole word per multiply, instead of a byte */\
+	for (; left >= HASHMAP_HASH_WORD_SIZE;\
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {\
+		/* The seed also goes into each word, so that colliding\
+		 * words cannot be chosen without knowing it */\
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);\
+		hash = HASHMAP_HASH_STEP(hash);\
+	}\
+\
+	/* Remaining bytes, as the low bytes of a word */\
+	if (left > 0) {\
+		while (left > 0) {\
+			left--;\
+			word = (word << 8) | (unsigned long)bptr[left];\
+		}\
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);\
+	}\
+\
+	hash ^= (unsigned long)len;\
+	HASHMAP_HASH_FMIX(hash);\
+\
+	return hash;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), seed);\
+}
+
+#define HASHMAP_DECLARE_ROBINHOOD(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+\
+struct Struct_Name_##Slot {\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+	/* Distance from the home slot plus one, 0 if the slot is empty */\
+	unsigned int psl;\
+};\
+\
+typedef struct Struct_Name_ {\
+	struct Struct_Name_##Slot *slots;\
+	int (*iteration_callback)(Custom_Key_Type_ key, Custom_Value_Type_ value,\
+				  void *context);\
+	size_t size;\
+	size_t capacity;\
+	/* Mixed into default hashes, picked by Functions_Prefix_##_init() */\
+	unsigned long seed;\
+} Struct_Name_;\
+\
+/* API functions */\
+void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_grow(Struct_Name_ *map);\
+int Functions_Prefix_##_insert(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_remove(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_get(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_has(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map);\
+void Functions_Prefix_##_free(Struct_Name_ *map);\
+void Functions_Prefix_##_iterate(Struct_Name_ *map, void *context);\
+void Functions_Prefix_##_duplicate(Struct_Name_ *RESTRICT dest, Struct_Name_ *RESTRICT src);\
+void Functions_Prefix_##_clear(Struct_Name_ *map);\
+\
+/* Internal functions */\
+void Functions_Prefix_##_assert(const Struct_Name_ *map);\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_);\
+int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2);\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_);\
+unsigned long Functions_Prefix_##_hash(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_hash_index(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_find(const Struct_Name_ *map, Custom_Key_Type_ key);\
+void Functions_Prefix_##_place(Struct_Name_ *map, size_t idx, struct Struct_Name_##Slot entry);\
+struct Struct_Name_##Slot *Functions_Prefix_##_alloc_slots(size_t capacity);\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_hash_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed);\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed);
+#define HASHMAP_DEFINE_ROBINHOOD(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+struct Struct_Name_;\
+struct Struct_Name_##Slot;\
+HASHMAP_DEFINE_PANIC(Functions_Prefix_)\
+\
+void Functions_Prefix_##_assert(const struct Struct_Name_ *map)\
+{\
+	/* If slots is NULL, map should be in initial/freed state */\
+	if (map->slots == NULL) {\
+		assert(map->size == 0);\
+		assert(map->capacity == 0);\
+		return;\
+	}\
+\
+	/* Capacity must be a power of 2 and non-zero */\
+	assert(map->capacity > 0);\
+	assert((map->capacity & (map->capacity - 1)) == 0);\
+\
+	/* At least one slot is always empty, which ends every probe */\
+	assert(map->size < map->capacity);\
+}\
+\
+struct Struct_Name_##Slot *Functions_Prefix_##_alloc_slots(size_t capacity)\
+{\
+	struct Struct_Name_##Slot *slots = (struct Struct_Name_##Slot *)HASHMAP_REALLOC(\
+		NULL, capacity * sizeof(struct Struct_Name_##Slot));\
+	if (slots == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	memset((void *)slots, 0, capacity * sizeof(struct Struct_Name_##Slot));\
+\
+	return slots;\
+}\
+\
+void Functions_Prefix_##_init(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_init but non-null argument expected.");\
+	}\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+\
+	map->slots = Functions_Prefix_##_alloc_slots(HASHMAP_DEFAULT_CAPACITY);\
+	map->capacity = HASHMAP_DEFAULT_CAPACITY;\
+\
+	/* Spread the raw entropy over every bit */\
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));\
+	HASHMAP_HASH_FMIX(map->seed);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_)\
+{\
+	return Custom_Comparison_Func_;\
+}\
+\
+HASHMAP_INLINE int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
+{\
+	int (*const callback)(Custom_Key_Type_, Custom_Key_Type_) = Custom_Comparison_Func_;\
+\
+	if (callback == NULL) {\
+		return memcmp((void *)&key1, (void *)&key2, sizeof(Custom_Key_Type_));\
+	}\
+	return callback(key1, key2);\
+}\
+\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_)\
+{\
+	return Custom_Hash_Func_;\
+}\
+\
+HASHMAP_INLINE unsigned long Functions_Prefix_##_hash(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	unsigned long (*const callback)(Custom_Key_Type_) = Custom_Hash_Func_;\
+\
+	if (callback == NULL) {\
+		return Functions_Prefix_##_hash_buf_seeded((const void *)&key,\
+					       sizeof(Custom_Key_Type_), map->seed);\
+	}\
+	return callback(key);\
+}\
+\
+HASHMAP_INLINE size_t Functions_Prefix_##_hash_index(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_hash(map, key) & (map->capacity - 1);\
+}\
+\
+/* Return the slot index holding key, or map->capacity if it is absent */\
+size_t Functions_Prefix_##_find(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	const struct Struct_Name_##Slot *slot = NULL;\
+	size_t idx = Functions_Prefix_##_hash_index(map, key);\
+	unsigned int psl = 1;\
+\
+	for (;; idx = (idx + 1) & (map->capacity - 1), psl++) {\
+		slot = &map->slots[idx];\
+\
+		/* Key would have displaced this entry, it cannot be further */\
+		if (slot->psl < psl) {\
+			return map->capacity;\
+		}\
+\
+		if (slot->psl == psl &&\
+		    Functions_Prefix_##_compare_keys(slot->key, key) == 0) {\
+			return idx;\
+		}\
+	}\
+}\
+\
+/* Place an entry known to be absent, starting the probe at idx */\
+void Functions_Prefix_##_place(struct Struct_Name_ *map, size_t idx, struct Struct_Name_##Slot entry)\
+{\
+	struct Struct_Name_##Slot *slot = NULL;\
+	struct Struct_Name_##Slot displaced;\
+\
+	for (;; idx = (idx + 1) & (map->capacity - 1), entry.psl++) {\
+		if (entry.psl == (unsigned int)-1) {\
+			Functions_Prefix_##_panic("Probe sequence too long. Panic.");\
+		}\
+\
+		slot = &map->slots[idx];\
+\
+		if (slot->psl == 0) {\
+			*slot = entry;\
+			return;\
+		}\
+\
+		/* Take from the rich: the resident is closer to its home */\
+		if (slot->psl < entry.psl) {\
+			displaced = *slot;\
+			*slot = entry;\
+			entry = displaced;\
+		}\
+	}\
+}\
+\
+void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
+{\
+	size_t new_capacity = 0;\
+	size_t idx = 0;\
+	struct Struct_Name_ new_map = { 0 };\
+	struct Struct_Name_##Slot entry;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_grow but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	/* Calculate the next power of 2 */\
+	new_capacity = map->capacity;\
+	new_capacity |= new_capacity >> 1;\
+	new_capacity |= new_capacity >> 2;\
+	new_capacity |= new_capacity >> 4;\
+	new_capacity |= new_capacity >> 8;\
+	if (sizeof(size_t) >= 4) {\
+		new_capacity |= new_capacity >> 16;\
+	}\
+	if (sizeof(size_t) >= 8) {\
+		new_capacity |= new_capacity >> 32;\
+	}\
+	new_capacity++;\
+\
+	if (new_capacity < map->capacity) {\
+		/* Overflow, do not grow */\
+		return;\
+	}\
+	if (new_capacity > ((size_t)-1) / sizeof(struct Struct_Name_##Slot)) {\
+		/* Would overflow, do not grow */\
+		return;\
+	}\
+\
+	new_map.slots = Functions_Prefix_##_alloc_slots(new_capacity);\
+	new_map.capacity = new_capacity;\
+	new_map.size = map->size;\
+	new_map.iteration_callback = map->iteration_callback;\
+	new_map.seed = map->seed;\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		if (map->slots[idx].psl == 0) {\
+			continue;\
+		}\
+\
+		entry = map->slots[idx];\
+		entry.psl = 1;\
+		Functions_Prefix_##_place(&new_map, Functions_Prefix_##_hash_index(&new_map, entry.key),\
+			      entry);\
+	}\
+\
+	HASHMAP_FREE((void *)map->slots);\
+	*map = new_map;\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	struct Struct_Name_##Slot *slot = NULL;\
+	struct Struct_Name_##Slot entry;\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	/* Check for being above load factor */\
+	if ((float)(map->size + 1) / (float)map->capacity >\
+	    HASHMAP_ROBINHOOD_LOAD_FACTOR) {\
+		Functions_Prefix_##_grow(map);\
+	}\
+\
+	entry.key = key;\
+	entry.value = value;\
+	entry.psl = 1;\
+	idx = Functions_Prefix_##_hash_index(map, key);\
+\
+	/* Look for the key until the probe reaches a richer slot, which is\
+	 * where the key would have been placed */\
+	for (;; idx = (idx + 1) & (map->capacity - 1), entry.psl++) {\
+		slot = &map->slots[idx];\
+\
+		if (slot->psl < entry.psl) {\
+			break;\
+		}\
+\
+		if (slot->psl == entry.psl &&\
+		    Functions_Prefix_##_compare_keys(slot->key, key) == 0) {\
+			/* Override existing value */\
+			slot->value = value;\
+			return 1;\
+		}\
+	}\
+\
+	assert(map->size + 1 < map->capacity);\
+\
+	Functions_Prefix_##_place(map, idx, entry);\
+	map->size++;\
+\
+	return 0;\
+}\
+\
+int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t idx = 0;\
+	size_t next = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_remove but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		return 0;\
+	}\
+\
+	idx = Functions_Prefix_##_find(map, key);\
+	if (idx == map->capacity) {\
+		return 0;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
+\
+	/* Backward shift deletion: pull the following displaced entries one\
+	 * slot closer to their home instead of leaving a tombstone */\
+	for (next = (idx + 1) & (map->capacity - 1); map->slots[next].psl > 1;\
+	     idx = next, next = (next + 1) & (map->capacity - 1)) {\
+		map->slots[idx] = map->slots[next];\
+		map->slots[idx].psl--;\
+	}\
+\
+	map->slots[idx].psl = 0;\
+\
+	assert(map->size > 0);\
+	map->size--;\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		return 0;\
+	}\
+\
+	idx = Functions_Prefix_##_find(map, key);\
+	if (idx == map->capacity) {\
+		return 0;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_has(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_get(map, key, NULL);\
+}\
+\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map)\
+{\
+	return map->size;\
+}\
+\
+void Functions_Prefix_##_free(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_free but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	HASHMAP_FREE((void *)map->slots);\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iterate but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->iteration_callback == NULL) {\
+		return;\
+	}\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		if (map->slots[idx].psl == 0) {\
+			continue;\
+		}\
+\
+		if (map->iteration_callback(map->slots[idx].key,\
+					    map->slots[idx].value,\
+					    context) == 0) {\
+			break;\
+		}\
+	}\
+}\
+\
+void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
+		       struct Struct_Name_ *RESTRICT src)\
+{\
+	if (dest == NULL || src == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_duplicate but non-null argument expected.");\
+	}\
+	Functions_Prefix_##_assert(src);\
+\
+	if (src->capacity == 0) {\
+		memset(dest, 0, sizeof(struct Struct_Name_));\
+		return;\
+	}\
+\
+	dest->slots = Functions_Prefix_##_alloc_slots(src->capacity);\
+	dest->capacity = src->capacity;\
+	dest->size = src->size;\
+	dest->iteration_callback = src->iteration_callback;\
+	dest->seed = src->seed;\
+\
+	memcpy((void *)dest->slots, (const void *)src->slots,\
+	       src->capacity * sizeof(struct Struct_Name_##Slot));\
+\
+	Functions_Prefix_##_assert(dest);\
+}\
+\
+void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots != NULL) {\
+		memset((void *)map->slots, 0,\
+		       map->capacity * sizeof(struct Struct_Name_##Slot));\
+	}\
+\
+	map->size = 0;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	const unsigned char *bend = bptr + len;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; bptr < bend; bptr++) {\
+		hval ^= (unsigned long)bptr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str)\
+{\
+	const unsigned char *ustr = (const unsigned char *)str;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; ustr[0] != '\0'; ustr++) {\
+		hval ^= (unsigned long)ustr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded(buf, len, 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str(const char *str)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	unsigned long hash = seed;\
+	unsigned long word = 0;\
+	size_t left = len;\
+\
+	/* A whole word per multiply, instead of a byte */\
+	for (; left >= HASHMAP_HASH_WORD_SIZE;\
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {\
+		/* The seed also goes into each word, so that colliding\
+		 * words cannot be chosen without knowing it */\
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);\
+		hash = HASHMAP_HASH_STEP(hash);\
+	}\
+\
+	/* Remaining bytes, as the low bytes of a word */\
+	if (left > 0) {\
+		while (left > 0) {\
+			left--;\
+			word = (word << 8) | (unsigned long)bptr[left];\
+		}\
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);\
+	}\
+\
+	hash ^= (unsigned long)len;\
+	HASHMAP_HASH_FMIX(hash);\
+\
+	return hash;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), seed);\
+}
+
+#define HASHMAP_DECLARE_SWISS(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+\
+struct Struct_Name_##Slot {\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+};\
+\
+typedef struct Struct_Name_ {\
+	/* Single allocation: capacity slots followed by capacity control bytes */\
+	struct Struct_Name_##Slot *slots;\
+	unsigned char *ctrl;\
+	int (*iteration_callback)(Custom_Key_Type_ key, Custom_Value_Type_ value,\
+				  void *context);\
+	size_t size;\
+	size_t capacity;\
+	size_t deleted;\
+	/* Mixed into default hashes, picked by Functions_Prefix_##_init() */\
+	unsigned long seed;\
+} Struct_Name_;\
+\
+/* API functions */\
+void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_grow(Struct_Name_ *map);\
+int Functions_Prefix_##_insert(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_remove(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_get(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_has(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map);\
+void Functions_Prefix_##_free(Struct_Name_ *map);\
+void Functions_Prefix_##_iterate(Struct_Name_ *map, void *context);\
+void Functions_Prefix_##_duplicate(Struct_Name_ *RESTRICT dest, Struct_Name_ *RESTRICT src);\
+void Functions_Prefix_##_clear(Struct_Name_ *map);\
+\
+/* Internal functions */\
+void Functions_Prefix_##_assert(const Struct_Name_ *map);\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_);\
+int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2);\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_);\
+unsigned long Functions_Prefix_##_hash(const Struct_Name_ *map, Custom_Key_Type_ key);\
+unsigned long Functions_Prefix_##_group_word(const unsigned char *bytes);\
+unsigned int Functions_Prefix_##_word_mask(unsigned long high_bits, size_t offset);\
+unsigned int Functions_Prefix_##_group_match(const unsigned char *group,\
+				 unsigned int byte);\
+unsigned int Functions_Prefix_##_group_match_free(const unsigned char *group);\
+size_t Functions_Prefix_##_find(const Struct_Name_ *map, Custom_Key_Type_ key, unsigned long hash);\
+size_t Functions_Prefix_##_find_free(const Struct_Name_ *map, unsigned long hash);\
+void Functions_Prefix_##_alloc(Struct_Name_ *map, size_t capacity);\
+void Functions_Prefix_##_rehash(Struct_Name_ *map, size_t new_capacity);\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_hash_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed);\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed);
+#define HASHMAP_DEFINE_SWISS(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+struct Struct_Name_;\
+struct Struct_Name_##Slot;\
+HASHMAP_DEFINE_PANIC(Functions_Prefix_)\
+\
+void Functions_Prefix_##_assert(const struct Struct_Name_ *map)\
+{\
+	/* If slots is NULL, map should be in initial/freed state */\
+	if (map->slots == NULL) {\
+		assert(map->ctrl == NULL);\
+		assert(map->size == 0);\
+		assert(map->deleted == 0);\
+		assert(map->capacity == 0);\
+		return;\
+	}\
+\
+	/* Capacity must be a power of 2 holding whole groups */\
+	assert(map->capacity >= HASHMAP_SWISS_GROUP_SIZE);\
+	assert((map->capacity & (map->capacity - 1)) == 0);\
+	assert(map->ctrl == (unsigned char *)(map->slots + map->capacity));\
+\
+	/* Empty slots must remain so that every probe terminates */\
+	assert(map->size + map->deleted < map->capacity);\
+}\
+\
+/* Allocate an empty table, leaving size and tombstone counts untouched */\
+void Functions_Prefix_##_alloc(struct Struct_Name_ *map, size_t capacity)\
+{\
+	map->slots = (struct Struct_Name_##Slot *)HASHMAP_REALLOC(\
+		NULL, capacity * (sizeof(struct Struct_Name_##Slot) + 1));\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	map->ctrl = (unsigned char *)(map->slots + capacity);\
+	map->capacity = capacity;\
+\
+	memset((void *)map->ctrl, HASHMAP_SWISS_EMPTY, capacity);\
+}\
+\
+void Functions_Prefix_##_init(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_init but non-null argument expected.");\
+	}\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+\
+	if (HASHMAP_DEFAULT_CAPACITY > HASHMAP_SWISS_GROUP_SIZE) {\
+		Functions_Prefix_##_alloc(map, HASHMAP_DEFAULT_CAPACITY);\
+	} else {\
+		Functions_Prefix_##_alloc(map, HASHMAP_SWISS_GROUP_SIZE);\
+	}\
+\
+	/* Spread the raw entropy over every bit */\
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));\
+	HASHMAP_HASH_FMIX(map->seed);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_)\
+{\
+	return Custom_Comparison_Func_;\
+}\
+\
+HASHMAP_INLINE int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
+{\
+	int (*const callback)(Custom_Key_Type_, Custom_Key_Type_) = Custom_Comparison_Func_;\
+\
+	if (callback == NULL) {\
+		return memcmp((void *)&key1, (void *)&key2, sizeof(Custom_Key_Type_));\
+	}\
+	return callback(key1, key2);\
+}\
+\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_)\
+{\
+	return Custom_Hash_Func_;\
+}\
+\
+HASHMAP_INLINE unsigned long Functions_Prefix_##_hash(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	unsigned long (*const callback)(Custom_Key_Type_) = Custom_Hash_Func_;\
+\
+	if (callback == NULL) {\
+		return Functions_Prefix_##_hash_buf_seeded((const void *)&key,\
+					       sizeof(Custom_Key_Type_), map->seed);\
+	}\
+	return callback(key);\
+}\
+\
+/* Load bytes into a word in an endianness independent order */\
+unsigned long Functions_Prefix_##_group_word(const unsigned char *bytes)\
+{\
+	unsigned long word = 0;\
+	size_t idx = 0;\
+\
+	for (idx = 0; idx < sizeof(unsigned long); idx++) {\
+		word |= (unsigned long)bytes[idx] << (8 * idx);\
+	}\
+\
+	return word;\
+}\
+\
+/* Gather the high bit of each byte of a word into a slot bitmask */\
+unsigned int Functions_Prefix_##_word_mask(unsigned long high_bits, size_t offset)\
+{\
+	unsigned int mask = 0;\
+	size_t idx = 0;\
+\
+	for (idx = 0; idx < sizeof(unsigned long); idx++) {\
+		if ((high_bits >> (8 * idx + 7)) & 1UL) {\
+			mask |= 1U << (offset + idx);\
+		}\
+	}\
+\
+	return mask;\
+}\
+\
+/* Bitmask of the slots of a group whose control byte equals byte */\
+unsigned int Functions_Prefix_##_group_match(const unsigned char *group, unsigned int byte)\
+{\
+	const unsigned long ones = (unsigned long)-1 / 0xFF;\
+	const unsigned long low_bits = ones * 0x7F;\
+	unsigned long word = 0;\
+	unsigned int mask = 0;\
+	size_t idx = 0;\
+\
+	if (HASHMAP_SSE2) {\
+		return HASHMAP_SSE2_MATCH(group, byte);\
+	}\
+\
+	/* SWAR fallback: bytes equal to byte become zero, then exactly the\
+	 * zero bytes get their high bit set */\
+	for (idx = 0; idx < HASHMAP_SWISS_GROUP_SIZE;\
+	     idx += sizeof(unsigned long)) {\
+		word = Functions_Prefix_##_group_word(group + idx) ^ (ones * byte);\
+		word = ~(((word & low_bits) + low_bits) | word | low_bits);\
+		mask |= Functions_Prefix_##_word_mask(word, idx);\
+	}\
+\
+	return mask;\
+}\
+\
+/* Bitmask of the empty or deleted slots of a group (high bit set) */\
+unsigned int Functions_Prefix_##_group_match_free(const unsigned char *group)\
+{\
+	const unsigned long high_bits = (unsigned long)-1 / 0xFF * 0x80;\
+	unsigned int mask = 0;\
+	size_t idx = 0;\
+\
+	if (HASHMAP_SSE2) {\
+		return HASHMAP_SSE2_MATCH_HIGH(group);\
+	}\
+\
+	for (idx = 0; idx < HASHMAP_SWISS_GROUP_SIZE;\
+	     idx += sizeof(unsigned long)) {\
+		mask |= Functions_Prefix_##_word_mask(\
+			Functions_Prefix_##_group_word(group + idx) & high_bits, idx);\
+	}\
+\
+	return mask;\
+}\
+\
+/* Return the slot index holding key, or map->capacity if it is absent */\
+size_t Functions_Prefix_##_find(const struct Struct_Name_ *map, Custom_Key_Type_ key,\
+		    unsigned long hash)\
+{\
+	const size_t group_mask = map->capacity / HASHMAP_SWISS_GROUP_SIZE - 1;\
+	size_t group = (hash >> 7) & group_mask;\
+	size_t step = 0;\
+	size_t base = 0;\
+	unsigned int match = 0;\
+	unsigned int bit = 0;\
+\
+	for (;; step++, group = (group + step) & group_mask) {\
+		base = group * HASHMAP_SWISS_GROUP_SIZE;\
+		match = Functions_Prefix_##_group_match(map->ctrl + base,\
+					    (unsigned int)(hash & 0x7F));\
+\
+		for (bit = 0; match != 0; bit++, match >>= 1) {\
+			if ((match & 1U) != 0 &&\
+			    Functions_Prefix_##_compare_keys(map->slots[base + bit].key,\
+						 key) == 0) {\
+				return base + bit;\
+			}\
+		}\
+\
+		/* An empty slot ends the probe: key would have been there */\
+		if (Functions_Prefix_##_group_match(map->ctrl + base,\
+					HASHMAP_SWISS_EMPTY) != 0) {\
+			return map->capacity;\
+		}\
+\
+		assert(step < map->capacity / HASHMAP_SWISS_GROUP_SIZE);\
+	}\
+}\
+\
+/* Return the first empty or deleted slot on the probe sequence of hash */\
+size_t Functions_Prefix_##_find_free(const struct Struct_Name_ *map, unsigned long hash)\
+{\
+	const size_t group_mask = map->capacity / HASHMAP_SWISS_GROUP_SIZE - 1;\
+	size_t group = (hash >> 7) & group_mask;\
+	size_t step = 0;\
+	size_t base = 0;\
+	unsigned int match = 0;\
+	unsigned int bit = 0;\
+\
+	for (;; step++, group = (group + step) & group_mask) {\
+		base = group * HASHMAP_SWISS_GROUP_SIZE;\
+		match = Functions_Prefix_##_group_match_free(map->ctrl + base);\
+\
+		if (match != 0) {\
+			for (bit = 0; (match & 1U) == 0; bit++, match >>= 1) {\
+			}\
+			return base + bit;\
+		}\
+\
+		assert(step < map->capacity / HASHMAP_SWISS_GROUP_SIZE);\
+	}\
+}\
+\
+/* Move every entry to a fresh table, dropping tombstones */\
+void Functions_Prefix_##_rehash(struct Struct_Name_ *map, size_t new_capacity)\
+{\
+	struct Struct_Name_ new_map = { 0 };\
+	unsigned long hash = 0;\
+	size_t idx = 0;\
+	size_t dest = 0;\
+\
+	Functions_Prefix_##_alloc(&new_map, new_capacity);\
+	new_map.size = map->size;\
+	new_map.iteration_callback = map->iteration_callback;\
+	new_map.seed = map->seed;\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		if ((map->ctrl[idx] & 0x80) != 0) {\
+			continue;\
+		}\
+\
+		hash = Functions_Prefix_##_hash(map, map->slots[idx].key);\
+		dest = Functions_Prefix_##_find_free(&new_map, hash);\
+		new_map.ctrl[dest] = (unsigned char)(hash & 0x7F);\
+		new_map.slots[dest] = map->slots[idx];\
+	}\
+\
+	HASHMAP_FREE((void *)map->slots);\
+	*map = new_map;\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
+{\
+	size_t new_capacity = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_grow but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	new_capacity = map->capacity << 1;\
+\
+	if (new_capacity < map->capacity) {\
+		/* Overflow, do not grow */\
+		return;\
+	}\
+	if (new_capacity >\
+	    ((size_t)-1) / (sizeof(struct Struct_Name_##Slot) + 1)) {\
+		/* Would overflow, do not grow */\
+		return;\
+	}\
+\
+	Functions_Prefix_##_rehash(map, new_capacity);\
+}\
+\
+int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	unsigned long hash = 0;\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	hash = Functions_Prefix_##_hash(map, key);\
+\
+	idx = Functions_Prefix_##_find(map, key, hash);\
+	if (idx != map->capacity) {\
+		/* Override existing value */\
+		map->slots[idx].value = value;\
+		return 1;\
+	}\
+\
+	/* Check for being above load factor, counting tombstones. If live\
+	 * entries alone are below it, purging tombstones is enough. */\
+	if ((float)(map->size + 1) / (float)map->capacity >\
+	    HASHMAP_SWISS_LOAD_FACTOR) {\
+		Functions_Prefix_##_grow(map);\
+	} else if ((float)(map->size + map->deleted + 1) /\
+			   (float)map->capacity >\
+		   HASHMAP_SWISS_LOAD_FACTOR) {\
+		Functions_Prefix_##_rehash(map, map->capacity);\
+	}\
+\
+	idx = Functions_Prefix_##_find_free(map, hash);\
+	if (map->ctrl[idx] == HASHMAP_SWISS_DELETED) {\
+		map->deleted--;\
+	}\
+\
+	map->ctrl[idx] = (unsigned char)(hash & 0x7F);\
+	map->slots[idx].key = key;\
+	map->slots[idx].value = value;\
+	map->size++;\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	return 0;\
+}\
+\
+int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t idx = 0;\
+	size_t base = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_remove but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		return 0;\
+	}\
+\
+	idx = Functions_Prefix_##_find(map, key, Functions_Prefix_##_hash(map, key));\
+	if (idx == map->capacity) {\
+		return 0;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
+\
+	/* Probes never go past a group that has an empty slot, so the slot can\
+	 * be emptied outright. Otherwise, leave a tombstone. */\
+	base = idx - idx % HASHMAP_SWISS_GROUP_SIZE;\
+	if (Functions_Prefix_##_group_match(map->ctrl + base, HASHMAP_SWISS_EMPTY) != 0) {\
+		map->ctrl[idx] = HASHMAP_SWISS_EMPTY;\
+	} else {\
+		map->ctrl[idx] = HASHMAP_SWISS_DELETED;\
+		map->deleted++;\
+	}\
+\
+	assert(map->size > 0);\
+	map->size--;\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		return 0;\
+	}\
+\
+	idx = Functions_Prefix_##_find(map, key, Functions_Prefix_##_hash(map, key));\
+	if (idx == map->capacity) {\
+		return 0;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_has(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_get(map, key, NULL);\
+}\
+\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map)\
+{\
+	return map->size;\
+}\
+\
+void Functions_Prefix_##_free(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_free but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	HASHMAP_FREE((void *)map->slots);\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iterate but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->iteration_callback == NULL) {\
+		return;\
+	}\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		if ((map->ctrl[idx] & 0x80) != 0) {\
+			continue;\
+		}\
+\
+		if (map->iteration_callback(map->slots[idx].key,\
+					    map->slots[idx].value,\
+					    context) == 0) {\
+			break;\
+		}\
+	}\
+}\
+\
+void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
+		       struct Struct_Name_ *RESTRICT src)\
+{\
+	if (dest == NULL || src == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_duplicate but non-null argument expected.");\
+	}\
+	Functions_Prefix_##_assert(src);\
+\
+	if (src->capacity == 0) {\
+		memset(dest, 0, sizeof(struct Struct_Name_));\
+		return;\
+	}\
+\
+	Functions_Prefix_##_alloc(dest, src->capacity);\
+	dest->size = src->size;\
+	dest->deleted = src->deleted;\
+	dest->iteration_callback = src->iteration_callback;\
+	dest->seed = src->seed;\
+\
+	memcpy((void *)dest->slots, (const void *)src->slots,\
+	       src->capacity * (sizeof(struct Struct_Name_##Slot) + 1));\
+\
+	Functions_Prefix_##_assert(dest);\
+}\
+\
+void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->ctrl != NULL) {\
+		memset((void *)map->ctrl, HASHMAP_SWISS_EMPTY, map->capacity);\
+	}\
+\
+	map->size = 0;\
+	map->deleted = 0;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	const unsigned char *bend = bptr + len;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; bptr < bend; bptr++) {\
+		hval ^= (unsigned long)bptr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str)\
+{\
+	const unsigned char *ustr = (const unsigned char *)str;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; ustr[0] != '\0'; ustr++) {\
+		hval ^= (unsigned long)ustr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded(buf, len, 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str(const char *str)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	unsigned long hash = seed;\
+	unsigned long word = 0;\
+	size_t left = len;\
+\
+	/* A whole word per multiply, instead of a byte */\
+	for (; left >= HASHMAP_HASH_WORD_SIZE;\
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {\
+		/* The seed also goes into each word, so that colliding\
+		 * words cannot be chosen without knowing it */\
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);\
+		hash = HASHMAP_HASH_STEP(hash);\
+	}\
+\
+	/* Remaining bytes, as the low bytes of a word */\
+	if (left > 0) {\
+		while (left > 0) {\
+			left--;\
+			word = (word << 8) | (unsigned long)bptr[left];\
+		}\
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);\
+	}\
+\
+	hash ^= (unsigned long)len;\
+	HASHMAP_HASH_FMIX(hash);\
+\
+	return hash;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), seed);\
+}
+
+#define HASHMAP_DECLARE_CUCKOO(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+\
+struct Struct_Name_##Bucket {\
+	Custom_Key_Type_ keys[HASHMAP_CUCKOO_BUCKET_SIZE];\
+	Custom_Value_Type_ values[HASHMAP_CUCKOO_BUCKET_SIZE];\
+	/* Bit n is set if entry n holds a key */\
+	unsigned int occupied;\
+};\
+\
+struct Struct_Name_##Entry {\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+};\
+\
+typedef struct Struct_Name_ {\
+	struct Struct_Name_##Bucket *buckets;\
+	int (*iteration_callback)(Custom_Key_Type_ key, Custom_Value_Type_ value,\
+				  void *context);\
+	size_t size;\
+	/* Number of buckets, each holding HASHMAP_CUCKOO_BUCKET_SIZE entries */\
+	size_t capacity;\
+	/* Entries placed in neither candidate bucket, counted in size */\
+	struct Struct_Name_##Entry stash[HASHMAP_CUCKOO_STASH_SIZE];\
+	size_t stash_size;\
+	/* Mixed into default hashes, picked by Functions_Prefix_##_init() */\
+	unsigned long seed;\
+} Struct_Name_;\
+\
+/* API functions */\
+void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_grow(Struct_Name_ *map);\
+int Functions_Prefix_##_insert(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_remove(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_get(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_has(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map);\
+void Functions_Prefix_##_free(Struct_Name_ *map);\
+void Functions_Prefix_##_iterate(Struct_Name_ *map, void *context);\
+void Functions_Prefix_##_duplicate(Struct_Name_ *RESTRICT dest, Struct_Name_ *RESTRICT src);\
+void Functions_Prefix_##_clear(Struct_Name_ *map);\
+\
+/* Internal functions */\
+void Functions_Prefix_##_assert(const Struct_Name_ *map);\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_);\
+int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2);\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_);\
+unsigned long Functions_Prefix_##_hash(const Struct_Name_ *map, Custom_Key_Type_ key);\
+unsigned long Functions_Prefix_##_alt_hash(unsigned long hash);\
+int Functions_Prefix_##_find(const Struct_Name_ *map, Custom_Key_Type_ key, size_t *bucket,\
+		 unsigned int *entry);\
+int Functions_Prefix_##_bucket_put(struct Struct_Name_##Bucket *bucket, Custom_Key_Type_ key,\
+		       Custom_Value_Type_ value);\
+int Functions_Prefix_##_place(Struct_Name_ *RESTRICT map, Custom_Key_Type_ *RESTRICT key,\
+		  Custom_Value_Type_ *RESTRICT value);\
+size_t Functions_Prefix_##_stash_find(const Struct_Name_ *map, Custom_Key_Type_ key);\
+int Functions_Prefix_##_stash_put(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_move_entries(Struct_Name_ *RESTRICT new_map,\
+			 const Struct_Name_ *RESTRICT map);\
+struct Struct_Name_##Bucket *Functions_Prefix_##_alloc_buckets(size_t capacity);\
+void Functions_Prefix_##_rehash(Struct_Name_ *map, size_t new_capacity);\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_hash_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed);\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed);
+#define HASHMAP_DEFINE_CUCKOO(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+struct Struct_Name_;\
+struct Struct_Name_##Bucket;\
+struct Struct_Name_##Entry;\
+HASHMAP_DEFINE_PANIC(Functions_Prefix_)\
+\
+void Functions_Prefix_##_assert(const struct Struct_Name_ *map)\
+{\
+	/* If buckets is NULL, map should be in initial/freed state */\
+	if (map->buckets == NULL) {\
+		assert(map->size == 0);\
+		assert(map->capacity == 0);\
+		return;\
+	}\
+\
+	/* Capacity must be a power of 2 with room for both candidates */\
+	assert(map->capacity >= 2);\
+	assert((map->capacity & (map->capacity - 1)) == 0);\
+\
+	assert(map->stash_size <= HASHMAP_CUCKOO_STASH_SIZE);\
+	assert(map->stash_size <= map->size);\
+	assert(map->size - map->stash_size <=\
+	       map->capacity * HASHMAP_CUCKOO_BUCKET_SIZE);\
+}\
+\
+struct Struct_Name_##Bucket *Functions_Prefix_##_alloc_buckets(size_t capacity)\
+{\
+	struct Struct_Name_##Bucket *buckets =\
+		(struct Struct_Name_##Bucket *)HASHMAP_REALLOC(\
+			NULL, capacity * sizeof(struct Struct_Name_##Bucket));\
+	if (buckets == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	memset((void *)buckets, 0, capacity * sizeof(struct Struct_Name_##Bucket));\
+\
+	return buckets;\
+}\
+\
+void Functions_Prefix_##_init(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_init but non-null argument expected.");\
+	}\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+\
+	/* Same number of entries as the other engines */\
+	map->capacity =\
+		HASHMAP_DEFAULT_CAPACITY / HASHMAP_CUCKOO_BUCKET_SIZE > 2 ?\
+			HASHMAP_DEFAULT_CAPACITY / HASHMAP_CUCKOO_BUCKET_SIZE :\
+			2;\
+	map->buckets = Functions_Prefix_##_alloc_buckets(map->capacity);\
+\
+	/* Spread the raw entropy over every bit */\
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));\
+	HASHMAP_HASH_FMIX(map->seed);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_)\
+{\
+	return Custom_Comparison_Func_;\
+}\
+\
+HASHMAP_INLINE int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
+{\
+	int (*const callback)(Custom_Key_Type_, Custom_Key_Type_) = Custom_Comparison_Func_;\
+\
+	if (callback == NULL) {\
+		return memcmp((void *)&key1, (void *)&key2, sizeof(Custom_Key_Type_));\
+	}\
+	return callback(key1, key2);\
+}\
+\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_)\
+{\
+	return Custom_Hash_Func_;\
+}\
+\
+HASHMAP_INLINE unsigned long Functions_Prefix_##_hash(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	unsigned long (*const callback)(Custom_Key_Type_) = Custom_Hash_Func_;\
+\
+	if (callback == NULL) {\
+		return Functions_Prefix_##_hash_buf_seeded((const void *)&key,\
+					       sizeof(Custom_Key_Type_), map->seed);\
+	}\
+	return callback(key);\
+}\
+\
+/* Second hash function: a MurmurHash3 finalizer over the first hash, so\
+ * keys sharing a first bucket spread over different second buckets */\
+unsigned long Functions_Prefix_##_alt_hash(unsigned long hash)\
+{\
+	hash = (hash ^ (hash >> 16)) & 0xFFFFFFFFUL;\
+	hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;\
+	hash ^= hash >> 13;\
+	hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;\
+	hash ^= hash >> 16;\
+\
+	return hash;\
+}\
+\
+/* Look for key in its two candidate buckets */\
+int Functions_Prefix_##_find(const struct Struct_Name_ *map, Custom_Key_Type_ key, size_t *bucket,\
+		 unsigned int *entry)\
+{\
+	const struct Struct_Name_##Bucket *candidate = NULL;\
+	unsigned long hash = Functions_Prefix_##_hash(map, key);\
+	size_t candidates[2];\
+	size_t idx = 0;\
+	unsigned int slot = 0;\
+\
+	candidates[0] = hash & (map->capacity - 1);\
+	candidates[1] = Functions_Prefix_##_alt_hash(hash) & (map->capacity - 1);\
+\
+	for (idx = 0; idx < 2; idx++) {\
+		candidate = &map->buckets[candidates[idx]];\
+\
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {\
+			if ((candidate->occupied & (1U << slot)) != 0 &&\
+			    Functions_Prefix_##_compare_keys(candidate->keys[slot], key) ==\
+				    0) {\
+				*bucket = candidates[idx];\
+				*entry = slot;\
+				return 1;\
+			}\
+		}\
+	}\
+\
+	return 0;\
+}\
+\
+/* Store an entry in a free slot of bucket. Returns 0 if bucket is full. */\
+int Functions_Prefix_##_bucket_put(struct Struct_Name_##Bucket *bucket, Custom_Key_Type_ key,\
+		       Custom_Value_Type_ value)\
+{\
+	unsigned int slot = 0;\
+\
+	for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {\
+		if ((bucket->occupied & (1U << slot)) == 0) {\
+			bucket->keys[slot] = key;\
+			bucket->values[slot] = value;\
+			bucket->occupied |= 1U << slot;\
+			return 1;\
+		}\
+	}\
+\
+	return 0;\
+}\
+\
+/* Place an entry known to be absent, evicting entries to their other bucket\
+ * when both candidates are full. Returns 0 if the kick limit is reached, in\
+ * which case key and value hold the entry left without a slot. */\
+int Functions_Prefix_##_place(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ *RESTRICT key,\
+		  Custom_Value_Type_ *RESTRICT value)\
+{\
+	struct Struct_Name_##Bucket *bucket = NULL;\
+	Custom_Key_Type_ evicted_key;\
+	Custom_Value_Type_ evicted_value;\
+	unsigned long hash = Functions_Prefix_##_hash(map, *key);\
+	size_t first = hash & (map->capacity - 1);\
+	size_t second = Functions_Prefix_##_alt_hash(hash) & (map->capacity - 1);\
+	unsigned int slot = 0;\
+	size_t kicks = 0;\
+\
+	if (Functions_Prefix_##_bucket_put(&map->buckets[first], *key, *value) ||\
+	    Functions_Prefix_##_bucket_put(&map->buckets[second], *key, *value)) {\
+		return 1;\
+	}\
+\
+	for (kicks = 0; kicks < HASHMAP_CUCKOO_MAX_KICKS; kicks++) {\
+		/* Swap with a victim, rotating the slot to avoid cycles */\
+		bucket = &map->buckets[first];\
+		slot = (unsigned int)(kicks % HASHMAP_CUCKOO_BUCKET_SIZE);\
+\
+		evicted_key = bucket->keys[slot];\
+		evicted_value = bucket->values[slot];\
+		bucket->keys[slot] = *key;\
+		bucket->values[slot] = *value;\
+		*key = evicted_key;\
+		*value = evicted_value;\
+\
+		/* Move the victim to its other candidate bucket */\
+		hash = Functions_Prefix_##_hash(map, *key);\
+		second = hash & (map->capacity - 1);\
+		if (second == first) {\
+			second = Functions_Prefix_##_alt_hash(hash) & (map->capacity - 1);\
+		}\
+\
+		if (Functions_Prefix_##_bucket_put(&map->buckets[second], *key, *value)) {\
+			return 1;\
+		}\
+\
+		first = second;\
+	}\
+\
+	return 0;\
+}\
+\
+/* Returns the stash index of key, or stash_size if key is not stashed */\
+size_t Functions_Prefix_##_stash_find(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	size_t idx = 0;\
+\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		if (Functions_Prefix_##_compare_keys(map->stash[idx].key, key) == 0) {\
+			return idx;\
+		}\
+	}\
+\
+	return map->stash_size;\
+}\
+\
+/* Append an entry known to be absent to the stash. Returns 0 if the stash is\
+ * full. */\
+int Functions_Prefix_##_stash_put(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	if (map->stash_size == HASHMAP_CUCKOO_STASH_SIZE) {\
+		return 0;\
+	}\
+\
+	map->stash[map->stash_size].key = key;\
+	map->stash[map->stash_size].value = value;\
+	map->stash_size++;\
+\
+	return 1;\
+}\
+\
+/* Place every entry of map in new_map, stashing those finding no bucket.\
+ * Returns 0 if the stash of new_map overflows. */\
+int Functions_Prefix_##_move_entries(struct Struct_Name_ *RESTRICT new_map,\
+			 const struct Struct_Name_ *RESTRICT map)\
+{\
+	const struct Struct_Name_##Bucket *bucket = NULL;\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+	size_t idx = 0;\
+	unsigned int slot = 0;\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		bucket = &map->buckets[idx];\
+\
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {\
+			if ((bucket->occupied & (1U << slot)) == 0) {\
+				continue;\
+			}\
+\
+			key = bucket->keys[slot];\
+			value = bucket->values[slot];\
+			if (!Functions_Prefix_##_place(new_map, &key, &value) &&\
+			    !Functions_Prefix_##_stash_put(new_map, key, value)) {\
+				return 0;\
+			}\
+		}\
+	}\
+\
+	/* Stashed entries may fit now */\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		key = map->stash[idx].key;\
+		value = map->stash[idx].value;\
+		if (!Functions_Prefix_##_place(new_map, &key, &value) &&\
+		    !Functions_Prefix_##_stash_put(new_map, key, value)) {\
+			return 0;\
+		}\
+	}\
+\
+	return 1;\
+}\
+\
+/* Move every entry to a table of new_capacity buckets, doubling it while the\
+ * entries finding no bucket overflow the stash */\
+void Functions_Prefix_##_rehash(struct Struct_Name_ *map, size_t new_capacity)\
+{\
+	struct Struct_Name_ new_map = { 0 };\
+\
+	new_map.seed = map->seed;\
+\
+	for (;;) {\
+		new_map.buckets = Functions_Prefix_##_alloc_buckets(new_capacity);\
+		new_map.capacity = new_capacity;\
+		new_map.stash_size = 0;\
+\
+		if (Functions_Prefix_##_move_entries(&new_map, map)) {\
+			break;\
+		}\
+\
+		HASHMAP_FREE((void *)new_map.buckets);\
+\
+		new_capacity <<= 1;\
+		if (new_capacity < new_map.capacity ||\
+		    new_capacity >\
+			    ((size_t)-1) / sizeof(struct Struct_Name_##Bucket)) {\
+			Functions_Prefix_##_panic("Cannot grow "#Functions_Prefix_". Panic.");\
+		}\
+		/* Keys still left over share hashes no capacity tells apart */\
+		if (new_capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {\
+			Functions_Prefix_##_panic("Too many colliding keys. Panic.");\
+		}\
+	}\
+\
+	new_map.size = map->size;\
+	new_map.iteration_callback = map->iteration_callback;\
+\
+	HASHMAP_FREE((void *)map->buckets);\
+	*map = new_map;\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
+{\
+	size_t new_capacity = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_grow but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	new_capacity = map->capacity << 1;\
+\
+	if (new_capacity < map->capacity) {\
+		/* Overflow, do not grow */\
+		return;\
+	}\
+	if (new_capacity > ((size_t)-1) / sizeof(struct Struct_Name_##Bucket)) {\
+		/* Would overflow, do not grow */\
+		return;\
+	}\
+\
+	Functions_Prefix_##_rehash(map, new_capacity);\
+}\
+\
+int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	size_t bucket = 0;\
+	size_t capacity = 0;\
+	unsigned int entry = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	if (Functions_Prefix_##_find(map, key, &bucket, &entry)) {\
+		/* Override existing value */\
+		map->buckets[bucket].values[entry] = value;\
+		return 1;\
+	}\
+\
+	bucket = Functions_Prefix_##_stash_find(map, key);\
+	if (bucket < map->stash_size) {\
+		map->stash[bucket].value = value;\
+		return 1;\
+	}\
+\
+	/* Check for being above load factor */\
+	if ((float)(map->size + 1) /\
+		    (float)(map->capacity * HASHMAP_CUCKOO_BUCKET_SIZE) >\
+	    HASHMAP_CUCKOO_LOAD_FACTOR) {\
+		Functions_Prefix_##_grow(map);\
+	}\
+\
+	/* Make room in the stash for an entry left out after too many kicks */\
+	while (map->stash_size == HASHMAP_CUCKOO_STASH_SIZE) {\
+		/* Stashed keys share hashes no capacity tells apart */\
+		if (map->capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {\
+			Functions_Prefix_##_panic("Too many colliding keys. Panic.");\
+		}\
+\
+		capacity = map->capacity;\
+		Functions_Prefix_##_grow(map);\
+		if (map->capacity == capacity) {\
+			Functions_Prefix_##_panic("Cannot grow "#Functions_Prefix_". Panic.");\
+		}\
+	}\
+\
+	if (!Functions_Prefix_##_place(map, &key, &value)) {\
+		Functions_Prefix_##_stash_put(map, key, value);\
+	}\
+\
+	map->size++;\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	return 0;\
+}\
+\
+int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t bucket = 0;\
+	unsigned int entry = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_remove but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		return 0;\
+	}\
+\
+	if (!Functions_Prefix_##_find(map, key, &bucket, &entry)) {\
+		bucket = Functions_Prefix_##_stash_find(map, key);\
+		if (bucket == map->stash_size) {\
+			return 0;\
+		}\
+\
+		if (out != NULL) {\
+			*out = map->stash[bucket].value;\
+		}\
+\
+		/* Fill the hole with the last stashed entry */\
+		map->stash_size--;\
+		map->stash[bucket] = map->stash[map->stash_size];\
+\
+		assert(map->size > 0);\
+		map->size--;\
+\
+		return 1;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->buckets[bucket].values[entry];\
+	}\
+\
+	map->buckets[bucket].occupied &= ~(1U << entry);\
+\
+	assert(map->size > 0);\
+	map->size--;\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out)\
+{\
+	size_t bucket = 0;\
+	unsigned int entry = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_get but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->buckets == NULL) {\
+		return 0;\
+	}\
+\
+	if (!Functions_Prefix_##_find(map, key, &bucket, &entry)) {\
+		bucket = Functions_Prefix_##_stash_find(map, key);\
+		if (bucket == map->stash_size) {\
+			return 0;\
+		}\
+\
+		if (out != NULL) {\
+			*out = map->stash[bucket].value;\
+		}\
+\
+		return 1;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->buckets[bucket].values[entry];\
+	}\
+\
+	return 1;\
+}\
+\
+int Functions_Prefix_##_has(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_get(map, key, NULL);\
+}\
+\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map)\
+{\
+	return map->size;\
+}\
+\
+void Functions_Prefix_##_free(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_free but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	HASHMAP_FREE((void *)map->buckets);\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
+{\
+	struct Struct_Name_##Bucket *bucket = NULL;\
+	size_t idx = 0;\
+	unsigned int slot = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_iterate but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->iteration_callback == NULL) {\
+		return;\
+	}\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		bucket = &map->buckets[idx];\
+\
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {\
+			if ((bucket->occupied & (1U << slot)) == 0) {\
+				continue;\
+			}\
+\
+			if (map->iteration_callback(bucket->keys[slot],\
+						    bucket->values[slot],\
+						    context) == 0) {\
+				return;\
+			}\
+		}\
+	}\
+\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		if (map->iteration_callback(map->stash[idx].key,\
+					    map->stash[idx].value,\
+					    context) == 0) {\
+			return;\
+		}\
+	}\
+}\
+\
+void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
+		       struct Struct_Name_ *RESTRICT src)\
+{\
+	if (dest == NULL || src == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_duplicate but non-null argument expected.");\
+	}\
+	Functions_Prefix_##_assert(src);\
+\
+	if (src->capacity == 0) {\
+		memset(dest, 0, sizeof(struct Struct_Name_));\
+		return;\
+	}\
+\
+	dest->buckets = Functions_Prefix_##_alloc_buckets(src->capacity);\
+	dest->capacity = src->capacity;\
+	dest->size = src->size;\
+	dest->iteration_callback = src->iteration_callback;\
+	dest->seed = src->seed;\
+\
+	memcpy((void *)dest->buckets, (const void *)src->buckets,\
+	       src->capacity * sizeof(struct Struct_Name_##Bucket));\
+\
+	memcpy((void *)dest->stash, (const void *)src->stash,\
+	       src->stash_size * sizeof(struct Struct_Name_##Entry));\
+	dest->stash_size = src->stash_size;\
+\
+	Functions_Prefix_##_assert(dest);\
+}\
+\
+void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
+{\
+	size_t idx = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		map->buckets[idx].occupied = 0;\
+	}\
+\
+	map->stash_size = 0;\
+	map->size = 0;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	const unsigned char *bend = bptr + len;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; bptr < bend; bptr++) {\
+		hval ^= (unsigned long)bptr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str)\
+{\
+	const unsigned char *ustr = (const unsigned char *)str;\
+	unsigned long hval = 0x811c9dc5U;\
+\
+	for (; ustr[0] != '\0'; ustr++) {\
+		hval ^= (unsigned long)ustr[0];\
+		hval *= 0x01000193U;\
+		hval &= 0xFFFFFFFFUL;\
+	}\
+\
+	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded(buf, len, 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str(const char *str)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	unsigned long hash = seed;\
+	unsigned long word = 0;\
+	size_t left = len;\
+\
+	/* A whole word per multiply, instead of a byte */\
+	for (; left >= HASHMAP_HASH_WORD_SIZE;\
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {\
+		/* The seed also goes into each word, so that colliding\
+		 * words cannot be chosen without knowing it */\
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);\
+		hash = HASHMAP_HASH_STEP(hash);\
+	}\
+\
+	/* Remaining bytes, as the low bytes of a word */\
+	if (left > 0) {\
+		while (left > 0) {\
+			left--;\
+			word = (word << 8) | (unsigned long)bptr[left];\
+		}\
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);\
+	}\
+\
+	hash ^= (unsigned long)len;\
+	HASHMAP_HASH_FMIX(hash);\
+\
+	return hash;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), seed);\
+}
+
+#define HASHMAP_DECLARE_HOPSCOTCH(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+\
+struct Struct_Name_##Slot {\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+	/* Bit n is set if slot (this + n) holds a key whose home is this slot,\
+	 * and HASHMAP_HOPSCOTCH_OCCUPIED if this slot holds a key */\
+	HASHMAP_HOP hop;\
+};\
+\
+struct Struct_Name_##Entry {\
+	Custom_Key_Type_ key;\
+	Custom_Value_Type_ value;\
+};\
+\
+typedef struct Struct_Name_ {\
+	struct Struct_Name_##Slot *slots;\
+	int (*iteration_callback)(Custom_Key_Type_ key, Custom_Value_Type_ value,\
+				  void *context);\
+	size_t size;\
+	size_t capacity;\
+	/* Entries placed in no neighborhood, counted in size */\
+	struct Struct_Name_##Entry stash[HASHMAP_HOPSCOTCH_STASH_SIZE];\
+	size_t stash_size;\
+	/* Mixed into default hashes, picked by Functions_Prefix_##_init() */\
+	unsigned long seed;\
+} Struct_Name_;\
+\
+/* API functions */\
+void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_grow(Struct_Name_ *map);\
+int Functions_Prefix_##_insert(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_remove(Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		   Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_get(const Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
+		Custom_Value_Type_ *RESTRICT out);\
+int Functions_Prefix_##_has(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_size(const Struct_Name_ *map);\
+void Functions_Prefix_##_free(Struct_Name_ *map);\
+void Functions_Prefix_##_iterate(Struct_Name_ *map, void *context);\
+void Functions_Prefix_##_duplicate(Struct_Name_ *RESTRICT dest, Struct_Name_ *RESTRICT src);\
+void Functions_Prefix_##_clear(Struct_Name_ *map);\
+\
+/* Internal functions */\
+void Functions_Prefix_##_assert(const Struct_Name_ *map);\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_);\
+int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2);\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_);\
+unsigned long Functions_Prefix_##_hash(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_hash_index(const Struct_Name_ *map, Custom_Key_Type_ key);\
+size_t Functions_Prefix_##_find(const Struct_Name_ *map, Custom_Key_Type_ key);\
+int Functions_Prefix_##_place(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+size_t Functions_Prefix_##_stash_find(const Struct_Name_ *map, Custom_Key_Type_ key);\
+int Functions_Prefix_##_stash_put(Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value);\
+int Functions_Prefix_##_move_entries(Struct_Name_ *RESTRICT new_map,\
+			 const Struct_Name_ *RESTRICT map);\
+struct Struct_Name_##Slot *Functions_Prefix_##_alloc_slots(size_t capacity);\
+void Functions_Prefix_##_rehash(Struct_Name_ *map, size_t new_capacity);\
+unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len);\
+unsigned long Functions_Prefix_##_hash_str(const char *str);\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed);\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed);
+#define HASHMAP_DEFINE_HOPSCOTCH(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\
+struct Struct_Name_;\
+struct Struct_Name_##Slot;\
+struct Struct_Name_##Entry;\
+HASHMAP_DEFINE_PANIC(Functions_Prefix_)\
+\
+void Functions_Prefix_##_assert(const struct Struct_Name_ *map)\
+{\
+	/* If slots is NULL, map should be in initial/freed state */\
+	if (map->slots == NULL) {\
+		assert(map->size == 0);\
+		assert(map->capacity == 0);\
+		return;\
+	}\
+\
+	/* Capacity must be a power of 2 covering a whole neighborhood */\
+	assert(map->capacity >= HASHMAP_HOPSCOTCH_NEIGHBORHOOD);\
+	assert((map->capacity & (map->capacity - 1)) == 0);\
+\
+	assert(map->stash_size <= HASHMAP_HOPSCOTCH_STASH_SIZE);\
+	assert(map->stash_size <= map->size);\
+\
+	/* At least one slot must stay free */\
+	assert(map->size - map->stash_size < map->capacity);\
+}\
+\
+struct Struct_Name_##Slot *Functions_Prefix_##_alloc_slots(size_t capacity)\
+{\
+	struct Struct_Name_##Slot *slots = (struct Struct_Name_##Slot *)HASHMAP_REALLOC(\
+		NULL, capacity * sizeof(struct Struct_Name_##Slot));\
+	if (slots == NULL) {\
+		Functions_Prefix_##_panic("Out of memory. Panic.");\
+	}\
+\
+	memset((void *)slots, 0, capacity * sizeof(struct Struct_Name_##Slot));\
+\
+	return slots;\
+}\
+\
+void Functions_Prefix_##_init(struct Struct_Name_ *map)\
+{\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_init but non-null argument expected.");\
+	}\
+\
+	memset((void *)map, 0, sizeof(struct Struct_Name_));\
+\
+	/* A power of 2 covering a whole neighborhood */\
+	map->capacity = HASHMAP_DEFAULT_CAPACITY > HASHMAP_HOPSCOTCH_NEIGHBORHOOD ?\
+				HASHMAP_DEFAULT_CAPACITY :\
+				HASHMAP_HOPSCOTCH_NEIGHBORHOOD + 1;\
+	map->slots = Functions_Prefix_##_alloc_slots(map->capacity);\
+\
+	/* Spread the raw entropy over every bit */\
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));\
+	HASHMAP_HASH_FMIX(map->seed);\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+int (*Functions_Prefix_##_compare_comparison_callback(void))(Custom_Key_Type_, Custom_Key_Type_)\
+{\
+	return Custom_Comparison_Func_;\
+}\
+\
+HASHMAP_INLINE int Functions_Prefix_##_compare_keys(Custom_Key_Type_ key1, Custom_Key_Type_ key2)\
+{\
+	int (*const callback)(Custom_Key_Type_, Custom_Key_Type_) = Custom_Comparison_Func_;\
+\
+	if (callback == NULL) {\
+		return memcmp((void *)&key1, (void *)&key2, sizeof(Custom_Key_Type_));\
+	}\
+	return callback(key1, key2);\
+}\
+\
+unsigned long (*Functions_Prefix_##_compare_hash_callback(void))(Custom_Key_Type_)\
+{\
+	return Custom_Hash_Func_;\
+}\
+\
+HASHMAP_INLINE unsigned long Functions_Prefix_##_hash(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	unsigned long (*const callback)(Custom_Key_Type_) = Custom_Hash_Func_;\
+\
+	if (callback == NULL) {\
+		return Functions_Prefix_##_hash_buf_seeded((const void *)&key,\
+					       sizeof(Custom_Key_Type_), map->seed);\
+	}\
+	return callback(key);\
+}\
+\
+HASHMAP_INLINE size_t Functions_Prefix_##_hash_index(const struct Struct_Name_ *map,\
+					  Custom_Key_Type_ key)\
+{\
+	return Functions_Prefix_##_hash(map, key) & (map->capacity - 1);\
+}\
+\
+/* Returns the slot holding key, or capacity if key is absent */\
+size_t Functions_Prefix_##_find(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	size_t home = Functions_Prefix_##_hash_index(map, key);\
+	size_t idx = 0;\
+	size_t distance = 0;\
+	HASHMAP_HOP hop = map->slots[home].hop & ~HASHMAP_HOPSCOTCH_OCCUPIED;\
+\
+	for (distance = 0; hop != 0; distance++, hop >>= 1) {\
+		if ((hop & 1U) == 0) {\
+			continue;\
+		}\
+\
+		idx = (home + distance) & (map->capacity - 1);\
+		if (Functions_Prefix_##_compare_keys(map->slots[idx].key, key) == 0) {\
+			return idx;\
+		}\
+	}\
+\
+	return map->capacity;\
+}\
+\
+/* Place an entry known to be absent. Returns 0 if no free slot can be moved\
+ * into its neighborhood. */\
+int Functions_Prefix_##_place(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	struct Struct_Name_##Slot *slots = map->slots;\
+	size_t mask = map->capacity - 1;\
+	size_t home = Functions_Prefix_##_hash_index(map, key);\
+	size_t distance = 0;\
+	size_t free_idx = 0;\
+	size_t candidate = 0;\
+	size_t offset = 0;\
+	size_t moved = 0;\
+\
+	/* Find the closest free slot */\
+	while ((slots[(home + distance) & mask].hop &\
+		HASHMAP_HOPSCOTCH_OCCUPIED) != 0) {\
+		distance++;\
+		if (distance >= map->capacity) {\
+			return 0;\
+		}\
+	}\
+\
+	/* Hop the free slot back until it is in the neighborhood of home */\
+	while (distance >= HASHMAP_HOPSCOTCH_NEIGHBORHOOD) {\
+		free_idx = (home + distance) & mask;\
+\
+		/* Farthest home slot with a key stored before the free slot */\
+		for (offset = HASHMAP_HOPSCOTCH_NEIGHBORHOOD - 1; offset > 0;\
+		     offset--) {\
+			candidate = (free_idx - offset) & mask;\
+\
+			for (moved = 0; moved < offset; moved++) {\
+				if (slots[candidate].hop &\
+				    ((HASHMAP_HOP)1 << moved)) {\
+					break;\
+				}\
+			}\
+\
+			if (moved < offset) {\
+				break;\
+			}\
+		}\
+\
+		if (offset == 0) {\
+			return 0;\
+		}\
+\
+		/* Move that key to the free slot, freeing its own */\
+		slots[free_idx].key = slots[(candidate + moved) & mask].key;\
+		slots[free_idx].value = slots[(candidate + moved) & mask].value;\
+		slots[free_idx].hop |= HASHMAP_HOPSCOTCH_OCCUPIED;\
+		slots[(candidate + moved) & mask].hop &=\
+			~HASHMAP_HOPSCOTCH_OCCUPIED;\
+		slots[candidate].hop &= ~((HASHMAP_HOP)1 << moved);\
+		slots[candidate].hop |= (HASHMAP_HOP)1 << offset;\
+\
+		distance -= offset - moved;\
+	}\
+\
+	free_idx = (home + distance) & mask;\
+	slots[free_idx].key = key;\
+	slots[free_idx].value = value;\
+	slots[free_idx].hop |= HASHMAP_HOPSCOTCH_OCCUPIED;\
+	slots[home].hop |= (HASHMAP_HOP)1 << distance;\
+\
+	return 1;\
+}\
+\
+/* Returns the stash index of key, or stash_size if key is not stashed */\
+size_t Functions_Prefix_##_stash_find(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
+{\
+	size_t idx = 0;\
+\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		if (Functions_Prefix_##_compare_keys(map->stash[idx].key, key) == 0) {\
+			return idx;\
+		}\
+	}\
+\
+	return map->stash_size;\
+}\
+\
+/* Append an entry known to be absent to the stash. Returns 0 if the stash is\
+ * full. */\
+int Functions_Prefix_##_stash_put(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	if (map->stash_size == HASHMAP_HOPSCOTCH_STASH_SIZE) {\
+		return 0;\
+	}\
+\
+	map->stash[map->stash_size].key = key;\
+	map->stash[map->stash_size].value = value;\
+	map->stash_size++;\
+\
+	return 1;\
+}\
+\
+/* Place every entry of map in new_map, stashing those finding no slot in\
+ * their neighborhood. Returns 0 if the stash of new_map overflows. */\
+int Functions_Prefix_##_move_entries(struct Struct_Name_ *RESTRICT new_map,\
+			 const struct Struct_Name_ *RESTRICT map)\
+{\
+	const struct Struct_Name_##Slot *slot = NULL;\
+	const struct Struct_Name_##Entry *entry = NULL;\
+	size_t idx = 0;\
+\
+	for (idx = 0; idx < map->capacity; idx++) {\
+		slot = &map->slots[idx];\
+		if ((slot->hop & HASHMAP_HOPSCOTCH_OCCUPIED) == 0) {\
+			continue;\
+		}\
+\
+		if (!Functions_Prefix_##_place(new_map, slot->key, slot->value) &&\
+		    !Functions_Prefix_##_stash_put(new_map, slot->key, slot->value)) {\
+			return 0;\
+		}\
+	}\
+\
+	/* Stashed entries may fit now */\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		entry = &map->stash[idx];\
+		if (!Functions_Prefix_##_place(new_map, entry->key, entry->value) &&\
+		    !Functions_Prefix_##_stash_put(new_map, entry->key, entry->value)) {\
+			return 0;\
+		}\
+	}\
+\
+	return 1;\
+}\
+\
+/* Move every entry to a table of new_capacity slots, doubling it while the\
+ * entries finding no slot overflow the stash */\
+void Functions_Prefix_##_rehash(struct Struct_Name_ *map, size_t new_capacity)\
+{\
+	struct Struct_Name_ new_map = { 0 };\
+\
+	new_map.seed = map->seed;\
+\
+	for (;;) {\
+		new_map.slots = Functions_Prefix_##_alloc_slots(new_capacity);\
+		new_map.capacity = new_capacity;\
+		new_map.stash_size = 0;\
+\
+		if (Functions_Prefix_##_move_entries(&new_map, map)) {\
+			break;\
+		}\
+\
+		HASHMAP_FREE((void *)new_map.slots);\
+\
+		new_capacity <<= 1;\
+		if (new_capacity < new_map.capacity ||\
+		    new_capacity > ((size_t)-1) / sizeof(struct Struct_Name_##Slot)) {\
+			Functions_Prefix_##_panic("Cannot grow "#Functions_Prefix_". Panic.");\
+		}\
+		/* Keys still left over share hashes no capacity tells apart */\
+		if (new_capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {\
+			Functions_Prefix_##_panic("Too many colliding keys. Panic.");\
+		}\
+	}\
+\
+	new_map.size = map->size;\
+	new_map.iteration_callback = map->iteration_callback;\
+\
+	HASHMAP_FREE((void *)map->slots);\
+	*map = new_map;\
+\
+	Functions_Prefix_##_assert(map);\
+}\
+\
+void Functions_Prefix_##_grow(struct Struct_Name_ *map)\
+{\
+	size_t new_capacity = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_grow but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	new_capacity = map->capacity << 1;\
+\
+	if (new_capacity < map->capacity) {\
+		/* Overflow, do not grow */\
+		return;\
+	}\
+	if (new_capacity > ((size_t)-1) / sizeof(struct Struct_Name_##Slot)) {\
+		/* Would overflow, do not grow */\
+		return;\
+	}\
+\
+	Functions_Prefix_##_rehash(map, new_capacity);\
+}\
+\
+int Functions_Prefix_##_insert(struct Struct_Name_ *map, Custom_Key_Type_ key, Custom_Value_Type_ value)\
+{\
+	size_t idx = 0;\
+	size_t capacity = 0;\
+\
+	if (map == NULL) {\
+		if (HASHMAP_NO_PANIC_ON_NULL) {\
+			return -1;\
+		}\
+		Functions_Prefix_##_panic(\
+			"Null passed to "#Functions_Prefix_"_insert but non-null argument expected.");\
+	}\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	if (map->slots == NULL) {\
+		Functions_Prefix_##_init(map);\
+	}\
+\
+	idx = Functions_Prefix_##_find(map, key);\
+	if (idx != map->capacity) {\
+		/* Override existing value */\
+		map->slots[idx].value = value;\
+		return 1;\
+	}\
+\
+	idx = Functions_Prefix_##_stash_find(map, key);\
+	if (idx < map->stash_size) {\
+		map->stash[idx].value = value;\
+		return 1;\
+	}\
+\
+	/* Check for being above load factor */\
+	if ((float)(map->size + 1) / (float)map->capacity >\
+	    HASHMAP_HOPSCOTCH_LOAD_FACTOR) {\
+		Functions_Prefix_##_grow(map);\
+	}\
+\
+	/* Make room in the stash for a key finding no slot in its\
+	 * neighborhood */\
+	while (map->stash_size == HASHMAP_HOPSCOTCH_STASH_SIZE) {\
+		/* Stashed keys share hashes no capacity tells apart */\
+		if (map->capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {\
+			Functions_Prefix_##_panic("Too many colliding keys. Panic.");\
+		}\
+\
+		capacity = map->capacity;\
+		Functions_Prefix_##_grow(map);\
+		if (map->capacity == capacity) {\
+			Functions_Prefix_##_panic("Cannot grow "#Functions_Prefix_". Panic.");\
+		}\
+	}\
+\
+	if (!Functions_Prefix_##_place(map, key, value)) {\
+		Functions_Prefix_##_stash_put(map, key, value);\
+	}\
+\
+	map->size++;\
+\
+	Functions_Prefix_##_assert(map);\
+\
+	return 0;\
 }\
 \
 int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
 		   Custom_Value_Type_ *RESTRICT out)\
 {\
 	size_t idx = 0;\
-	int found = 0;\
+	size_t home = 0;\
 \
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
@@ -673,24 +5071,44 @@ int Functions_Prefix_##_remove(struct Struct_Name_ *RESTRICT map, Custom_Key_Typ
 \
 	Functions_Prefix_##_assert(map);\
 \
-	if (map->buckets == NULL) {\
+	if (map->slots == NULL) {\
 		return 0;\
 	}\
 \
-	idx = Functions_Prefix_##_hash_index(map, key);\
-\
-	found = Functions_Prefix_##_list_remove(&map->buckets[idx], key, out);\
+	idx = Functions_Prefix_##_find(map, key);\
+	if (idx == map->capacity) {\
+		idx = Functions_Prefix_##_stash_find(map, key);\
+		if (idx == map->stash_size) {\
+			return 0;\
+		}\
 \
-	if (found) {\
-		if (map->buckets[idx] == NULL) {\
-			assert(map->buckets_filled > 0);\
-			map->buckets_filled--;\
+		if (out != NULL) {\
+			*out = map->stash[idx].value;\
 		}\
+\
+		/* Fill the hole with the last stashed entry */\
+		map->stash_size--;\
+		map->stash[idx] = map->stash[map->stash_size];\
+\
 		assert(map->size > 0);\
 		map->size--;\
+\
+		return 1;\
 	}\
 \
-	return found;\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
+\
+	home = Functions_Prefix_##_hash_index(map, key);\
+	map->slots[home].hop &=\
+		~((HASHMAP_HOP)1 << ((idx - home) & (map->capacity - 1)));\
+	map->slots[idx].hop &= ~HASHMAP_HOPSCOTCH_OCCUPIED;\
+\
+	assert(map->size > 0);\
+	map->size--;\
+\
+	return 1;\
 }\
 \
 int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_Type_ key,\
@@ -708,13 +5126,29 @@ int Functions_Prefix_##_get(const struct Struct_Name_ *RESTRICT map, Custom_Key_
 \
 	Functions_Prefix_##_assert(map);\
 \
-	if (map->buckets == NULL) {\
+	if (map->slots == NULL) {\
 		return 0;\
 	}\
 \
-	idx = Functions_Prefix_##_hash_index(map, key);\
+	idx = Functions_Prefix_##_find(map, key);\
+	if (idx == map->capacity) {\
+		idx = Functions_Prefix_##_stash_find(map, key);\
+		if (idx == map->stash_size) {\
+			return 0;\
+		}\
+\
+		if (out != NULL) {\
+			*out = map->stash[idx].value;\
+		}\
+\
+		return 1;\
+	}\
+\
+	if (out != NULL) {\
+		*out = map->slots[idx].value;\
+	}\
 \
-	return Functions_Prefix_##_list_find(map->buckets[idx], key, out);\
+	return 1;\
 }\
 \
 int Functions_Prefix_##_has(const struct Struct_Name_ *map, Custom_Key_Type_ key)\
@@ -729,8 +5163,6 @@ size_t Functions_Prefix_##_size(const Struct_Name_ *map)\
 \
 void Functions_Prefix_##_free(struct Struct_Name_ *map)\
 {\
-	size_t idx = 0;\
-\
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
 			return;\
@@ -741,11 +5173,7 @@ void Functions_Prefix_##_free(struct Struct_Name_ *map)\
 \
 	Functions_Prefix_##_assert(map);\
 \
-	for (idx = 0; idx < map->capacity; idx++) {\
-		Functions_Prefix_##_list_free(map->buckets[idx]);\
-	}\
-\
-	HASHMAP_FREE((void *)map->buckets);\
+	HASHMAP_FREE((void *)map->slots);\
 \
 	memset((void *)map, 0, sizeof(struct Struct_Name_));\
 }\
@@ -753,7 +5181,6 @@ void Functions_Prefix_##_free(struct Struct_Name_ *map)\
 void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
 {\
 	size_t idx = 0;\
-	int callback_response = 0;\
 \
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
@@ -770,10 +5197,22 @@ void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
 	}\
 \
 	for (idx = 0; idx < map->capacity; idx++) {\
-		callback_response = Functions_Prefix_##_list_iterate(\
-			map->buckets[idx], map->iteration_callback, context);\
-		if (callback_response == 0) {\
-			break;\
+		if ((map->slots[idx].hop & HASHMAP_HOPSCOTCH_OCCUPIED) == 0) {\
+			continue;\
+		}\
+\
+		if (map->iteration_callback(map->slots[idx].key,\
+					    map->slots[idx].value,\
+					    context) == 0) {\
+			return;\
+		}\
+	}\
+\
+	for (idx = 0; idx < map->stash_size; idx++) {\
+		if (map->iteration_callback(map->stash[idx].key,\
+					    map->stash[idx].value,\
+					    context) == 0) {\
+			return;\
 		}\
 	}\
 }\
@@ -781,14 +5220,12 @@ void Functions_Prefix_##_iterate(struct Struct_Name_ *map, void *context)\
 void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
 		       struct Struct_Name_ *RESTRICT src)\
 {\
-	size_t idx = 0;\
-\
 	if (dest == NULL || src == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
 			return;\
 		}\
 		Functions_Prefix_##_panic(\
-			"Null passed to "#Functions_Prefix_"_clear but non-null argument expected.");\
+			"Null passed to "#Functions_Prefix_"_duplicate but non-null argument expected.");\
 	}\
 	Functions_Prefix_##_assert(src);\
 \
@@ -797,32 +5234,24 @@ void Functions_Prefix_##_duplicate(struct Struct_Name_ *RESTRICT dest,\
 		return;\
 	}\
 \
-	dest->buckets = (struct Struct_Name_##ListNode **)HASHMAP_REALLOC(\
-		NULL, src->capacity * sizeof(struct Struct_Name_##ListNode *));\
-\
-	if (dest->buckets == NULL) {\
-		Functions_Prefix_##_panic("Out of memory. Panic.");\
-	}\
-\
+	dest->slots = Functions_Prefix_##_alloc_slots(src->capacity);\
 	dest->capacity = src->capacity;\
 	dest->size = src->size;\
-	dest->buckets_filled = src->buckets_filled;\
 	dest->iteration_callback = src->iteration_callback;\
+	dest->seed = src->seed;\
 \
-	memset((void *)dest->buckets, 0,\
-	       dest->capacity * sizeof(struct Struct_Name_##ListNode *));\
+	memcpy((void *)dest->slots, (const void *)src->slots,\
+	       src->capacity * sizeof(struct Struct_Name_##Slot));\
 \
-	for (idx = 0; idx < dest->capacity; idx++) {\
-		dest->buckets[idx] = Functions_Prefix_##_list_duplicate(src->buckets[idx]);\
-	}\
+	memcpy((void *)dest->stash, (const void *)src->stash,\
+	       src->stash_size * sizeof(struct Struct_Name_##Entry));\
+	dest->stash_size = src->stash_size;\
 \
 	Functions_Prefix_##_assert(dest);\
 }\
 \
 void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
 {\
-	size_t idx = 0;\
-\
 	if (map == NULL) {\
 		if (HASHMAP_NO_PANIC_ON_NULL) {\
 			return;\
@@ -833,13 +5262,13 @@ void Functions_Prefix_##_clear(struct Struct_Name_ *map)\
 \
 	Functions_Prefix_##_assert(map);\
 \
-	for (idx = 0; idx < map->capacity; idx++) {\
-		Functions_Prefix_##_list_free(map->buckets[idx]);\
-		map->buckets[idx] = NULL;\
+	if (map->slots != NULL) {\
+		memset((void *)map->slots, 0,\
+		       map->capacity * sizeof(struct Struct_Name_##Slot));\
 	}\
 \
+	map->stash_size = 0;\
 	map->size = 0;\
-	map->buckets_filled = 0;\
 }\
 \
 unsigned long Functions_Prefix_##_fnv1a_32_buf(const void *buf, size_t len)\
@@ -869,6 +5298,53 @@ unsigned long Functions_Prefix_##_fnv1a_32_str(const char *str)\
 	}\
 \
 	return hval;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf(const void *buf, size_t len)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded(buf, len, 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str(const char *str)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), 0);\
+}\
+\
+unsigned long Functions_Prefix_##_hash_buf_seeded(const void *buf, size_t len,\
+				      unsigned long seed)\
+{\
+	const unsigned char *bptr = (const unsigned char *)buf;\
+	unsigned long hash = seed;\
+	unsigned long word = 0;\
+	size_t left = len;\
+\
+	/* A whole word per multiply, instead of a byte */\
+	for (; left >= HASHMAP_HASH_WORD_SIZE;\
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {\
+		/* The seed also goes into each word, so that colliding\
+		 * words cannot be chosen without knowing it */\
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);\
+		hash = HASHMAP_HASH_STEP(hash);\
+	}\
+\
+	/* Remaining bytes, as the low bytes of a word */\
+	if (left > 0) {\
+		while (left > 0) {\
+			left--;\
+			word = (word << 8) | (unsigned long)bptr[left];\
+		}\
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);\
+	}\
+\
+	hash ^= (unsigned long)len;\
+	HASHMAP_HASH_FMIX(hash);\
+\
+	return hash;\
+}\
+\
+unsigned long Functions_Prefix_##_hash_str_seeded(const char *str, unsigned long seed)\
+{\
+	return Functions_Prefix_##_hash_buf_seeded((const void *)str, strlen(str), seed);\
 }
 
 /****************************************************************************
@@ -3,6 +3,7 @@
 #define HASHMAP_H
 
 #include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,13 +20,69 @@
  * different types of hashmaps as you want.
  *
  * HASHMAP_DECLARE() takes six arguments: the struct name, the function prefix,
- * the key type, the value type, an optional hash function (NULL for default
- * FNV-1a), and an optional key comparison function (NULL for memcmp).
+ * the key type, the value type, an optional hash function (NULL for
+ * hashmap_hash_buf() over the key's bytes), and an optional key comparison
+ * function (NULL for memcmp). Both are called directly, not through a pointer
+ * kept at runtime, so the compiler may inline them into lookups.
+ *
+ * HASHMAP_DECLARE_SEEDED() and HASHMAP_DEFINE_SEEDED() take the same six
+ * arguments, except that the hash function also takes the seed of the map:
+ * unsigned long hash(CustomKey key, unsigned long seed). Each map picks its
+ * own seed in hashmap_init() (see HASHMAP_SEED_SOURCE), so that keys chosen
+ * to collide, such as strings from the network, cannot be precomputed. The
+ * default hash over the key's bytes, and the hash of the string macros
+ * below, are seeded. A hash function passed to HASHMAP_DECLARE() ignores the
+ * seed.
  *
  * HASHMAP_DECLARE_STRING() takes three arguments: the struct name, the function
  * prefix, and the value type. The key type is automatically set to const char *,
- * the hash function to FNV-1a (reads string content instead of raw pointer),
- * and the comparison function to strcmp.
+ * the hash function to hashmap_hash_str_seeded() (reads string content
+ * instead of raw pointer), and the comparison function to strcmp.
+ *
+ * HASHMAP_DECLARE_STRING_VIEW() and HASHMAP_DEFINE_STRING_VIEW() take the same
+ * three arguments, for keys that are not NUL-terminated, such as fields
+ * parsed out of a network buffer. The key type is a generated struct holding
+ * a pointer and a length, e.g. HashmapStringView { const char *ptr;
+ * size_t len; }, hashed with hashmap_hash_buf_seeded() over len bytes and
+ * compared with memcmp.
+ * Looking up a key in place only takes a view of the buffer, built with the
+ * generated hashmap_string_view(ptr, len), with no copy. The map stores
+ * views, so the bytes of inserted keys must outlive them.
+ *
+ * HASHMAP_DECLARE_INT() and HASHMAP_DEFINE_INT() take four arguments: the
+ * struct name, the function prefix, the integer key type and the value type.
+ * Keys are compared with != and hashed with the MurmurHash3 finalizer, two
+ * rounds of xorshift and multiply in which every key bit reaches the low
+ * bits that select the bucket. Keys differing only in their high bits, or
+ * in the same stride as the capacity, spread like random ones instead of
+ * sharing buckets. Keys wider than unsigned long are folded into it first,
+ * and the seed of the map is xored in before mixing.
+ *
+ * HASHMAP_DECLARE_STRING_KEY() and HASHMAP_DEFINE_STRING_KEY() take the same
+ * three arguments as the string macros. Keys are generated records holding
+ * the pointer, length and hash of a string, e.g. HashmapStringKey {
+ * const char *ptr; size_t len; unsigned long hash; }, built once with
+ * hashmap_string_key(map, str) or hashmap_string_key_len(map, ptr, len).
+ * Operations then never scan the string again: hashing returns the stored
+ * hash, and comparisons reject on hash or length before comparing bytes
+ * with memcmp, 32 or 16 bytes at a time with AVX2 or SSE2. The hash is
+ * seeded, so a key is only valid for the map it was built with, which is
+ * initialized if needed, or maps sharing its seed. As with
+ * HASHMAP_DECLARE_STRING(), the map stores the pointers, not the bytes.
+ *
+ * HASHMAP_DECLARE_EQUAL() and HASHMAP_DEFINE_EQUAL() take six arguments: the
+ * struct name, the function prefix, the key type, the value type, an
+ * optional seeded hash function (NULL to hash the key's bytes), and the name
+ * of a function-like macro EQUAL(key1, key2) that is true when two keys are
+ * equal. It is expanded into the generated comparison function, so a chain
+ * walk compares keys without any call. HASHMAP_EQUAL_SCALAR compares with
+ * ==, for integer, enum and pointer keys. For structs, whose padding bytes
+ * memcmp would compare, pass a macro comparing their fields, such as
+ * #define POINT_EQUAL(a, b) ((a).x == (b).x && (a).y == (b).y), with a hash
+ * function over the same fields. A NULL hash function hashes every byte of
+ * the key, padding included, so keys equal under EQUAL may land in different
+ * buckets and never be found. Pass NULL only for keys without padding, or
+ * whose padding is always zeroed, e.g. with memset() before setting fields.
  *
  * Note that with HASHMAP_DECLARE() and HASHMAP_DEFINE() by default, the key
  * value itself is compared and hashed. For instance, if the key is a char * and
@@ -49,7 +106,53 @@
  * This library uses separate chaining with linked lists for collision
  * resolution.
  *
- * Load factor is set at 0.75, with capacity growing by powers of 2.
+ * Capacity grows once size / capacity exceeds the map's max_load_factor
+ * (default 0.75), multiplied by its growth_factor (default 2). It shrinks
+ * by the same factor once size / capacity falls below min_load_factor
+ * (default 0, never). These fields are set by hashmap_init(), and may be
+ * changed afterwards. growth_factor must be a power of 2, and
+ * min_load_factor * growth_factor must stay below max_load_factor.
+ *
+ * Alternative engines generate the same API (init, grow, insert, remove, get,
+ * has, size, free, iterate, duplicate, clear) from the same six arguments, so
+ * a map can switch engine by changing which macro pair generates it. Their
+ * maps also hold a seed picked by hashmap_init() and copied by
+ * hashmap_duplicate(), mixed into the default hash of the key's bytes. A hash
+ * function passed to them ignores it, and keys chosen to collide under that
+ * function collide in every map:
+ *
+ * - HASHMAP_DECLARE_ROBINHOOD() and HASHMAP_DEFINE_ROBINHOOD(): open
+ *   addressing over a flat slot array with Robin Hood displacement and
+ *   backward shift deletion. No per-entry allocation, and lookups scan
+ *   contiguous memory. Load factor is set at 0.9. The struct holds slots
+ *   instead of buckets and has no buckets_filled field.
+ *
+ * - HASHMAP_DECLARE_SWISS() and HASHMAP_DEFINE_SWISS(): SwissTable-style open
+ *   addressing. Slots are grouped by 16, each with a control byte holding a
+ *   7-bit hash fingerprint, so a lookup tests a whole group with one SSE2
+ *   compare (or portable SWAR code) before comparing any key. Load factor is
+ *   set at 0.875, and capacity is at least 16. The struct holds slots, ctrl
+ *   and a count of deleted slots instead of buckets and buckets_filled.
+ *
+ * - HASHMAP_DECLARE_CUCKOO() and HASHMAP_DEFINE_CUCKOO(): bucketized cuckoo
+ *   hashing. Buckets hold 4 entries, and a key lives in one of two buckets
+ *   derived from its hash, so a lookup reads at most two buckets. Inserting
+ *   into two full buckets evicts entries to their other bucket, at most 128
+ *   times. An entry still left out goes to a stash of 8 entries scanned by
+ *   lookups, and the table grows once the stash is full. Keys sharing a hash
+ *   that no capacity tells apart panic instead of growing it without bound.
+ *   Load factor is set at 0.9. The capacity field counts buckets, not
+ *   entries, there is no buckets_filled field, and the struct also holds
+ *   stash and stash_size.
+ *
+ * - HASHMAP_DECLARE_HOPSCOTCH() and HASHMAP_DEFINE_HOPSCOTCH(): hopscotch
+ *   hashing. Every key lives within 31 slots of its home slot, and each home
+ *   slot keeps a 32-bit hop word with a bitmap of where its keys are and a
+ *   flag of its own occupancy, so a lookup only compares the keys flagged in
+ *   one bitmap. Keys finding no slot go to a stash of 8 entries, growing the
+ *   table once it is full, as with the cuckoo engine. Load factor is set at
+ *   0.9, and capacity is at least 32. The struct holds slots instead of
+ *   buckets, stash and stash_size, and has no buckets_filled field.
  *
  * To configure this library #define the symbols before including the library.
  * This is usually done in the header file where HASHMAP_DECLARE() is called.
@@ -65,6 +168,42 @@
  * - HASHMAP_FREE (default free(3)): specify the deallocator. If using a
  *   custom deallocator, must also specify HASHMAP_REALLOC.
  *
+ * - HASHMAP_INCREMENTAL_REHASH (default 0): if non-zero, growing the default
+ *   engine keeps the old bucket array next to the new one instead of moving
+ *   every entry at once. Each insert and remove then migrates this many old
+ *   buckets, bounding the cost of any single operation. Get, remove and
+ *   iterate look into both arrays until the migration is done. The load
+ *   factor is not checked while migrating.
+ *
+ * - HASHMAP_SLAB_SIZE (default 0): if non-zero, the default engine carves
+ *   chain nodes from slabs of this many nodes instead of allocating them one
+ *   by one. Removed nodes go to a per-map free list for reuse, and slabs are
+ *   only released by hashmap_clear() and hashmap_free(), in one call per slab.
+ *
+ * - HASHMAP_CACHE_HASH (default 0): if true (1), chain nodes of the default
+ *   engine store the full hash of their key. Chain walks then only call the
+ *   comparison function on nodes with an equal hash, and growing or
+ *   shrinking never calls the hash function. Costs one unsigned long per
+ *   node. Must be defined before including the library.
+ *
+ * - HASHMAP_SEED_SOURCE(map) (default mixes time(), clock() and the address
+ *   of map): expression giving the entropy hashmap_init() picks the seed of
+ *   map from. The default is cheap but guessable without address space
+ *   layout randomization, define it to a call to getrandom(2), arc4random(3)
+ *   or the like where keys come from untrusted input. A constant makes
+ *   hashes reproducible, and 0 makes seeded hashes equal unseeded ones.
+ *
+ * - HASHMAP_NO_SSE2 (default undefined): if defined, the SwissTable engine
+ *   probes groups with portable SWAR code even where SSE2 is available, and
+ *   HASHMAP_DECLARE_STRING_KEY() maps compare bytes with memcmp() instead of
+ *   SSE2 or AVX2. Must be defined before including the library.
+ *
+ * - HASHMAP_INLINE (default inline in C99, __inline__ with GCC or Clang,
+ *   __inline with MSVC, empty otherwise): marks the functions calling the
+ *   hash and comparison functions of a map, so that the calls are inlined
+ *   into lookups. Define it empty to keep them out of line. Must be defined
+ *   before including the library.
+ *
  * - HASHMAP_LONG_JUMP_NO_ABORT (default undefined): for testing only. Jump to
  *   externally defined "jmp_buf abort_jmp" instead of panicking. Unlike other
  *   configuration options, must be defined before including the library.
@@ -73,7 +212,7 @@
  * API Functions:
  *
  * The following documentation takes this generated hashmap for instance:
- * HASHMAP_DECLARE(Hashmap, hashmap, const char *, int, fnv1a_32_str, strcmp)
+ * HASHMAP_DECLARE(Hashmap, hashmap, const char *, int, hash_str, strcmp)
  *
  * All functions panic if map is NULL (unless HASHMAP_NO_PANIC_ON_NULL).
  *
@@ -81,26 +220,99 @@
  *   Initialize empty hashmap with default capacity. Leaks memory if initializes
  *   an already initialized hashmap.
  *
+ * void hashmap_init_seeded(Hashmap *map, unsigned long seed)
+ *   Same, with seed as the seed of map instead of one picked from
+ *   HASHMAP_SEED_SOURCE, so that map shares the hashes of another map.
+ *
  * void hashmap_free(Hashmap *map)
  *   Deallocate hashmap memory. Safe to call on already-freed hashmaps.
  *
  * void hashmap_grow(Hashmap *map)
- *   Increase capacity to next power of 2. Auto-initializes empty hashmaps.
- *   No-op if growth would cause overflow.
+ *   Multiply capacity by growth_factor. Auto-initializes empty hashmaps.
+ *   No-op if growth would cause overflow. With HASHMAP_INCREMENTAL_REHASH,
+ *   completes any pending migration, then starts a new one.
+ *
+ * void hashmap_reserve(Hashmap *map, size_t count)
+ *   Grow capacity to the smallest power of 2 holding count elements within
+ *   max_load_factor, so that inserting up to count elements never grows.
+ *   All nodes are relinked at once, even with HASHMAP_INCREMENTAL_REHASH.
+ *   No-op if capacity is already large enough, or up to the largest
+ *   capacity that does not overflow. Auto-initializes empty hashmaps.
+ *
+ * void hashmap_shrink_to_fit(Hashmap *map)
+ *   Shrink capacity to the smallest power of 2, at least the default
+ *   capacity, holding the current elements within max_load_factor. Nodes are
+ *   relinked, never reallocated. Keeps the current capacity if allocating
+ *   the smaller bucket array fails. No-op on uninitialized hashmaps.
  *
  * int hashmap_insert(Hashmap *map, const char *key, int value)
  *   Insert or update key-value pair. Auto-initializes empty hashmaps.
- *   Grows capacity if load factor exceeds 0.75. Returns 1 if key existed
- *   and value was overwritten, 0 if new key was inserted.
+ *   Grows capacity if load factor exceeds max_load_factor. Returns 1 if key
+ *   existed and value was overwritten, 0 if new key was inserted.
+ *
+ * void hashmap_insert_unique(Hashmap *map, const char *key, int value)
+ *   Insert a key known to be missing from the hashmap, pushing it at the
+ *   head of its chain without comparing any key, e.g. for bulk loading
+ *   deduplicated data. Inserting an existing key this way is undefined
+ *   behavior, which assert() catches in debug builds. Grows and
+ *   auto-initializes like hashmap_insert().
+ *
+ * void hashmap_build_from_arrays(Hashmap *map, const char *const *keys,
+ *                                const int *values, size_t count)
+ *   Insert count key-value pairs from two parallel arrays, as hashmap_insert()
+ *   would one by one: a key appearing twice keeps its last value. Capacity is
+ *   reserved once, every key hashed in one pass, then sorted by bucket
+ *   (counting sort) so that nodes are allocated chain after chain, and with
+ *   HASHMAP_SLAB_SIZE laid out contiguously. Temporarily allocates two
+ *   arrays of count elements and one of capacity + 1. Auto-initializes empty
+ *   hashmaps.
+ *
+ * int *hashmap_get_or_insert(Hashmap *map, const char *key, int default_value,
+ *                            int *inserted)
+ *   Return a pointer to the value of key, inserting default_value first if
+ *   key is missing, with a single hash and chain walk. If inserted is
+ *   non-NULL, stores 1 if key was inserted, 0 if it existed. The pointer
+ *   follows the rules of hashmap_get_ptr(). Auto-initializes empty hashmaps.
+ *
+ * int hashmap_upsert(Hashmap *map, const char *key,
+ *                    void (*callback)(const char *key, int *value, int existed,
+ *                                     void *context),
+ *                    void *context)
+ *   Call callback once on the value of key, with a single hash and chain walk.
+ *   If key is missing, it is first inserted with a zero-filled value and
+ *   existed is 0, so the callback can tell initializing from merging. The
+ *   callback must not modify the hashmap. Returns 1 if key existed, 0 if it
+ *   was inserted. Panics if callback is NULL (unless
+ *   HASHMAP_NO_PANIC_ON_NULL). Auto-initializes empty hashmaps.
  *
  * int hashmap_remove(Hashmap *map, const char *key, int *out)
  *   Remove key-value pair. If out is non-NULL, stores removed value.
+ *   Divides capacity by growth_factor (halves it by default) if load factor
+ *   falls below min_load_factor, which never happens unless it is set.
  *   Returns 1 if key was found and removed, 0 otherwise.
  *
  * int hashmap_get(const Hashmap *map, const char *key, int *out)
  *   Get value for key. If out is non-NULL, stores value.
  *   Returns 1 if key found, 0 otherwise.
  *
+ * size_t hashmap_get_many(const Hashmap *map, const char *const *keys,
+ *                         size_t count, int *out_values, int *out_found)
+ *   Get the values of count keys at once. Keys are hashed and their buckets
+ *   and first nodes prefetched 16 at a time before any chain is walked, so
+ *   the cache misses of a batch overlap instead of adding up. If out_values
+ *   is non-NULL, stores the value of each found key at the same index, and
+ *   leaves the others untouched. If out_found is non-NULL, stores 1 for
+ *   found keys and 0 for the others. Returns the number of keys found.
+ *
+ * int *hashmap_get_ptr(Hashmap *map, const char *key)
+ *   Return a pointer to the value stored for key, NULL if not found, to read
+ *   or update it in place without a second lookup. Nodes never move, so the
+ *   pointer stays valid across inserts, hashmap_grow(), hashmap_reserve()
+ *   and shrinking, in every configuration. It is invalidated by removing
+ *   this key (its node may then be reused with HASHMAP_SLAB_SIZE), and by
+ *   hashmap_clear() and hashmap_free(). Alternative engines move entries
+ *   and do not provide it.
+ *
  * int hashmap_has(const Hashmap *map, const char *key)
  *   Check if key exists in hashmap. Returns 1 if found, 0 otherwise.
  *
@@ -113,13 +325,72 @@
  *   Callback should return 1 to continue iteration, 0 to stop.
  *   No-op if iteration_callback is NULL.
  *
+ * void hashmap_iter_begin(Hashmap *map, HashmapIter *iter)
+ *   Start iterating over map with an external iterator, in the same order
+ *   as hashmap_iterate(). Unlike it, no callback is involved, iteration can
+ *   stop and resume at will, and several maps can be walked in lockstep.
+ *   Inserting or removing through other functions invalidates iterators,
+ *   and so does growing, shrinking or clearing. Uninitialized hashmaps
+ *   have no elements.
+ *
+ * int hashmap_iter_next(HashmapIter *iter, const char *const **key,
+ *                       int **value)
+ *   Advance iter to the next element. Returns 1 and, if key and value are
+ *   non-NULL, stores pointers to the element's key and value, which may be
+ *   modified in place. Returns 0 once every element was visited.
+ *
+ * int hashmap_iter_remove(HashmapIter *iter)
+ *   Remove the element last returned by hashmap_iter_next(), without
+ *   looking it up again. Iteration then continues with the next element.
+ *   Its key and value pointers are invalidated. Never shrinks the hashmap.
+ *   Returns 1 if removed, 0 if there is no current element.
+ *
  * void hashmap_duplicate(Hashmap *dest, const Hashmap *src)
  *   Copy src hashmap to dest. dest must be uninitialized. Overwrites existing
  *   dest data without freeing it.
  *
  * void hashmap_clear(Hashmap *map)
  *   Remove all elements without deallocating capacity. Safe to call on
- *   uninitialized hashmaps.
+ *   uninitialized hashmaps. Call hashmap_shrink_to_fit() afterwards to
+ *   release the bucket array down to the default capacity.
+ *
+ * unsigned long hashmap_hash(const Hashmap *map, const char *key)
+ *   Return the full hash of key, as computed by the hash function the
+ *   hashmap was generated with and the seed of map. It does not depend on
+ *   the capacity, so it stays valid across grows, and for every hashmap
+ *   generated with the same hash function holding the same seed field.
+ *   hashmap_init() picks the seed, so map must be initialized first.
+ *   hashmap_duplicate() copies the seed. To share it with a new map, pass it
+ *   to hashmap_init_seeded(): assigning the seed field of a map before it is
+ *   initialized does nothing, since the first insert initializes the map
+ *   and picks a new seed.
+ *
+ * unsigned long hashmap_hash_buf(const void *buf, size_t len)
+ * unsigned long hashmap_hash_str(const char *str)
+ *   Default hash functions, over len bytes of buf or over the characters of
+ *   str. They read a word at a time (8 bytes where unsigned long has 64 bits,
+ *   4 otherwise) and return a full unsigned long, so short strings cost a
+ *   few multiplies instead of one per byte. hashmap_hash_str(str) equals
+ *   hashmap_hash_buf(str, strlen(str)). The former hashmap_fnv1a_32_buf()
+ *   and hashmap_fnv1a_32_str() are still generated.
+ *
+ * unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+ *                                       unsigned long seed)
+ * unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+ *   Same with a seed, mixed into every word, for seeded hash functions.
+ *   Seed 0 gives the same hashes as hashmap_hash_buf() and
+ *   hashmap_hash_str().
+ *
+ * int hashmap_insert_hashed(Hashmap *map, const char *key, unsigned long hash,
+ *                           int value)
+ * int hashmap_get_hashed(const Hashmap *map, const char *key,
+ *                        unsigned long hash, int *out)
+ * int hashmap_remove_hashed(Hashmap *map, const char *key, unsigned long hash,
+ *                           int *out)
+ *   Same as hashmap_insert(), hashmap_get() and hashmap_remove(), with the
+ *   hash of key computed beforehand by hashmap_hash(), so that a key is
+ *   hashed only once for several operations or hashmaps. Passing any other
+ *   hash is undefined behavior, which assert() catches in debug builds.
  *
  *
  * Example:
@@ -163,6 +434,42 @@
 #define HASHMAP_NO_PANIC_ON_NULL 0
 #endif
 
+#ifndef HASHMAP_INCREMENTAL_REHASH
+#define HASHMAP_INCREMENTAL_REHASH 0
+#endif
+
+#ifndef HASHMAP_SLAB_SIZE
+#define HASHMAP_SLAB_SIZE 0
+#endif
+
+#ifndef HASHMAP_CACHE_HASH
+#define HASHMAP_CACHE_HASH 0
+#endif
+
+/* Access to the hash cached in chain nodes, or the hash recomputed with
+ * hash_func and the seed of map when nodes do not cache it */
+#if HASHMAP_CACHE_HASH
+#define HASHMAP_NODE_HASH_FIELD unsigned long hash;
+#define HASHMAP_NODE_SET_HASH(node, hash_) ((node)->hash = (hash_))
+#define HASHMAP_NODE_HASH(node, hash_func, map) ((void)(map), (node)->hash)
+#define HASHMAP_NODE_HASH_DIFFERS(node, hash_) ((node)->hash != (hash_))
+#else
+#define HASHMAP_NODE_HASH_FIELD
+#define HASHMAP_NODE_SET_HASH(node, hash_) ((void)(hash_))
+#define HASHMAP_NODE_HASH(node, hash_func, map) (hash_func((map), (node)->key))
+#define HASHMAP_NODE_HASH_DIFFERS(node, hash_) ((void)(hash_), 0)
+#endif
+
+/* Default entropy for the seed of each map: the time, the processor time and
+ * the map address, which differs from run to run with address space layout
+ * randomization */
+#ifndef HASHMAP_SEED_SOURCE
+#include <time.h>
+#define HASHMAP_SEED_SOURCE(map)                                    \
+	((unsigned long)time(NULL) ^ (unsigned long)clock() << 16 ^ \
+	 (unsigned long)(size_t)(const void *)(map))
+#endif
+
 #ifdef HASHMAP_LONG_JUMP_NO_ABORT
 #include <setjmp.h>
 extern jmp_buf abort_jmp;
@@ -178,6 +485,103 @@ extern jmp_buf abort_jmp;
 #define HASHMAP_NORETURN
 #endif
 
+#ifndef HASHMAP_INLINE
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define HASHMAP_INLINE inline
+#elif defined(__GNUC__) || defined(__clang__)
+#define HASHMAP_INLINE __inline__
+#elif defined(_MSC_VER)
+#define HASHMAP_INLINE __inline
+#else
+#define HASHMAP_INLINE
+#endif
+#endif /* HASHMAP_INLINE */
+
+#if !defined(HASHMAP_NO_SSE2) &&                                      \
+	(defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+	 (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define HASHMAP_SSE2 1
+#define HASHMAP_SSE2_MATCH(group, byte)                                        \
+	((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(                       \
+		_mm_loadu_si128((const __m128i *)(const void *)(group)),       \
+		_mm_set1_epi8((char)(byte)))))
+#define HASHMAP_SSE2_MATCH_HIGH(group)   \
+	((unsigned int)_mm_movemask_epi8( \
+		_mm_loadu_si128((const __m128i *)(const void *)(group))))
+#else
+#define HASHMAP_SSE2 0
+#define HASHMAP_SSE2_MATCH(group, byte) 0U
+#define HASHMAP_SSE2_MATCH_HIGH(group) 0U
+#endif
+
+/* Equality of HASHMAP_KEY_BLOCK bytes at a and b, for long string keys: one
+ * AVX2 or SSE2 compare, or memcmp() */
+#if defined(__AVX2__) && !defined(HASHMAP_NO_SSE2)
+#include <immintrin.h>
+#define HASHMAP_KEY_BLOCK 32
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b)                                      \
+	(_mm256_movemask_epi8(_mm256_cmpeq_epi8(                           \
+		 _mm256_loadu_si256((const __m256i *)(const void *)(a)),   \
+		 _mm256_loadu_si256((const __m256i *)(const void *)(b)))) == \
+	 -1)
+#elif HASHMAP_SSE2
+#define HASHMAP_KEY_BLOCK 16
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b)                                    \
+	(_mm_movemask_epi8(_mm_cmpeq_epi8(                               \
+		 _mm_loadu_si128((const __m128i *)(const void *)(a)),     \
+		 _mm_loadu_si128((const __m128i *)(const void *)(b)))) == \
+	 0xFFFF)
+#else
+#define HASHMAP_KEY_BLOCK 16
+#define HASHMAP_KEY_BLOCK_EQUAL(a, b) (memcmp((a), (b), HASHMAP_KEY_BLOCK) == 0)
+#endif
+
+/* Start loading the cache line at addr, or nothing where unsupported */
+#if defined(__GNUC__) || defined(__clang__)
+#define HASHMAP_PREFETCH(addr) (__builtin_prefetch((const void *)(addr)))
+#elif HASHMAP_SSE2
+#define HASHMAP_PREFETCH(addr) \
+	(_mm_prefetch((const char *)(const void *)(addr), _MM_HINT_T0))
+#else
+#define HASHMAP_PREFETCH(addr) ((void)(addr))
+#endif
+
+/* Word-at-a-time default hash, see hashmap_hash_buf(). Uses 64-bit words and
+ * output where unsigned long has 64 bits, otherwise MurmurHash3_x86_32 on
+ * 32-bit words. Words are read little-endian so that hashes do not depend on
+ * the platform's byte order. HASHMAP_HASH_FMIX, the MurmurHash3 finalizer,
+ * also hashes integer keys. */
+#define HASHMAP_HASH_ROTL(x, r, bits) (((x) << (r)) | ((x) >> ((bits) - (r))))
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define HASHMAP_HASH_WORD_SIZE 8
+#define HASHMAP_HASH_LOAD(p)                                                  \
+	((unsigned long)(p)[0] | (unsigned long)(p)[1] << 8 |                 \
+	 (unsigned long)(p)[2] << 16 | (unsigned long)(p)[3] << 24 |          \
+	 (unsigned long)(p)[4] << 32 | (unsigned long)(p)[5] << 40 |          \
+	 (unsigned long)(p)[6] << 48 | (unsigned long)(p)[7] << 56)
+#define HASHMAP_HASH_MIX(k)                                                    \
+	(HASHMAP_HASH_ROTL((k) * 0x87C37B91114253D5UL, 31, 64) *               \
+	 0x4CF5AD432745937FUL)
+#define HASHMAP_HASH_STEP(h) \
+	(HASHMAP_HASH_ROTL((h), 27, 64) * 5 + 0x52DCE729UL)
+#define HASHMAP_HASH_FMIX(h)                                           \
+	((h) ^= (h) >> 33, (h) *= 0xFF51AFD7ED558CCDUL, (h) ^= (h) >> 33, \
+	 (h) *= 0xC4CEB9FE1A85EC53UL, (h) ^= (h) >> 33)
+#else
+#define HASHMAP_HASH_WORD_SIZE 4
+#define HASHMAP_HASH_LOAD(p)                                  \
+	((unsigned long)(p)[0] | (unsigned long)(p)[1] << 8 | \
+	 (unsigned long)(p)[2] << 16 | (unsigned long)(p)[3] << 24)
+#define HASHMAP_HASH_MIX(k) \
+	(HASHMAP_HASH_ROTL((k) * 0xCC9E2D51UL, 15, 32) * 0x1B873593UL)
+#define HASHMAP_HASH_STEP(h) \
+	(HASHMAP_HASH_ROTL((h), 13, 32) * 5 + 0xE6546B64UL)
+#define HASHMAP_HASH_FMIX(h)                                      \
+	((h) ^= (h) >> 16, (h) *= 0x85EBCA6BUL, (h) ^= (h) >> 13, \
+	 (h) *= 0xC2B2AE35UL, (h) ^= (h) >> 16)
+#endif
+
 #ifndef __STDC_VERSION__
 #define RESTRICT
 #else
@@ -188,27 +592,297 @@ extern jmp_buf abort_jmp;
 #define HASH_CALLBACK NULL
 #endif /* HASH_CALLBACK */
 
+#ifndef SEEDED_HASH_CALLBACK
+#define SEEDED_HASH_CALLBACK NULL
+#endif /* SEEDED_HASH_CALLBACK */
+
 #ifndef COMPARISON_CALLBACK
 #define COMPARISON_CALLBACK NULL
 #endif /* COMPARISON_CALLBACK */
 
 #define HASHMAP_LOAD_FACTOR 0.75f
-enum { HASHMAP_DEFAULT_CAPACITY = 8, HASHMAP_GROWTH_FACTOR = 2 };
+#define HASHMAP_MIN_LOAD_FACTOR 0.0f
+#define HASHMAP_ROBINHOOD_LOAD_FACTOR 0.9f
+#define HASHMAP_SWISS_LOAD_FACTOR 0.875f
+#define HASHMAP_CUCKOO_LOAD_FACTOR 0.9f
+#define HASHMAP_HOPSCOTCH_LOAD_FACTOR 0.9f
+enum {
+	HASHMAP_DEFAULT_CAPACITY = 8,
+	HASHMAP_GROWTH_FACTOR = 2,
+	HASHMAP_SWISS_GROUP_SIZE = 16,
+	HASHMAP_CUCKOO_BUCKET_SIZE = 4,
+	HASHMAP_CUCKOO_MAX_KICKS = 128,
+	HASHMAP_CUCKOO_STASH_SIZE = 8,
+	HASHMAP_HOPSCOTCH_NEIGHBORHOOD = 31,
+	HASHMAP_HOPSCOTCH_STASH_SIZE = 8,
+	HASHMAP_PREFETCH_BATCH = 16,
+	HASHMAP_STASH_MAX_SPREAD = 64
+};
+enum { HASHMAP_SWISS_EMPTY = 0x80, HASHMAP_SWISS_DELETED = 0xFE };
+
+/* Hop word of a hopscotch slot: the neighborhood bitmap, then the flag of an
+ * occupied slot. 32 bits keep a slot with a pointer key and an int value at
+ * 16 bytes on 64-bit targets. */
+#if UINT_MAX >= 0xFFFFFFFFUL
+#define HASHMAP_HOP unsigned int
+#else
+#define HASHMAP_HOP unsigned long
+#endif
+#define HASHMAP_HOPSCOTCH_OCCUPIED \
+	((HASHMAP_HOP)1 << HASHMAP_HOPSCOTCH_NEIGHBORHOOD)
 
 typedef int CustomValue;
 typedef const char *CustomKey;
 
+#define HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			Custom_Value_Type_, Custom_Hash_Func_,             \
+			Custom_Comparison_Func_)                           \
+	HASHMAP_DECLARE_IMPL(Struct_Name_, Functions_Prefix_,              \
+			     Custom_Key_Type_, Custom_Value_Type_,         \
+			     Custom_Hash_Func_, NULL, Custom_Comparison_Func_)
+
+#define HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_,      \
+		       Custom_Value_Type_, Custom_Hash_Func_,                  \
+		       Custom_Comparison_Func_)                                \
+	HASHMAP_DEFINE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			    Custom_Value_Type_, Custom_Hash_Func_, NULL,       \
+			    Custom_Comparison_Func_)
+
+#define HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,          \
+			       Custom_Key_Type_, Custom_Value_Type_,     \
+			       Custom_Seeded_Hash_Func_,                 \
+			       Custom_Comparison_Func_)                  \
+	HASHMAP_DECLARE_IMPL(Struct_Name_, Functions_Prefix_,            \
+			     Custom_Key_Type_, Custom_Value_Type_, NULL, \
+			     Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)
+
+#define HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Custom_Key_Type_, Custom_Value_Type_,            \
+			      Custom_Seeded_Hash_Func_,                        \
+			      Custom_Comparison_Func_)                         \
+	HASHMAP_DEFINE_IMPL(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			    Custom_Value_Type_, NULL,                          \
+			    Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)
+
 #define HASHMAP_DECLARE_STRING(Struct_Name_, Functions_Prefix_,               \
 			       Custom_Value_Type_)                            \
-	HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, const char *,        \
-			Custom_Value_Type_, Functions_Prefix_##_fnv1a_32_str, \
-			strcmp)
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_, const char *, \
+			       Custom_Value_Type_,                            \
+			       Functions_Prefix_##_hash_str_seeded, strcmp)
 
 #define HASHMAP_DEFINE_STRING(Struct_Name_, Functions_Prefix_,               \
 			      Custom_Value_Type_)                            \
-	HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, const char *,        \
-		       Custom_Value_Type_, Functions_Prefix_##_fnv1a_32_str, \
-		       strcmp)
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_, const char *, \
+			      Custom_Value_Type_,                            \
+			      Functions_Prefix_##_hash_str_seeded, strcmp)
+
+#define HASHMAP_DECLARE_STRING_VIEW(Struct_Name_, Functions_Prefix_,           \
+				    Custom_Value_Type_)                        \
+	typedef struct Struct_Name_##StringView {                              \
+		const char *ptr;                                               \
+		size_t len;                                                    \
+	} Struct_Name_##StringView;                                            \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			       Struct_Name_##StringView, Custom_Value_Type_,   \
+			       Functions_Prefix_##_string_view_hash,           \
+			       Functions_Prefix_##_string_view_compare)        \
+	Struct_Name_##StringView Functions_Prefix_##_string_view(              \
+		const char *ptr, size_t len);                                  \
+	unsigned long Functions_Prefix_##_string_view_hash(                    \
+		Struct_Name_##StringView key, unsigned long seed);             \
+	int Functions_Prefix_##_string_view_compare(                           \
+		Struct_Name_##StringView key1, Struct_Name_##StringView key2);
+
+#define HASHMAP_DEFINE_STRING_VIEW(Struct_Name_, Functions_Prefix_,            \
+				   Custom_Value_Type_)                         \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Struct_Name_##StringView, Custom_Value_Type_,    \
+			      Functions_Prefix_##_string_view_hash,            \
+			      Functions_Prefix_##_string_view_compare)         \
+	Struct_Name_##StringView Functions_Prefix_##_string_view(              \
+		const char *ptr, size_t len)                                   \
+	{                                                                      \
+		Struct_Name_##StringView ret;                                  \
+		ret.ptr = ptr;                                                 \
+		ret.len = len;                                                 \
+		return ret;                                                    \
+	}                                                                      \
+	unsigned long Functions_Prefix_##_string_view_hash(                    \
+		Struct_Name_##StringView key, unsigned long seed)              \
+	{                                                                      \
+		return Functions_Prefix_##_hash_buf_seeded(key.ptr, key.len,   \
+							   seed);              \
+	}                                                                      \
+	int Functions_Prefix_##_string_view_compare(                           \
+		Struct_Name_##StringView key1, Struct_Name_##StringView key2)  \
+	{                                                                      \
+		if (key1.len != key2.len) {                                    \
+			return key1.len < key2.len ? -1 : 1;                   \
+		}                                                              \
+		if (key1.len == 0) {                                           \
+			return 0;                                              \
+		}                                                              \
+		return memcmp(key1.ptr, key2.ptr, key1.len);                   \
+	}
+
+#define HASHMAP_DECLARE_INT(Struct_Name_, Functions_Prefix_,                \
+			    Custom_Key_Type_, Custom_Value_Type_)           \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,             \
+			       Custom_Key_Type_, Custom_Value_Type_,        \
+			       Functions_Prefix_##_hash_int,                \
+			       Functions_Prefix_##_compare_int)             \
+	unsigned long Functions_Prefix_##_hash_int(Custom_Key_Type_ key,    \
+						   unsigned long seed);     \
+	int Functions_Prefix_##_compare_int(Custom_Key_Type_ key1,          \
+					    Custom_Key_Type_ key2);
+
+#define HASHMAP_DEFINE_INT(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, \
+			   Custom_Value_Type_)                                \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			      Custom_Key_Type_, Custom_Value_Type_,           \
+			      Functions_Prefix_##_hash_int,                   \
+			      Functions_Prefix_##_compare_int)                \
+	unsigned long Functions_Prefix_##_hash_int(Custom_Key_Type_ key,      \
+						   unsigned long seed)        \
+	{                                                                     \
+		unsigned long word = (unsigned long)key;                      \
+		size_t half = HASHMAP_HASH_WORD_SIZE * CHAR_BIT / 2;          \
+		if (sizeof(Custom_Key_Type_) > sizeof(unsigned long)) {       \
+			/* Fold bits that do not fit, such as 64-bit keys     \
+			 * where long has 32 bits. Never shifts narrower      \
+			 * keys by their width. */                            \
+			word ^= (unsigned long)(key >> half >> half);         \
+		}                                                             \
+		/* Xorshift-multiply finalizer over the whole word, so that   \
+		 * the low bits bucket indexes are masked from depend on      \
+		 * every key bit */                                           \
+		word ^= seed;                                                 \
+		HASHMAP_HASH_FMIX(word);                                      \
+		return word;                                                  \
+	}                                                                     \
+	int Functions_Prefix_##_compare_int(Custom_Key_Type_ key1,            \
+					    Custom_Key_Type_ key2)            \
+	{                                                                     \
+		return key1 != key2;                                          \
+	}
+
+#define HASHMAP_DECLARE_STRING_KEY(Struct_Name_, Functions_Prefix_,            \
+				   Custom_Value_Type_)                         \
+	typedef struct Struct_Name_##StringKey {                               \
+		const char *ptr;                                               \
+		size_t len;                                                    \
+		unsigned long hash;                                            \
+	} Struct_Name_##StringKey;                                             \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,                \
+			       Struct_Name_##StringKey, Custom_Value_Type_,    \
+			       Functions_Prefix_##_string_key_hash,            \
+			       Functions_Prefix_##_string_key_compare)         \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key(                \
+		Struct_Name_ *map, const char *str);                           \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key_len(            \
+		Struct_Name_ *map, const char *ptr, size_t len);               \
+	unsigned long Functions_Prefix_##_string_key_hash(                     \
+		Struct_Name_##StringKey key, unsigned long seed);              \
+	int Functions_Prefix_##_string_key_compare(                            \
+		Struct_Name_##StringKey key1, Struct_Name_##StringKey key2);   \
+	int Functions_Prefix_##_bytes_equal(const char *ptr1,                  \
+					    const char *ptr2, size_t len);
+
+#define HASHMAP_DEFINE_STRING_KEY(Struct_Name_, Functions_Prefix_,             \
+				  Custom_Value_Type_)                          \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,                 \
+			      Struct_Name_##StringKey, Custom_Value_Type_,     \
+			      Functions_Prefix_##_string_key_hash,             \
+			      Functions_Prefix_##_string_key_compare)          \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key(                \
+		Struct_Name_ *map, const char *str)                            \
+	{                                                                      \
+		return Functions_Prefix_##_string_key_len(map, str,            \
+							  strlen(str));        \
+	}                                                                      \
+	Struct_Name_##StringKey Functions_Prefix_##_string_key_len(            \
+		Struct_Name_ *map, const char *ptr, size_t len)                \
+	{                                                                      \
+		Struct_Name_##StringKey ret;                                   \
+		/* The hash depends on the seed hashmap_init() picks */        \
+		if (map != NULL && map->buckets == NULL) {                     \
+			Functions_Prefix_##_init(map);                         \
+		}                                                              \
+		ret.ptr = ptr;                                                 \
+		ret.len = len;                                                 \
+		ret.hash = Functions_Prefix_##_hash_buf_seeded(                \
+			ptr, len, map != NULL ? map->seed : 0);                \
+		return ret;                                                    \
+	}                                                                      \
+	unsigned long Functions_Prefix_##_string_key_hash(                     \
+		Struct_Name_##StringKey key, unsigned long seed)               \
+	{                                                                      \
+		/* Debug test for a key made for a map with another seed */    \
+		assert(key.hash ==                                             \
+		       Functions_Prefix_##_hash_buf_seeded(key.ptr, key.len,   \
+							   seed));             \
+		(void)seed;                                                    \
+		return key.hash;                                               \
+	}                                                                      \
+	int Functions_Prefix_##_string_key_compare(                            \
+		Struct_Name_##StringKey key1, Struct_Name_##StringKey key2)    \
+	{                                                                      \
+		/* Most different keys differ by hash or length */             \
+		if (key1.hash != key2.hash || key1.len != key2.len) {          \
+			return 1;                                              \
+		}                                                              \
+		return !Functions_Prefix_##_bytes_equal(key1.ptr, key2.ptr,    \
+							key1.len);             \
+	}                                                                      \
+	int Functions_Prefix_##_bytes_equal(const char *ptr1,                  \
+					    const char *ptr2, size_t len)      \
+	{                                                                      \
+		size_t pos = 0;                                                \
+		if (len < HASHMAP_KEY_BLOCK) {                                 \
+			return len == 0 || memcmp(ptr1, ptr2, len) == 0;       \
+		}                                                              \
+		for (; pos + HASHMAP_KEY_BLOCK < len;                          \
+		     pos += HASHMAP_KEY_BLOCK) {                               \
+			if (!HASHMAP_KEY_BLOCK_EQUAL(ptr1 + pos,               \
+						     ptr2 + pos)) {            \
+				return 0;                                      \
+			}                                                      \
+		}                                                              \
+		/* Last block, overlapping the previous one if len is not a    \
+		 * multiple of the block size */                               \
+		pos = len - HASHMAP_KEY_BLOCK;                                 \
+		return HASHMAP_KEY_BLOCK_EQUAL(ptr1 + pos, ptr2 + pos);        \
+	}
+
+/* Key equality for HASHMAP_DECLARE_EQUAL(), for keys == compares by value */
+#define HASHMAP_EQUAL_SCALAR(key1, key2) ((key1) == (key2))
+
+/* With a NULL hash function, keys are hashed by their bytes, padding
+ * included: struct keys need a hash over the fields Equal_Macro_ compares,
+ * or zeroed padding */
+
+#define HASHMAP_DECLARE_EQUAL(Struct_Name_, Functions_Prefix_,               \
+			      Custom_Key_Type_, Custom_Value_Type_,          \
+			      Custom_Seeded_Hash_Func_, Equal_Macro_)        \
+	HASHMAP_DECLARE_SEEDED(Struct_Name_, Functions_Prefix_,              \
+			       Custom_Key_Type_, Custom_Value_Type_,         \
+			       Custom_Seeded_Hash_Func_,                     \
+			       Functions_Prefix_##_compare_equal)            \
+	int Functions_Prefix_##_compare_equal(Custom_Key_Type_ key1,         \
+					      Custom_Key_Type_ key2);
+
+#define HASHMAP_DEFINE_EQUAL(Struct_Name_, Functions_Prefix_,         \
+			     Custom_Key_Type_, Custom_Value_Type_,    \
+			     Custom_Seeded_Hash_Func_, Equal_Macro_)  \
+	HASHMAP_DEFINE_SEEDED(Struct_Name_, Functions_Prefix_,        \
+			      Custom_Key_Type_, Custom_Value_Type_,   \
+			      Custom_Seeded_Hash_Func_,               \
+			      Functions_Prefix_##_compare_equal)      \
+	int Functions_Prefix_##_compare_equal(Custom_Key_Type_ key1,  \
+					      Custom_Key_Type_ key2)  \
+	{                                                             \
+		return !(Equal_Macro_(key1, key2));                   \
+	}
 
 /* Declarations start here */
 
@@ -216,6 +890,19 @@ struct HashmapListNode {
 	struct HashmapListNode *next;
 	CustomKey key;
 	CustomValue value;
+	/* Full hash of key, with HASHMAP_CACHE_HASH */
+	HASHMAP_NODE_HASH_FIELD
+};
+
+/* Header of a slab, followed by HASHMAP_SLAB_SIZE nodes. The union keeps
+ * these nodes aligned. */
+union HashmapSlab {
+	struct {
+		union HashmapSlab *next;
+		/* Nodes carved so far */
+		size_t used;
+	} header;
+	struct HashmapListNode align;
 };
 
 typedef struct Hashmap {
@@ -225,48 +912,140 @@ typedef struct Hashmap {
 	size_t size;
 	size_t capacity;
 	size_t buckets_filled;
+	/* Grow when size / capacity exceeds this */
+	float max_load_factor;
+	/* Shrink when size / capacity falls below this, 0 to never shrink */
+	float min_load_factor;
+	/* Power of 2 by which capacity grows or shrinks */
+	size_t growth_factor;
+	/* Mixed into every hash, picked by hashmap_init() */
+	unsigned long seed;
+	/* Buckets not migrated yet by incremental rehashing, or NULL */
+	struct HashmapListNode **old_buckets;
+	size_t old_capacity;
+	/* Old buckets below this index are migrated */
+	size_t rehash_idx;
+	/* Slabs nodes are carved from, with HASHMAP_SLAB_SIZE */
+	union HashmapSlab *slabs;
+	/* Removed nodes waiting for reuse, with HASHMAP_SLAB_SIZE */
+	struct HashmapListNode *free_nodes;
 } Hashmap;
 
+/* External iterator, see hashmap_iter_begin() */
+typedef struct HashmapIter {
+	struct Hashmap *map;
+	/* Link to the current node: a bucket or the previous node's next
+	 * field. NULL before the first node. */
+	struct HashmapListNode **link;
+	/* Bucket of the current node */
+	size_t bucket;
+	/* Walking old buckets, not migrated yet */
+	int in_old;
+	/* Current node was removed, link already leads to the next one */
+	int removed;
+} HashmapIter;
+
 /* API functions */
 void hashmap_init(Hashmap *map);
+void hashmap_init_seeded(Hashmap *map, unsigned long seed);
 void hashmap_grow(Hashmap *map);
+void hashmap_reserve(Hashmap *map, size_t count);
+void hashmap_shrink_to_fit(Hashmap *map);
 int hashmap_insert(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_insert_hashed(Hashmap *map, CustomKey key, unsigned long hash,
+			  CustomValue value);
+void hashmap_insert_unique(Hashmap *map, CustomKey key, CustomValue value);
+void hashmap_build_from_arrays(Hashmap *RESTRICT map,
+			       CustomKey const *RESTRICT keys,
+			       CustomValue const *RESTRICT values,
+			       size_t count);
+CustomValue *hashmap_get_or_insert(Hashmap *map, CustomKey key,
+				   CustomValue default_value, int *inserted);
+int hashmap_upsert(Hashmap *map, CustomKey key,
+		   void (*callback)(CustomKey key, CustomValue *value,
+				    int existed, void *context),
+		   void *context);
 int hashmap_remove(Hashmap *RESTRICT map, CustomKey key,
 		   CustomValue *RESTRICT out);
+int hashmap_remove_hashed(Hashmap *RESTRICT map, CustomKey key,
+			  unsigned long hash, CustomValue *RESTRICT out);
 int hashmap_get(const Hashmap *RESTRICT map, CustomKey key,
 		CustomValue *RESTRICT out);
+int hashmap_get_hashed(const Hashmap *RESTRICT map, CustomKey key,
+		       unsigned long hash, CustomValue *RESTRICT out);
+size_t hashmap_get_many(const Hashmap *RESTRICT map,
+			CustomKey const *RESTRICT keys, size_t count,
+			CustomValue *RESTRICT out_values,
+			int *RESTRICT out_found);
+CustomValue *hashmap_get_ptr(Hashmap *map, CustomKey key);
 int hashmap_has(const Hashmap *map, CustomKey key);
 size_t hashmap_size(const Hashmap *map);
 void hashmap_free(Hashmap *map);
 void hashmap_iterate(Hashmap *map, void *context);
 void hashmap_duplicate(Hashmap *RESTRICT dest, Hashmap *RESTRICT src);
 void hashmap_clear(Hashmap *map);
+unsigned long hashmap_hash(const Hashmap *map, CustomKey key);
+void hashmap_iter_begin(Hashmap *RESTRICT map, HashmapIter *RESTRICT iter);
+int hashmap_iter_next(HashmapIter *RESTRICT iter,
+		      CustomKey const **RESTRICT key,
+		      CustomValue **RESTRICT value);
+int hashmap_iter_remove(HashmapIter *iter);
 
 /* Internal functions */
 void hashmap_assert(const Hashmap *map);
 void hashmap_assert_internal(const struct Hashmap *map);
-struct HashmapListNode *hashmap_list_new(struct HashmapListNode *next,
-					 CustomKey key, CustomValue value);
+struct HashmapListNode *hashmap_node_alloc(Hashmap *map);
+void hashmap_node_free(Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT node);
+void hashmap_nodes_free(Hashmap *map);
+struct HashmapListNode *hashmap_list_new(Hashmap *map,
+					 struct HashmapListNode *next,
+					 CustomKey key, unsigned long hash,
+					 CustomValue value);
 int (*hashmap_compare_comparison_callback(void))(CustomKey,
 								CustomKey);
-int hashmap_grow_internal(CustomKey key, CustomValue value, void *new_map);
 int hashmap_compare_keys(CustomKey key1, CustomKey key2);
-int hashmap_list_insert(struct HashmapListNode *head, CustomKey key,
-			CustomValue value);
-int hashmap_list_find(struct HashmapListNode *RESTRICT head, CustomKey key,
-		      CustomValue *RESTRICT out);
-int hashmap_list_remove(struct HashmapListNode **RESTRICT list, CustomKey key,
-			CustomValue *RESTRICT out);
+struct HashmapListNode *
+hashmap_list_insert(Hashmap *RESTRICT map, struct HashmapListNode *head,
+		    CustomKey key, unsigned long hash, CustomValue value,
+		    int *RESTRICT inserted);
+struct HashmapListNode *hashmap_list_find(struct HashmapListNode *head,
+					  CustomKey key, unsigned long hash);
+void hashmap_make_room(Hashmap *map);
+struct HashmapListNode *hashmap_entry(Hashmap *RESTRICT map, CustomKey key,
+				      unsigned long hash, CustomValue value,
+				      int *RESTRICT inserted);
+int hashmap_list_remove(Hashmap *RESTRICT map,
+			struct HashmapListNode **RESTRICT list, CustomKey key,
+			unsigned long hash, CustomValue *RESTRICT out);
 int hashmap_list_iterate(struct HashmapListNode *head,
 			 int (*callback)(CustomKey key, CustomValue value,
 					 void *context),
 			 void *context);
-void hashmap_list_free(struct HashmapListNode *head);
-struct HashmapListNode *hashmap_list_duplicate(struct HashmapListNode *head);
+void hashmap_list_free(Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT head);
+void hashmap_list_split(const Hashmap *map, struct HashmapListNode *head,
+			size_t bit, struct HashmapListNode **RESTRICT stay,
+			struct HashmapListNode **RESTRICT move);
+struct HashmapListNode *
+hashmap_list_duplicate(Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT head);
 unsigned long (*hashmap_compare_hash_callback(void))(CustomKey);
+unsigned long (*hashmap_compare_seeded_hash_callback(void))(CustomKey,
+							     unsigned long);
 size_t hashmap_hash_index(const Hashmap *map, CustomKey key);
+struct HashmapListNode **hashmap_bucket(const Hashmap *map,
+					unsigned long hash);
+void hashmap_rehash_step(Hashmap *map, size_t steps);
+void hashmap_expand(Hashmap *map, size_t new_capacity);
+void hashmap_shrink(Hashmap *map, size_t new_capacity);
 unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len);
 unsigned long hashmap_fnv1a_32_str(const char *str);
+unsigned long hashmap_hash_buf(const void *buf, size_t len);
+unsigned long hashmap_hash_str(const char *str);
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed);
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed);
 /* Declarations stop here */
 
 #ifdef HASHMAP_LONG_JUMP_NO_ABORT
@@ -298,6 +1077,7 @@ void hashmap_assert(const struct Hashmap *map)
 		assert(map->size == 0);
 		assert(map->buckets_filled == 0);
 		assert(map->capacity == 0);
+		assert(map->old_buckets == NULL);
 		return;
 	}
 
@@ -311,23 +1091,118 @@ void hashmap_assert_internal(const struct Hashmap *map)
 	assert(map->capacity > 0);
 	assert((map->capacity & (map->capacity - 1)) == 0);
 
+	/* Tuning invariants */
+	assert(map->max_load_factor > 0.0f);
+	assert(map->min_load_factor >= 0.0f);
+	assert(map->growth_factor >= 2);
+	assert((map->growth_factor & (map->growth_factor - 1)) == 0);
+	assert(map->min_load_factor * (float)map->growth_factor <
+	       map->max_load_factor);
+
 	/* Size invariants */
 	assert(map->size >= map->buckets_filled);
-	assert(map->buckets_filled <= map->capacity);
+	assert(map->buckets_filled <= map->capacity + map->old_capacity);
+
+	/* Migration invariants */
+	if (map->old_buckets == NULL) {
+		assert(map->old_capacity == 0);
+		assert(map->rehash_idx == 0);
+	} else {
+		assert((map->old_capacity & (map->old_capacity - 1)) == 0);
+		assert(map->rehash_idx < map->old_capacity);
+	}
 }
 
-struct HashmapListNode *hashmap_list_new(struct HashmapListNode *next,
-					 CustomKey key, CustomValue value)
+struct HashmapListNode *hashmap_node_alloc(struct Hashmap *map)
 {
-	struct HashmapListNode *ret = (struct HashmapListNode *)HASHMAP_REALLOC(
-		NULL, sizeof(struct HashmapListNode));
-	if (ret == NULL) {
-		hashmap_panic("Out of memory. Panic.");
+	struct HashmapListNode *ret = NULL;
+	union HashmapSlab *slab = NULL;
+
+	if (!HASHMAP_SLAB_SIZE) {
+		ret = (struct HashmapListNode *)HASHMAP_REALLOC(
+			NULL, sizeof(struct HashmapListNode));
+		if (ret == NULL) {
+			hashmap_panic("Out of memory. Panic.");
+		}
+		return ret;
+	}
+
+	if (map->free_nodes != NULL) {
+		ret = map->free_nodes;
+		map->free_nodes = ret->next;
+		return ret;
+	}
+
+	if (map->slabs == NULL ||
+	    map->slabs->header.used == (size_t)HASHMAP_SLAB_SIZE) {
+		slab = (union HashmapSlab *)HASHMAP_REALLOC(
+			NULL, sizeof(union HashmapSlab) +
+				      (size_t)HASHMAP_SLAB_SIZE *
+					      sizeof(struct HashmapListNode));
+		if (slab == NULL) {
+			hashmap_panic("Out of memory. Panic.");
+		}
+
+		slab->header.next = map->slabs;
+		slab->header.used = 0;
+		map->slabs = slab;
+	}
+
+	ret = (struct HashmapListNode *)(void *)(map->slabs + 1) +
+	      map->slabs->header.used;
+	map->slabs->header.used++;
+
+	return ret;
+}
+
+void hashmap_node_free(struct Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT node)
+{
+	if (!HASHMAP_SLAB_SIZE) {
+		HASHMAP_FREE(node);
+		return;
+	}
+
+	node->next = map->free_nodes;
+	map->free_nodes = node;
+}
+
+/* Release every node of the map, in both bucket arrays */
+void hashmap_nodes_free(struct Hashmap *map)
+{
+	union HashmapSlab *next = NULL;
+	size_t idx = 0;
+
+	if (HASHMAP_SLAB_SIZE) {
+		/* Whole slabs at once, without walking the chains */
+		for (; map->slabs != NULL; map->slabs = next) {
+			next = map->slabs->header.next;
+			HASHMAP_FREE((void *)map->slabs);
+		}
+		map->free_nodes = NULL;
+		return;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		hashmap_list_free(map, map->buckets[idx]);
+	}
+
+	for (idx = map->rehash_idx; idx < map->old_capacity; idx++) {
+		hashmap_list_free(map, map->old_buckets[idx]);
 	}
+}
+
+struct HashmapListNode *hashmap_list_new(struct Hashmap *map,
+					 struct HashmapListNode *next,
+					 CustomKey key, unsigned long hash,
+					 CustomValue value)
+{
+	struct HashmapListNode *ret = hashmap_node_alloc(map);
 
 	ret->next = next;
 	ret->key = key;
 	ret->value = value;
+	HASHMAP_NODE_SET_HASH(ret, hash);
 
 	return ret;
 }
@@ -355,22 +1230,45 @@ void hashmap_init(struct Hashmap *map)
 	map->capacity = HASHMAP_DEFAULT_CAPACITY;
 	assert(map->capacity > 0);
 
+	map->max_load_factor = HASHMAP_LOAD_FACTOR;
+	map->min_load_factor = HASHMAP_MIN_LOAD_FACTOR;
+	map->growth_factor = HASHMAP_GROWTH_FACTOR;
+
+	/* Spread the raw entropy over every bit */
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));
+	HASHMAP_HASH_FMIX(map->seed);
+
 	memset((void *)map->buckets, 0,
 	       map->capacity * sizeof(struct HashmapListNode *));
 
 	hashmap_assert(map);
 }
 
+void hashmap_init_seeded(struct Hashmap *map, unsigned long seed)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_init_seeded but non-null argument expected.");
+	}
+
+	hashmap_init(map);
+	map->seed = seed;
+}
+
 int (*hashmap_compare_comparison_callback(void))(CustomKey,
 								CustomKey)
 {
 	return COMPARISON_CALLBACK;
 }
 
-int hashmap_compare_keys(CustomKey key1, CustomKey key2)
+HASHMAP_INLINE int hashmap_compare_keys(CustomKey key1, CustomKey key2)
 {
-	int (*callback)(CustomKey, CustomKey) =
-		hashmap_compare_comparison_callback();
+	/* Known when the hashmap is generated: the compiler drops the NULL
+	 * test and calls, or inlines, the function directly */
+	int (*const callback)(CustomKey, CustomKey) = COMPARISON_CALLBACK;
 
 	if (callback == NULL) {
 		return memcmp((void *)&key1, (void *)&key2, sizeof(CustomKey));
@@ -378,9 +1276,12 @@ int hashmap_compare_keys(CustomKey key1, CustomKey key2)
 	return callback(key1, key2);
 }
 
-/* Assume the first node isn't NULL */
-int hashmap_list_insert(struct HashmapListNode *head, CustomKey key,
-			CustomValue value)
+/* Return the node of key, appending one holding value if there is none.
+ * head must not be NULL. */
+struct HashmapListNode *
+hashmap_list_insert(struct Hashmap *RESTRICT map, struct HashmapListNode *head,
+		    CustomKey key, unsigned long hash, CustomValue value,
+		    int *RESTRICT inserted)
 {
 	struct HashmapListNode *prev = NULL;
 	size_t iter = 0;
@@ -391,20 +1292,21 @@ int hashmap_list_insert(struct HashmapListNode *head, CustomKey key,
 		/* Debug test for infinite loops */
 		assert(iter < 0xFFFFFFFFUL);
 
-		if (hashmap_compare_keys(key, head->key) == 0) {
-			/* Override existing value */
-			head->value = value;
-			return 1;
+		if (!HASHMAP_NODE_HASH_DIFFERS(head, hash) &&
+		    hashmap_compare_keys(key, head->key) == 0) {
+			*inserted = 0;
+			return head;
 		}
 	}
 
 	/* Append to end of list */
-	prev->next = hashmap_list_new(NULL, key, value);
-	return 0;
+	prev->next = hashmap_list_new(map, NULL, key, hash, value);
+	*inserted = 1;
+	return prev->next;
 }
 
-int hashmap_list_find(struct HashmapListNode *RESTRICT head, CustomKey key,
-		      CustomValue *RESTRICT out)
+struct HashmapListNode *hashmap_list_find(struct HashmapListNode *head,
+					  CustomKey key, unsigned long hash)
 {
 	size_t iter = 0;
 
@@ -412,19 +1314,18 @@ int hashmap_list_find(struct HashmapListNode *RESTRICT head, CustomKey key,
 		/* Debug test for infinite loops */
 		assert(iter < 0xFFFFFFFFUL);
 
-		if (hashmap_compare_keys(head->key, key) == 0) {
-			if (out != NULL) {
-				*out = head->value;
-			}
-			return 1;
+		if (!HASHMAP_NODE_HASH_DIFFERS(head, hash) &&
+		    hashmap_compare_keys(head->key, key) == 0) {
+			return head;
 		}
 	}
 
-	return 0;
+	return NULL;
 }
 
-int hashmap_list_remove(struct HashmapListNode **RESTRICT list, CustomKey key,
-			CustomValue *RESTRICT out)
+int hashmap_list_remove(struct Hashmap *RESTRICT map,
+			struct HashmapListNode **RESTRICT list, CustomKey key,
+			unsigned long hash, CustomValue *RESTRICT out)
 {
 	struct HashmapListNode *head = NULL;
 	struct HashmapListNode *prev = NULL;
@@ -440,7 +1341,8 @@ int hashmap_list_remove(struct HashmapListNode **RESTRICT list, CustomKey key,
 		/* Debug test for infinite loops */
 		assert(iter < 0xFFFFFFFFUL);
 
-		if (hashmap_compare_keys(head->key, key) != 0) {
+		if (HASHMAP_NODE_HASH_DIFFERS(head, hash) ||
+		    hashmap_compare_keys(head->key, key) != 0) {
 			continue;
 		}
 
@@ -454,7 +1356,7 @@ int hashmap_list_remove(struct HashmapListNode **RESTRICT list, CustomKey key,
 			prev->next = head->next;
 		}
 
-		HASHMAP_FREE(head);
+		hashmap_node_free(map, head);
 		return 1;
 	}
 
@@ -482,7 +1384,8 @@ int hashmap_list_iterate(struct HashmapListNode *head,
 	return 1;
 }
 
-void hashmap_list_free(struct HashmapListNode *head)
+void hashmap_list_free(struct Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT head)
 {
 	struct HashmapListNode *next = NULL;
 	size_t iter = 0;
@@ -492,12 +1395,40 @@ void hashmap_list_free(struct HashmapListNode *head)
 		assert(iter < 0xFFFFFFFFUL);
 
 		next = head->next;
-		HASHMAP_FREE(head);
+		hashmap_node_free(map, head);
 		head = next;
 	}
 }
 
-struct HashmapListNode *hashmap_list_duplicate(struct HashmapListNode *head)
+/* Split a chain by the hash bit that doubling the capacity adds, keeping the
+ * order of nodes */
+void hashmap_list_split(const struct Hashmap *map,
+			struct HashmapListNode *head, size_t bit,
+			struct HashmapListNode **RESTRICT stay,
+			struct HashmapListNode **RESTRICT move)
+{
+	size_t iter = 0;
+
+	for (iter = 0; head != NULL; head = head->next, iter++) {
+		/* Debug test for infinite loops */
+		assert(iter < 0xFFFFFFFFUL);
+
+		if ((HASHMAP_NODE_HASH(head, hashmap_hash, map) & bit) == 0) {
+			*stay = head;
+			stay = &head->next;
+		} else {
+			*move = head;
+			move = &head->next;
+		}
+	}
+
+	*stay = NULL;
+	*move = NULL;
+}
+
+struct HashmapListNode *
+hashmap_list_duplicate(struct Hashmap *RESTRICT map,
+		       struct HashmapListNode *RESTRICT head)
 {
 	struct HashmapListNode *new_head = NULL;
 	struct HashmapListNode *new_next = NULL;
@@ -507,17 +1438,21 @@ struct HashmapListNode *hashmap_list_duplicate(struct HashmapListNode *head)
 		return NULL;
 	}
 
-	new_head = hashmap_list_new(NULL, head->key, head->value);
+	/* Nodes are copied whole, along with any cached hash */
+	new_head = hashmap_node_alloc(map);
+	*new_head = *head;
 	new_next = new_head;
 
 	for (iter = 0; head->next != NULL;
 	     head = head->next, new_next = new_next->next, iter++) {
 		/* Debug test for infinite loops */
 		assert(iter < 0xFFFFFFFFUL);
-		new_next->next = hashmap_list_new(NULL, head->next->key,
-						  head->next->value);
+		new_next->next = hashmap_node_alloc(map);
+		*new_next->next = *head->next;
 	}
 
+	new_next->next = NULL;
+
 	return new_head;
 }
 
@@ -526,30 +1461,140 @@ unsigned long (*hashmap_compare_hash_callback(void))(CustomKey)
 	return HASH_CALLBACK;
 }
 
+unsigned long (*hashmap_compare_seeded_hash_callback(void))(CustomKey,
+							     unsigned long)
+{
+	return SEEDED_HASH_CALLBACK;
+}
+
+HASHMAP_INLINE unsigned long hashmap_hash(const struct Hashmap *map,
+					  CustomKey key)
+{
+	unsigned long (*const callback)(CustomKey) = HASH_CALLBACK;
+	unsigned long (*const seeded_callback)(CustomKey, unsigned long) =
+		SEEDED_HASH_CALLBACK;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_hash but non-null argument expected.");
+	}
+
+	if (seeded_callback != NULL) {
+		return seeded_callback(key, map->seed);
+	}
+	if (callback != NULL) {
+		return callback(key);
+	}
+	return hashmap_hash_buf_seeded((const void *)&key, sizeof(CustomKey),
+				       map->seed);
+}
+
 size_t hashmap_hash_index(const struct Hashmap *map,
 					 CustomKey key)
+{
+	return hashmap_hash(map, key) & (map->capacity - 1);
+}
+
+/* Bucket of a key's hash, in the old array if it was not migrated yet */
+struct HashmapListNode **hashmap_bucket(const struct Hashmap *map,
+					unsigned long hash)
 {
 	size_t idx = 0;
-	unsigned long (*callback)(CustomKey) = hashmap_compare_hash_callback();
 
-	if (callback == NULL) {
-		idx = hashmap_fnv1a_32_buf((const void *)&key,
-					   sizeof(CustomKey));
-	} else {
-		idx = callback(key);
+	if (map->old_buckets != NULL) {
+		idx = hash & (map->old_capacity - 1);
+		if (idx >= map->rehash_idx) {
+			return &map->old_buckets[idx];
+		}
+	}
+
+	return &map->buckets[hash & (map->capacity - 1)];
+}
+
+/* Relink the nodes of up to steps old buckets into the new array. Old
+ * bucket idx spreads over the still empty new buckets idx + n * old_capacity,
+ * split in halves once per doubling of the capacity. */
+void hashmap_rehash_step(struct Hashmap *map, size_t steps)
+{
+	size_t idx = 0;
+	size_t bit = 0;
+	size_t pos = 0;
+
+	for (; steps > 0 && map->old_buckets != NULL; steps--) {
+		assert(map->capacity > map->old_capacity);
+
+		idx = map->rehash_idx;
+
+		if (map->old_buckets[idx] != NULL) {
+			assert(map->buckets_filled > 0);
+			map->buckets_filled--;
+
+			assert(map->buckets[idx] == NULL);
+			map->buckets[idx] = map->old_buckets[idx];
+			map->old_buckets[idx] = NULL;
+
+			for (bit = map->old_capacity; bit < map->capacity;
+			     bit <<= 1) {
+				for (pos = idx; pos < bit;
+				     pos += map->old_capacity) {
+					assert(map->buckets[pos + bit] == NULL);
+					hashmap_list_split(
+						map, map->buckets[pos], bit,
+						&map->buckets[pos],
+						&map->buckets[pos + bit]);
+				}
+			}
+
+			for (pos = idx; pos < map->capacity;
+			     pos += map->old_capacity) {
+				map->buckets_filled +=
+					map->buckets[pos] != NULL;
+			}
+		}
+
+		map->rehash_idx++;
+
+		if (map->rehash_idx == map->old_capacity) {
+			HASHMAP_FREE((void *)map->old_buckets);
+			map->old_buckets = NULL;
+			map->old_capacity = 0;
+			map->rehash_idx = 0;
+		}
 	}
+}
+
+/* Start migrating to a new array of new_capacity buckets, a power of 2 above
+ * the current capacity. Nodes are relinked into it, never reallocated. */
+void hashmap_expand(struct Hashmap *map, size_t new_capacity)
+{
+	size_t new_capacity_size = 0;
+	struct HashmapListNode **new_buckets = NULL;
+
+	assert(map->old_buckets == NULL);
+	assert(new_capacity > map->capacity);
+	assert((new_capacity & (new_capacity - 1)) == 0);
 
-	idx &= map->capacity - 1;
+	new_capacity_size = new_capacity * sizeof(struct HashmapListNode *);
+	new_buckets = (struct HashmapListNode **)HASHMAP_REALLOC(
+		NULL, new_capacity_size);
+	if (new_buckets == NULL) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+	memset((void *)new_buckets, 0, new_capacity_size);
 
-	return idx;
+	map->old_buckets = map->buckets;
+	map->old_capacity = map->capacity;
+	map->rehash_idx = 0;
+	map->buckets = new_buckets;
+	map->capacity = new_capacity;
 }
 
 void hashmap_grow(struct Hashmap *map)
 {
 	size_t new_capacity = 0;
-	struct Hashmap new_map = { 0 };
-	int (*iteration_callback_backup)(CustomKey, CustomValue, void *);
-	size_t new_capacity_size = 0;
 
 	if (map == NULL) {
 		if (HASHMAP_NO_PANIC_ON_NULL) {
@@ -565,76 +1610,40 @@ void hashmap_grow(struct Hashmap *map)
 		hashmap_init(map);
 	}
 
-	iteration_callback_backup = map->iteration_callback;
-
-	/* Calculate the next power of 2 */
-	new_capacity = map->capacity;
-	new_capacity |= new_capacity >> 1;
-	new_capacity |= new_capacity >> 2;
-	new_capacity |= new_capacity >> 4;
-	new_capacity |= new_capacity >> 8;
-	if (sizeof(size_t) >= 4) {
-		new_capacity |= new_capacity >> 16;
-	}
-	if (sizeof(size_t) >= 8) {
-		new_capacity |= new_capacity >> 32;
-	}
-	new_capacity++;
+	/* Finish the pending migration before starting another */
+	hashmap_rehash_step(map, map->old_capacity);
 
-	if (new_capacity < map->capacity) {
+	if (map->capacity > ((size_t)-1) / map->growth_factor) {
 		/* Overflow, do not grow, let separate chaining handle
 		 * collisions */
 		return;
 	}
+
+	new_capacity = map->capacity * map->growth_factor;
+
 	if (new_capacity > ((size_t)-1) / sizeof(struct HashmapListNode *)) {
 		/* Would overflow, do not grow, let separate chaining handle
 		 * collisions */
 		return;
 	}
 
-	new_capacity_size = new_capacity * sizeof(struct HashmapListNode *);
-	new_map.capacity = new_capacity;
-	new_map.buckets = (struct HashmapListNode **)HASHMAP_REALLOC(
-		NULL, new_capacity_size);
-	if (new_map.buckets == NULL) {
-		hashmap_panic("Out of memory. Panic.");
-	}
-	memset((void *)new_map.buckets, 0, new_capacity_size);
-
-	map->iteration_callback = hashmap_grow_internal;
-	hashmap_iterate(map, &new_map);
+	hashmap_expand(map, new_capacity);
 
-	assert(map->size >= new_map.size);
-	if (map->size != new_map.size) {
-		/* Failed to grow, revert operation */
-		map->iteration_callback = iteration_callback_backup;
-		hashmap_free(&new_map);
-		return;
+	if (!HASHMAP_INCREMENTAL_REHASH) {
+		hashmap_rehash_step(map, map->old_capacity);
 	}
-
-	hashmap_free(map);
-	*map = new_map;
-	map->iteration_callback = iteration_callback_backup;
-}
-
-int hashmap_grow_internal(CustomKey key, CustomValue value, void *new_map)
-{
-	/* Should never overwrite */
-	assert(hashmap_insert(new_map, key, value) == 0);
-	return 1;
 }
 
-int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+void hashmap_reserve(struct Hashmap *map, size_t count)
 {
-	size_t idx = 0;
-	int overwritten = 0;
+	size_t new_capacity = 0;
 
 	if (map == NULL) {
 		if (HASHMAP_NO_PANIC_ON_NULL) {
-			return -1;
+			return;
 		}
 		hashmap_panic(
-			"Null passed to hashmap_insert but non-null argument expected.");
+			"Null passed to hashmap_reserve but non-null argument expected.");
 	}
 
 	hashmap_assert(map);
@@ -643,87 +1652,591 @@ int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
 		hashmap_init(map);
 	}
 
-	/* Check for being above load factor */
-	if ((float)map->buckets_filled / (float)map->capacity >
-	    HASHMAP_LOAD_FACTOR) {
-		hashmap_grow(map);
-	}
-
-	idx = hashmap_hash_index(map, key);
+	/* Finish the pending migration before starting another */
+	hashmap_rehash_step(map, map->old_capacity);
 
-	if (map->buckets[idx] == NULL) {
-		map->buckets[idx] = hashmap_list_new(NULL, key, value);
-		map->buckets_filled++;
-		map->size++;
-		return 0;
+	/* Smallest power of 2 holding count within the load factor */
+	new_capacity = map->capacity;
+	while ((float)count / (float)new_capacity > map->max_load_factor) {
+		if (new_capacity >
+		    ((size_t)-1) / sizeof(struct HashmapListNode *) / 2) {
+			/* Would overflow, keep the largest capacity */
+			break;
+		}
+		new_capacity *= 2;
 	}
 
-	overwritten = hashmap_list_insert(map->buckets[idx], key, value);
-	if (!overwritten) {
-		map->size++;
+	if (new_capacity == map->capacity) {
+		return;
 	}
 
-	return overwritten;
+	/* Relink everything at once, reserving is meant to be paid upfront */
+	hashmap_expand(map, new_capacity);
+	hashmap_rehash_step(map, map->old_capacity);
+
+	hashmap_assert(map);
 }
 
-int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
-		   CustomValue *RESTRICT out)
+/* Concatenate the chains of buckets idx + n * new_capacity into bucket idx.
+ * Nodes are relinked, their hash never computed. */
+void hashmap_shrink(struct Hashmap *map, size_t new_capacity)
 {
+	struct HashmapListNode **new_buckets = NULL;
+	struct HashmapListNode **tail = NULL;
 	size_t idx = 0;
-	int found = 0;
-
-	if (map == NULL) {
-		if (HASHMAP_NO_PANIC_ON_NULL) {
-			return -1;
-		}
-		hashmap_panic(
-			"Null passed to hashmap_remove but non-null argument expected.");
-	}
+	size_t old = 0;
 
-	hashmap_assert(map);
+	assert(map->old_buckets == NULL);
+	assert(new_capacity > 0 && new_capacity <= map->capacity);
+	assert((new_capacity & (new_capacity - 1)) == 0);
 
-	if (map->buckets == NULL) {
-		return 0;
+	new_buckets = (struct HashmapListNode **)HASHMAP_REALLOC(
+		NULL, new_capacity * sizeof(struct HashmapListNode *));
+	if (new_buckets == NULL) {
+		/* Shrinking is optional, keep the current buckets */
+		return;
 	}
 
-	idx = hashmap_hash_index(map, key);
+	map->buckets_filled = 0;
 
-	found = hashmap_list_remove(&map->buckets[idx], key, out);
+	for (idx = 0; idx < new_capacity; idx++) {
+		tail = &new_buckets[idx];
 
-	if (found) {
-		if (map->buckets[idx] == NULL) {
-			assert(map->buckets_filled > 0);
-			map->buckets_filled--;
+		for (old = idx; old < map->capacity; old += new_capacity) {
+			*tail = map->buckets[old];
+			while (*tail != NULL) {
+				tail = &(*tail)->next;
+			}
 		}
-		assert(map->size > 0);
-		map->size--;
+
+		map->buckets_filled += new_buckets[idx] != NULL;
 	}
 
-	return found;
+	HASHMAP_FREE((void *)map->buckets);
+	map->buckets = new_buckets;
+	map->capacity = new_capacity;
+
+	hashmap_assert(map);
 }
 
-int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
-		CustomValue *RESTRICT out)
+void hashmap_shrink_to_fit(struct Hashmap *map)
 {
-	size_t idx = 0;
+	size_t new_capacity = HASHMAP_DEFAULT_CAPACITY;
 
 	if (map == NULL) {
 		if (HASHMAP_NO_PANIC_ON_NULL) {
-			return -1;
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_shrink_to_fit but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		return;
+	}
+
+	/* Shrinking concatenates chains of the new array only */
+	hashmap_rehash_step(map, map->old_capacity);
+
+	/* Smallest power of 2 holding size within the load factor */
+	while (new_capacity < map->capacity &&
+	       (float)map->size / (float)new_capacity > map->max_load_factor) {
+		new_capacity *= 2;
+	}
+
+	if (new_capacity < map->capacity) {
+		hashmap_shrink(map, new_capacity);
+	}
+}
+
+/* Make room for one more element before inserting it: initialize, then
+ * either migrate old buckets or grow above the load factor. */
+void hashmap_make_room(struct Hashmap *map)
+{
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	if (map->old_buckets != NULL) {
+		hashmap_rehash_step(map, HASHMAP_INCREMENTAL_REHASH);
+	} else if ((float)map->size / (float)map->capacity >
+		   map->max_load_factor) {
+		/* Above load factor */
+		hashmap_grow(map);
+	}
+}
+
+/* Return the node of key, inserting one holding value if there is none. Map
+ * must not be NULL. */
+struct HashmapListNode *hashmap_entry(struct Hashmap *RESTRICT map,
+				      CustomKey key, unsigned long hash,
+				      CustomValue value,
+				      int *RESTRICT inserted)
+{
+	struct HashmapListNode **bucket = NULL;
+	struct HashmapListNode *node = NULL;
+
+	hashmap_make_room(map);
+
+	bucket = hashmap_bucket(map, hash);
+
+	if (*bucket == NULL) {
+		*bucket = hashmap_list_new(map, NULL, key, hash, value);
+		map->buckets_filled++;
+		map->size++;
+		*inserted = 1;
+		return *bucket;
+	}
+
+	node = hashmap_list_insert(map, *bucket, key, hash, value, inserted);
+	if (*inserted) {
+		map->size++;
+	}
+
+	return node;
+}
+
+int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert but non-null argument expected.");
+	}
+
+	/* The seed is picked by hashmap_init(), before hashing */
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	return hashmap_insert_hashed(map, key, hashmap_hash(map, key), value);
+}
+
+int hashmap_insert_hashed(struct Hashmap *map, CustomKey key,
+			  unsigned long hash, CustomValue value)
+{
+	struct HashmapListNode *node = NULL;
+	int inserted = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert_hashed but non-null argument expected.");
+	}
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	/* Debug test for a hash from another function */
+	assert(hash == hashmap_hash(map, key));
+
+	node = hashmap_entry(map, key, hash, value, &inserted);
+	if (!inserted) {
+		/* Override existing value */
+		node->value = value;
+	}
+
+	return !inserted;
+}
+
+void hashmap_insert_unique(struct Hashmap *map, CustomKey key,
+			   CustomValue value)
+{
+	struct HashmapListNode **bucket = NULL;
+	unsigned long hash = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert_unique but non-null argument expected.");
+	}
+
+	hashmap_make_room(map);
+
+	hash = hashmap_hash(map, key);
+	bucket = hashmap_bucket(map, hash);
+
+	/* Debug test for duplicate keys */
+	assert(hashmap_list_find(*bucket, key, hash) == NULL);
+
+	/* Push to head of list */
+	map->buckets_filled += *bucket == NULL;
+	*bucket = hashmap_list_new(map, *bucket, key, hash, value);
+	map->size++;
+}
+
+void hashmap_build_from_arrays(struct Hashmap *RESTRICT map,
+			       CustomKey const *RESTRICT keys,
+			       CustomValue const *RESTRICT values, size_t count)
+{
+	struct HashmapListNode **bucket = NULL;
+	struct HashmapListNode *node = NULL;
+	unsigned long *hashes = NULL;
+	size_t *order = NULL;
+	size_t *offsets = NULL;
+	size_t idx = 0;
+	size_t key = 0;
+	int inserted = 0;
+
+	if (map == NULL || ((keys == NULL || values == NULL) && count > 0)) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_build_from_arrays but non-null argument expected.");
+	}
+
+	if (count > ((size_t)-1) - map->size) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	/* Size once, this also initializes and ends any migration */
+	hashmap_reserve(map, map->size + count);
+
+	if (count == 0) {
+		return;
+	}
+
+	if (count > ((size_t)-1) / sizeof(unsigned long) ||
+	    map->capacity >= ((size_t)-1) / sizeof(size_t)) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	hashes = (unsigned long *)HASHMAP_REALLOC(
+		NULL, count * sizeof(unsigned long));
+	order = (size_t *)HASHMAP_REALLOC(NULL, count * sizeof(size_t));
+	offsets = (size_t *)HASHMAP_REALLOC(
+		NULL, (map->capacity + 1) * sizeof(size_t));
+	if (hashes == NULL || order == NULL || offsets == NULL) {
+		HASHMAP_FREE((void *)hashes);
+		HASHMAP_FREE((void *)order);
+		HASHMAP_FREE((void *)offsets);
+		hashmap_panic("Out of memory. Panic.");
+	}
+	memset((void *)offsets, 0, (map->capacity + 1) * sizeof(size_t));
+
+	/* Counting sort of the keys by bucket, stable to keep the last
+	 * duplicate winning */
+	for (idx = 0; idx < count; idx++) {
+		hashes[idx] = hashmap_hash(map, keys[idx]);
+		offsets[(hashes[idx] & (map->capacity - 1)) + 1]++;
+	}
+	for (idx = 0; idx < map->capacity; idx++) {
+		offsets[idx + 1] += offsets[idx];
+	}
+	for (idx = 0; idx < count; idx++) {
+		order[offsets[hashes[idx] & (map->capacity - 1)]++] = idx;
+	}
+
+	/* Nodes are allocated bucket after bucket, so each chain is carved
+	 * contiguously from slabs with HASHMAP_SLAB_SIZE */
+	for (idx = 0; idx < count; idx++) {
+		key = order[idx];
+		bucket = &map->buckets[hashes[key] & (map->capacity - 1)];
+
+		if (*bucket == NULL) {
+			*bucket = hashmap_list_new(map, NULL, keys[key],
+						   hashes[key], values[key]);
+			map->buckets_filled++;
+			map->size++;
+			continue;
+		}
+
+		node = hashmap_list_insert(map, *bucket, keys[key],
+					   hashes[key], values[key],
+					   &inserted);
+		if (inserted) {
+			map->size++;
+		} else {
+			node->value = values[key];
+		}
+	}
+
+	HASHMAP_FREE((void *)hashes);
+	HASHMAP_FREE((void *)order);
+	HASHMAP_FREE((void *)offsets);
+
+	hashmap_assert(map);
+}
+
+CustomValue *hashmap_get_or_insert(struct Hashmap *map, CustomKey key,
+				   CustomValue default_value, int *inserted)
+{
+	struct HashmapListNode *node = NULL;
+	int added = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return NULL;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get_or_insert but non-null argument expected.");
+	}
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	node = hashmap_entry(map, key, hashmap_hash(map, key), default_value,
+			     &added);
+	if (inserted != NULL) {
+		*inserted = added;
+	}
+
+	return &node->value;
+}
+
+int hashmap_upsert(struct Hashmap *map, CustomKey key,
+		   void (*callback)(CustomKey key, CustomValue *value,
+				    int existed, void *context),
+		   void *context)
+{
+	struct HashmapListNode *node = NULL;
+	CustomValue zero;
+	int inserted = 0;
+
+	if (map == NULL || callback == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_upsert but non-null argument expected.");
+	}
+
+	memset((void *)&zero, 0, sizeof(CustomValue));
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	node = hashmap_entry(map, key, hashmap_hash(map, key), zero, &inserted);
+	callback(node->key, &node->value, !inserted, context);
+
+	return !inserted;
+}
+
+int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove but non-null argument expected.");
+	}
+
+	return hashmap_remove_hashed(map, key, hashmap_hash(map, key), out);
+}
+
+int hashmap_remove_hashed(struct Hashmap *RESTRICT map, CustomKey key,
+			  unsigned long hash, CustomValue *RESTRICT out)
+{
+	struct HashmapListNode **bucket = NULL;
+	size_t new_capacity = 0;
+	int found = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove_hashed but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	/* Debug test for a hash from another function */
+	assert(hash == hashmap_hash(map, key));
+
+	if (map->buckets == NULL) {
+		return 0;
+	}
+
+	hashmap_rehash_step(map, HASHMAP_INCREMENTAL_REHASH);
+
+	bucket = hashmap_bucket(map, hash);
+
+	found = hashmap_list_remove(map, bucket, key, hash, out);
+
+	if (!found) {
+		return 0;
+	}
+
+	if (*bucket == NULL) {
+		assert(map->buckets_filled > 0);
+		map->buckets_filled--;
+	}
+	assert(map->size > 0);
+	map->size--;
+
+	/* Below load factor, unless migrating */
+	if (map->old_buckets == NULL &&
+	    map->capacity > HASHMAP_DEFAULT_CAPACITY &&
+	    (float)map->size / (float)map->capacity < map->min_load_factor) {
+		new_capacity = map->capacity / map->growth_factor;
+		if (new_capacity < HASHMAP_DEFAULT_CAPACITY) {
+			new_capacity = HASHMAP_DEFAULT_CAPACITY;
+		}
+		hashmap_shrink(map, new_capacity);
+	}
+
+	return 1;
+}
+
+int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
 		}
 		hashmap_panic(
 			"Null passed to hashmap_get but non-null argument expected.");
 	}
 
+	return hashmap_get_hashed(map, key, hashmap_hash(map, key), out);
+}
+
+int hashmap_get_hashed(const struct Hashmap *RESTRICT map, CustomKey key,
+		       unsigned long hash, CustomValue *RESTRICT out)
+{
+	struct HashmapListNode *node = NULL;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get_hashed but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	/* Debug test for a hash from another function */
+	assert(hash == hashmap_hash(map, key));
+
+	if (map->buckets == NULL) {
+		return 0;
+	}
+
+	node = hashmap_list_find(*hashmap_bucket(map, hash), key, hash);
+
+	if (node == NULL) {
+		return 0;
+	}
+
+	if (out != NULL) {
+		*out = node->value;
+	}
+
+	return 1;
+}
+
+size_t hashmap_get_many(const struct Hashmap *RESTRICT map,
+			CustomKey const *RESTRICT keys, size_t count,
+			CustomValue *RESTRICT out_values,
+			int *RESTRICT out_found)
+{
+	struct HashmapListNode **buckets[HASHMAP_PREFETCH_BATCH];
+	struct HashmapListNode *heads[HASHMAP_PREFETCH_BATCH];
+	unsigned long hashes[HASHMAP_PREFETCH_BATCH];
+	struct HashmapListNode *node = NULL;
+	size_t found = 0;
+	size_t batch = 0;
+	size_t base = 0;
+	size_t idx = 0;
+
+	if (map == NULL || (keys == NULL && count > 0)) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get_many but non-null argument expected.");
+	}
+
 	hashmap_assert(map);
 
 	if (map->buckets == NULL) {
+		if (out_found != NULL && count > 0) {
+			memset((void *)out_found, 0, count * sizeof(int));
+		}
 		return 0;
 	}
 
-	idx = hashmap_hash_index(map, key);
+	for (base = 0; base < count; base += batch) {
+		batch = count - base;
+		if (batch > HASHMAP_PREFETCH_BATCH) {
+			batch = HASHMAP_PREFETCH_BATCH;
+		}
+
+		/* Hash the whole batch, loading every bucket at once */
+		for (idx = 0; idx < batch; idx++) {
+			hashes[idx] = hashmap_hash(map, keys[base + idx]);
+			buckets[idx] = hashmap_bucket(map, hashes[idx]);
+			HASHMAP_PREFETCH(buckets[idx]);
+		}
+
+		/* Then every first node */
+		for (idx = 0; idx < batch; idx++) {
+			heads[idx] = *buckets[idx];
+			if (heads[idx] != NULL) {
+				HASHMAP_PREFETCH(heads[idx]);
+			}
+		}
+
+		for (idx = 0; idx < batch; idx++) {
+			node = hashmap_list_find(heads[idx], keys[base + idx],
+						 hashes[idx]);
+			if (node != NULL) {
+				if (out_values != NULL) {
+					out_values[base + idx] = node->value;
+				}
+				found++;
+			}
+			if (out_found != NULL) {
+				out_found[base + idx] = node != NULL;
+			}
+		}
+	}
 
-	return hashmap_list_find(map->buckets[idx], key, out);
+	return found;
+}
+
+CustomValue *hashmap_get_ptr(struct Hashmap *map, CustomKey key)
+{
+	struct HashmapListNode *node = NULL;
+	unsigned long hash = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return NULL;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get_ptr but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		return NULL;
+	}
+
+	hash = hashmap_hash(map, key);
+	node = hashmap_list_find(*hashmap_bucket(map, hash), key, hash);
+
+	return node != NULL ? &node->value : NULL;
 }
 
 int hashmap_has(const struct Hashmap *map, CustomKey key)
@@ -738,8 +2251,6 @@ size_t hashmap_size(const Hashmap *map)
 
 void hashmap_free(struct Hashmap *map)
 {
-	size_t idx = 0;
-
 	if (map == NULL) {
 		if (HASHMAP_NO_PANIC_ON_NULL) {
 			return;
@@ -750,11 +2261,10 @@ void hashmap_free(struct Hashmap *map)
 
 	hashmap_assert(map);
 
-	for (idx = 0; idx < map->capacity; idx++) {
-		hashmap_list_free(map->buckets[idx]);
-	}
+	hashmap_nodes_free(map);
 
 	HASHMAP_FREE((void *)map->buckets);
+	HASHMAP_FREE((void *)map->old_buckets);
 
 	memset((void *)map, 0, sizeof(struct Hashmap));
 }
@@ -778,6 +2288,15 @@ void hashmap_iterate(struct Hashmap *map, void *context)
 		return;
 	}
 
+	for (idx = map->rehash_idx; idx < map->old_capacity; idx++) {
+		callback_response =
+			hashmap_list_iterate(map->old_buckets[idx],
+					     map->iteration_callback, context);
+		if (callback_response == 0) {
+			return;
+		}
+	}
+
 	for (idx = 0; idx < map->capacity; idx++) {
 		callback_response = hashmap_list_iterate(
 			map->buckets[idx], map->iteration_callback, context);
@@ -787,6 +2306,122 @@ void hashmap_iterate(struct Hashmap *map, void *context)
 	}
 }
 
+void hashmap_iter_begin(struct Hashmap *RESTRICT map,
+			struct HashmapIter *RESTRICT iter)
+{
+	if (map == NULL || iter == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iter_begin but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	iter->map = map;
+	iter->link = NULL;
+	iter->bucket = map->rehash_idx;
+	iter->in_old = map->old_buckets != NULL;
+	iter->removed = 0;
+}
+
+int hashmap_iter_next(struct HashmapIter *RESTRICT iter,
+		      CustomKey const **RESTRICT key,
+		      CustomValue **RESTRICT value)
+{
+	struct HashmapListNode **buckets = NULL;
+	struct Hashmap *map = NULL;
+
+	if (iter == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iter_next but non-null argument expected.");
+	}
+
+	map = iter->map;
+	hashmap_assert(map);
+
+	if (iter->link != NULL) {
+		if (!iter->removed) {
+			iter->link = &(*iter->link)->next;
+		}
+		iter->removed = 0;
+
+		if (*iter->link == NULL) {
+			/* End of chain */
+			iter->link = NULL;
+			iter->bucket++;
+		}
+	}
+
+	/* Old buckets not migrated yet, then the new ones */
+	for (; iter->link == NULL; iter->bucket++) {
+		if (iter->in_old && iter->bucket >= map->old_capacity) {
+			iter->in_old = 0;
+			iter->bucket = 0;
+		}
+		if (!iter->in_old && iter->bucket >= map->capacity) {
+			return 0;
+		}
+
+		buckets = iter->in_old ? map->old_buckets : map->buckets;
+		if (buckets[iter->bucket] != NULL) {
+			iter->link = &buckets[iter->bucket];
+			break;
+		}
+	}
+
+	if (key != NULL) {
+		*key = &(*iter->link)->key;
+	}
+	if (value != NULL) {
+		*value = &(*iter->link)->value;
+	}
+
+	return 1;
+}
+
+int hashmap_iter_remove(struct HashmapIter *iter)
+{
+	struct HashmapListNode *node = NULL;
+	struct Hashmap *map = NULL;
+
+	if (iter == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iter_remove but non-null argument expected.");
+	}
+
+	map = iter->map;
+	hashmap_assert(map);
+
+	if (iter->link == NULL || iter->removed) {
+		return 0;
+	}
+
+	/* Unlink in place: no rehash step nor shrink, which would move the
+	 * nodes under the iterator */
+	node = *iter->link;
+	*iter->link = node->next;
+	hashmap_node_free(map, node);
+
+	if ((iter->in_old ? map->old_buckets : map->buckets)[iter->bucket] ==
+	    NULL) {
+		assert(map->buckets_filled > 0);
+		map->buckets_filled--;
+	}
+	assert(map->size > 0);
+	map->size--;
+	iter->removed = 1;
+
+	return 1;
+}
+
 void hashmap_duplicate(struct Hashmap *RESTRICT dest,
 		       struct Hashmap *RESTRICT src)
 {
@@ -816,13 +2451,43 @@ void hashmap_duplicate(struct Hashmap *RESTRICT dest,
 	dest->capacity = src->capacity;
 	dest->size = src->size;
 	dest->buckets_filled = src->buckets_filled;
+	dest->max_load_factor = src->max_load_factor;
+	dest->min_load_factor = src->min_load_factor;
+	dest->growth_factor = src->growth_factor;
+	dest->seed = src->seed;
 	dest->iteration_callback = src->iteration_callback;
 
 	memset((void *)dest->buckets, 0,
 	       dest->capacity * sizeof(struct HashmapListNode *));
 
+	dest->slabs = NULL;
+	dest->free_nodes = NULL;
+
 	for (idx = 0; idx < dest->capacity; idx++) {
-		dest->buckets[idx] = hashmap_list_duplicate(src->buckets[idx]);
+		dest->buckets[idx] =
+			hashmap_list_duplicate(dest, src->buckets[idx]);
+	}
+
+	dest->old_buckets = NULL;
+	dest->old_capacity = 0;
+	dest->rehash_idx = 0;
+
+	if (src->old_buckets != NULL) {
+		dest->old_buckets = (struct HashmapListNode **)HASHMAP_REALLOC(
+			NULL,
+			src->old_capacity * sizeof(struct HashmapListNode *));
+
+		if (dest->old_buckets == NULL) {
+			hashmap_panic("Out of memory. Panic.");
+		}
+
+		dest->old_capacity = src->old_capacity;
+		dest->rehash_idx = src->rehash_idx;
+
+		for (idx = 0; idx < dest->old_capacity; idx++) {
+			dest->old_buckets[idx] = hashmap_list_duplicate(
+				dest, src->old_buckets[idx]);
+		}
 	}
 
 	hashmap_assert(dest);
@@ -842,11 +2507,17 @@ void hashmap_clear(struct Hashmap *map)
 
 	hashmap_assert(map);
 
+	hashmap_nodes_free(map);
+
 	for (idx = 0; idx < map->capacity; idx++) {
-		hashmap_list_free(map->buckets[idx]);
 		map->buckets[idx] = NULL;
 	}
 
+	HASHMAP_FREE((void *)map->old_buckets);
+	map->old_buckets = NULL;
+	map->old_capacity = 0;
+	map->rehash_idx = 0;
+
 	map->size = 0;
 	map->buckets_filled = 0;
 }
@@ -879,6 +2550,53 @@ unsigned long hashmap_fnv1a_32_str(const char *str)
 
 	return hval;
 }
+
+unsigned long hashmap_hash_buf(const void *buf, size_t len)
+{
+	return hashmap_hash_buf_seeded(buf, len, 0);
+}
+
+unsigned long hashmap_hash_str(const char *str)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), 0);
+}
+
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	unsigned long hash = seed;
+	unsigned long word = 0;
+	size_t left = len;
+
+	/* A whole word per multiply, instead of a byte */
+	for (; left >= HASHMAP_HASH_WORD_SIZE;
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {
+		/* The seed also goes into each word, so that colliding
+		 * words cannot be chosen without knowing it */
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);
+		hash = HASHMAP_HASH_STEP(hash);
+	}
+
+	/* Remaining bytes, as the low bytes of a word */
+	if (left > 0) {
+		while (left > 0) {
+			left--;
+			word = (word << 8) | (unsigned long)bptr[left];
+		}
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);
+	}
+
+	hash ^= (unsigned long)len;
+	HASHMAP_HASH_FMIX(hash);
+
+	return hash;
+}
+
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), seed);
+}
 /* Definitions stop here */
 
 /****************************************************************************
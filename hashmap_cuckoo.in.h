@@ -0,0 +1,824 @@
+/* hashmap_cuckoo.in.h - Bucketized cuckoo engine template for hashmap.h */
+#ifndef HASHMAP_CUCKOO_IN_H
+#define HASHMAP_CUCKOO_IN_H
+
+/* Template of HASHMAP_DECLARE_CUCKOO() and HASHMAP_DEFINE_CUCKOO().
+ *
+ * Like hashmap.in.h, this is a version of the engine with hardcoded types and
+ * function names. libgen.py turns the code between the markers into macros
+ * and appends them to hashmap.h, which provides the shared configuration.
+ *
+ * Buckets hold HASHMAP_CUCKOO_BUCKET_SIZE entries each (4-way set
+ * associative). A key may only live in one of two buckets: the first is
+ * selected by its hash, the second by a remix of the same hash. Lookups thus
+ * read at most two buckets. Inserting into two full buckets evicts an entry
+ * to its other bucket, repeating up to HASHMAP_CUCKOO_MAX_KICKS times before
+ * growing the table instead.
+ *
+ * An entry still left out goes to the stash, an array of
+ * HASHMAP_CUCKOO_STASH_SIZE entries scanned by lookups missing both buckets.
+ * Inserting into a full stash grows the table first, and growing doubles the
+ * capacity again while the entries left out overflow the new stash. Keys
+ * sharing a full hash collide at every capacity, so more than two buckets'
+ * worth of them make hashmap_insert() panic once the table would have
+ * HASHMAP_STASH_MAX_SPREAD buckets per entry.
+ *
+ * With a NULL hash function, keys are hashed with hashmap_hash_buf_seeded()
+ * and the seed hashmap_init() picks for each map, as in hashmap.in.h. A hash
+ * function passed in is called as is, without the seed.
+ */
+
+#include "hashmap.h"
+
+#ifndef HASH_CALLBACK
+#define HASH_CALLBACK NULL
+#endif /* HASH_CALLBACK */
+
+#ifndef COMPARISON_CALLBACK
+#define COMPARISON_CALLBACK NULL
+#endif /* COMPARISON_CALLBACK */
+
+typedef int CustomValue;
+typedef const char *CustomKey;
+
+/* Declarations start here */
+
+struct HashmapBucket {
+	CustomKey keys[HASHMAP_CUCKOO_BUCKET_SIZE];
+	CustomValue values[HASHMAP_CUCKOO_BUCKET_SIZE];
+	/* Bit n is set if entry n holds a key */
+	unsigned int occupied;
+};
+
+struct HashmapEntry {
+	CustomKey key;
+	CustomValue value;
+};
+
+typedef struct Hashmap {
+	struct HashmapBucket *buckets;
+	int (*iteration_callback)(CustomKey key, CustomValue value,
+				  void *context);
+	size_t size;
+	/* Number of buckets, each holding HASHMAP_CUCKOO_BUCKET_SIZE entries */
+	size_t capacity;
+	/* Entries placed in neither candidate bucket, counted in size */
+	struct HashmapEntry stash[HASHMAP_CUCKOO_STASH_SIZE];
+	size_t stash_size;
+	/* Mixed into default hashes, picked by hashmap_init() */
+	unsigned long seed;
+} Hashmap;
+
+/* API functions */
+void hashmap_init(Hashmap *map);
+void hashmap_grow(Hashmap *map);
+int hashmap_insert(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_remove(Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out);
+int hashmap_get(const Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out);
+int hashmap_has(const Hashmap *map, CustomKey key);
+size_t hashmap_size(const Hashmap *map);
+void hashmap_free(Hashmap *map);
+void hashmap_iterate(Hashmap *map, void *context);
+void hashmap_duplicate(Hashmap *RESTRICT dest, Hashmap *RESTRICT src);
+void hashmap_clear(Hashmap *map);
+
+/* Internal functions */
+void hashmap_assert(const Hashmap *map);
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey);
+int hashmap_compare_keys(CustomKey key1, CustomKey key2);
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey);
+unsigned long hashmap_hash(const Hashmap *map, CustomKey key);
+unsigned long hashmap_alt_hash(unsigned long hash);
+int hashmap_find(const Hashmap *map, CustomKey key, size_t *bucket,
+		 unsigned int *entry);
+int hashmap_bucket_put(struct HashmapBucket *bucket, CustomKey key,
+		       CustomValue value);
+int hashmap_place(Hashmap *RESTRICT map, CustomKey *RESTRICT key,
+		  CustomValue *RESTRICT value);
+size_t hashmap_stash_find(const Hashmap *map, CustomKey key);
+int hashmap_stash_put(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_move_entries(Hashmap *RESTRICT new_map,
+			 const Hashmap *RESTRICT map);
+struct HashmapBucket *hashmap_alloc_buckets(size_t capacity);
+void hashmap_rehash(Hashmap *map, size_t new_capacity);
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len);
+unsigned long hashmap_fnv1a_32_str(const char *str);
+unsigned long hashmap_hash_buf(const void *buf, size_t len);
+unsigned long hashmap_hash_str(const char *str);
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed);
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed);
+/* Declarations stop here */
+
+/* Definitions start here */
+struct Hashmap;
+struct HashmapBucket;
+struct HashmapEntry;
+HASHMAP_DEFINE_PANIC(hashmap)
+
+void hashmap_assert(const struct Hashmap *map)
+{
+	/* If buckets is NULL, map should be in initial/freed state */
+	if (map->buckets == NULL) {
+		assert(map->size == 0);
+		assert(map->capacity == 0);
+		return;
+	}
+
+	/* Capacity must be a power of 2 with room for both candidates */
+	assert(map->capacity >= 2);
+	assert((map->capacity & (map->capacity - 1)) == 0);
+
+	assert(map->stash_size <= HASHMAP_CUCKOO_STASH_SIZE);
+	assert(map->stash_size <= map->size);
+	assert(map->size - map->stash_size <=
+	       map->capacity * HASHMAP_CUCKOO_BUCKET_SIZE);
+}
+
+struct HashmapBucket *hashmap_alloc_buckets(size_t capacity)
+{
+	struct HashmapBucket *buckets =
+		(struct HashmapBucket *)HASHMAP_REALLOC(
+			NULL, capacity * sizeof(struct HashmapBucket));
+	if (buckets == NULL) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	memset((void *)buckets, 0, capacity * sizeof(struct HashmapBucket));
+
+	return buckets;
+}
+
+void hashmap_init(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_init but non-null argument expected.");
+	}
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+
+	/* Same number of entries as the other engines */
+	map->capacity =
+		HASHMAP_DEFAULT_CAPACITY / HASHMAP_CUCKOO_BUCKET_SIZE > 2 ?
+			HASHMAP_DEFAULT_CAPACITY / HASHMAP_CUCKOO_BUCKET_SIZE :
+			2;
+	map->buckets = hashmap_alloc_buckets(map->capacity);
+
+	/* Spread the raw entropy over every bit */
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));
+	HASHMAP_HASH_FMIX(map->seed);
+
+	hashmap_assert(map);
+}
+
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey)
+{
+	return COMPARISON_CALLBACK;
+}
+
+HASHMAP_INLINE int hashmap_compare_keys(CustomKey key1, CustomKey key2)
+{
+	int (*const callback)(CustomKey, CustomKey) = COMPARISON_CALLBACK;
+
+	if (callback == NULL) {
+		return memcmp((void *)&key1, (void *)&key2, sizeof(CustomKey));
+	}
+	return callback(key1, key2);
+}
+
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey)
+{
+	return HASH_CALLBACK;
+}
+
+HASHMAP_INLINE unsigned long hashmap_hash(const struct Hashmap *map,
+					  CustomKey key)
+{
+	unsigned long (*const callback)(CustomKey) = HASH_CALLBACK;
+
+	if (callback == NULL) {
+		return hashmap_hash_buf_seeded((const void *)&key,
+					       sizeof(CustomKey), map->seed);
+	}
+	return callback(key);
+}
+
+/* Second hash function: a MurmurHash3 finalizer over the first hash, so
+ * keys sharing a first bucket spread over different second buckets */
+unsigned long hashmap_alt_hash(unsigned long hash)
+{
+	hash = (hash ^ (hash >> 16)) & 0xFFFFFFFFUL;
+	hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+	hash ^= hash >> 13;
+	hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+/* Look for key in its two candidate buckets */
+int hashmap_find(const struct Hashmap *map, CustomKey key, size_t *bucket,
+		 unsigned int *entry)
+{
+	const struct HashmapBucket *candidate = NULL;
+	unsigned long hash = hashmap_hash(map, key);
+	size_t candidates[2];
+	size_t idx = 0;
+	unsigned int slot = 0;
+
+	candidates[0] = hash & (map->capacity - 1);
+	candidates[1] = hashmap_alt_hash(hash) & (map->capacity - 1);
+
+	for (idx = 0; idx < 2; idx++) {
+		candidate = &map->buckets[candidates[idx]];
+
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {
+			if ((candidate->occupied & (1U << slot)) != 0 &&
+			    hashmap_compare_keys(candidate->keys[slot], key) ==
+				    0) {
+				*bucket = candidates[idx];
+				*entry = slot;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Store an entry in a free slot of bucket. Returns 0 if bucket is full. */
+int hashmap_bucket_put(struct HashmapBucket *bucket, CustomKey key,
+		       CustomValue value)
+{
+	unsigned int slot = 0;
+
+	for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {
+		if ((bucket->occupied & (1U << slot)) == 0) {
+			bucket->keys[slot] = key;
+			bucket->values[slot] = value;
+			bucket->occupied |= 1U << slot;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* Place an entry known to be absent, evicting entries to their other bucket
+ * when both candidates are full. Returns 0 if the kick limit is reached, in
+ * which case key and value hold the entry left without a slot. */
+int hashmap_place(struct Hashmap *RESTRICT map, CustomKey *RESTRICT key,
+		  CustomValue *RESTRICT value)
+{
+	struct HashmapBucket *bucket = NULL;
+	CustomKey evicted_key;
+	CustomValue evicted_value;
+	unsigned long hash = hashmap_hash(map, *key);
+	size_t first = hash & (map->capacity - 1);
+	size_t second = hashmap_alt_hash(hash) & (map->capacity - 1);
+	unsigned int slot = 0;
+	size_t kicks = 0;
+
+	if (hashmap_bucket_put(&map->buckets[first], *key, *value) ||
+	    hashmap_bucket_put(&map->buckets[second], *key, *value)) {
+		return 1;
+	}
+
+	for (kicks = 0; kicks < HASHMAP_CUCKOO_MAX_KICKS; kicks++) {
+		/* Swap with a victim, rotating the slot to avoid cycles */
+		bucket = &map->buckets[first];
+		slot = (unsigned int)(kicks % HASHMAP_CUCKOO_BUCKET_SIZE);
+
+		evicted_key = bucket->keys[slot];
+		evicted_value = bucket->values[slot];
+		bucket->keys[slot] = *key;
+		bucket->values[slot] = *value;
+		*key = evicted_key;
+		*value = evicted_value;
+
+		/* Move the victim to its other candidate bucket */
+		hash = hashmap_hash(map, *key);
+		second = hash & (map->capacity - 1);
+		if (second == first) {
+			second = hashmap_alt_hash(hash) & (map->capacity - 1);
+		}
+
+		if (hashmap_bucket_put(&map->buckets[second], *key, *value)) {
+			return 1;
+		}
+
+		first = second;
+	}
+
+	return 0;
+}
+
+/* Returns the stash index of key, or stash_size if key is not stashed */
+size_t hashmap_stash_find(const struct Hashmap *map, CustomKey key)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < map->stash_size; idx++) {
+		if (hashmap_compare_keys(map->stash[idx].key, key) == 0) {
+			return idx;
+		}
+	}
+
+	return map->stash_size;
+}
+
+/* Append an entry known to be absent to the stash. Returns 0 if the stash is
+ * full. */
+int hashmap_stash_put(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	if (map->stash_size == HASHMAP_CUCKOO_STASH_SIZE) {
+		return 0;
+	}
+
+	map->stash[map->stash_size].key = key;
+	map->stash[map->stash_size].value = value;
+	map->stash_size++;
+
+	return 1;
+}
+
+/* Place every entry of map in new_map, stashing those finding no bucket.
+ * Returns 0 if the stash of new_map overflows. */
+int hashmap_move_entries(struct Hashmap *RESTRICT new_map,
+			 const struct Hashmap *RESTRICT map)
+{
+	const struct HashmapBucket *bucket = NULL;
+	CustomKey key;
+	CustomValue value;
+	size_t idx = 0;
+	unsigned int slot = 0;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		bucket = &map->buckets[idx];
+
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {
+			if ((bucket->occupied & (1U << slot)) == 0) {
+				continue;
+			}
+
+			key = bucket->keys[slot];
+			value = bucket->values[slot];
+			if (!hashmap_place(new_map, &key, &value) &&
+			    !hashmap_stash_put(new_map, key, value)) {
+				return 0;
+			}
+		}
+	}
+
+	/* Stashed entries may fit now */
+	for (idx = 0; idx < map->stash_size; idx++) {
+		key = map->stash[idx].key;
+		value = map->stash[idx].value;
+		if (!hashmap_place(new_map, &key, &value) &&
+		    !hashmap_stash_put(new_map, key, value)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Move every entry to a table of new_capacity buckets, doubling it while the
+ * entries finding no bucket overflow the stash */
+void hashmap_rehash(struct Hashmap *map, size_t new_capacity)
+{
+	struct Hashmap new_map = { 0 };
+
+	new_map.seed = map->seed;
+
+	for (;;) {
+		new_map.buckets = hashmap_alloc_buckets(new_capacity);
+		new_map.capacity = new_capacity;
+		new_map.stash_size = 0;
+
+		if (hashmap_move_entries(&new_map, map)) {
+			break;
+		}
+
+		HASHMAP_FREE((void *)new_map.buckets);
+
+		new_capacity <<= 1;
+		if (new_capacity < new_map.capacity ||
+		    new_capacity >
+			    ((size_t)-1) / sizeof(struct HashmapBucket)) {
+			hashmap_panic("Cannot grow hashmap. Panic.");
+		}
+		/* Keys still left over share hashes no capacity tells apart */
+		if (new_capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {
+			hashmap_panic("Too many colliding keys. Panic.");
+		}
+	}
+
+	new_map.size = map->size;
+	new_map.iteration_callback = map->iteration_callback;
+
+	HASHMAP_FREE((void *)map->buckets);
+	*map = new_map;
+
+	hashmap_assert(map);
+}
+
+void hashmap_grow(struct Hashmap *map)
+{
+	size_t new_capacity = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_grow but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	new_capacity = map->capacity << 1;
+
+	if (new_capacity < map->capacity) {
+		/* Overflow, do not grow */
+		return;
+	}
+	if (new_capacity > ((size_t)-1) / sizeof(struct HashmapBucket)) {
+		/* Would overflow, do not grow */
+		return;
+	}
+
+	hashmap_rehash(map, new_capacity);
+}
+
+int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	size_t bucket = 0;
+	size_t capacity = 0;
+	unsigned int entry = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		hashmap_init(map);
+	}
+
+	if (hashmap_find(map, key, &bucket, &entry)) {
+		/* Override existing value */
+		map->buckets[bucket].values[entry] = value;
+		return 1;
+	}
+
+	bucket = hashmap_stash_find(map, key);
+	if (bucket < map->stash_size) {
+		map->stash[bucket].value = value;
+		return 1;
+	}
+
+	/* Check for being above load factor */
+	if ((float)(map->size + 1) /
+		    (float)(map->capacity * HASHMAP_CUCKOO_BUCKET_SIZE) >
+	    HASHMAP_CUCKOO_LOAD_FACTOR) {
+		hashmap_grow(map);
+	}
+
+	/* Make room in the stash for an entry left out after too many kicks */
+	while (map->stash_size == HASHMAP_CUCKOO_STASH_SIZE) {
+		/* Stashed keys share hashes no capacity tells apart */
+		if (map->capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {
+			hashmap_panic("Too many colliding keys. Panic.");
+		}
+
+		capacity = map->capacity;
+		hashmap_grow(map);
+		if (map->capacity == capacity) {
+			hashmap_panic("Cannot grow hashmap. Panic.");
+		}
+	}
+
+	if (!hashmap_place(map, &key, &value)) {
+		hashmap_stash_put(map, key, value);
+	}
+
+	map->size++;
+
+	hashmap_assert(map);
+
+	return 0;
+}
+
+int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out)
+{
+	size_t bucket = 0;
+	unsigned int entry = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		return 0;
+	}
+
+	if (!hashmap_find(map, key, &bucket, &entry)) {
+		bucket = hashmap_stash_find(map, key);
+		if (bucket == map->stash_size) {
+			return 0;
+		}
+
+		if (out != NULL) {
+			*out = map->stash[bucket].value;
+		}
+
+		/* Fill the hole with the last stashed entry */
+		map->stash_size--;
+		map->stash[bucket] = map->stash[map->stash_size];
+
+		assert(map->size > 0);
+		map->size--;
+
+		return 1;
+	}
+
+	if (out != NULL) {
+		*out = map->buckets[bucket].values[entry];
+	}
+
+	map->buckets[bucket].occupied &= ~(1U << entry);
+
+	assert(map->size > 0);
+	map->size--;
+
+	return 1;
+}
+
+int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out)
+{
+	size_t bucket = 0;
+	unsigned int entry = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->buckets == NULL) {
+		return 0;
+	}
+
+	if (!hashmap_find(map, key, &bucket, &entry)) {
+		bucket = hashmap_stash_find(map, key);
+		if (bucket == map->stash_size) {
+			return 0;
+		}
+
+		if (out != NULL) {
+			*out = map->stash[bucket].value;
+		}
+
+		return 1;
+	}
+
+	if (out != NULL) {
+		*out = map->buckets[bucket].values[entry];
+	}
+
+	return 1;
+}
+
+int hashmap_has(const struct Hashmap *map, CustomKey key)
+{
+	return hashmap_get(map, key, NULL);
+}
+
+size_t hashmap_size(const Hashmap *map)
+{
+	return map->size;
+}
+
+void hashmap_free(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_free but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	HASHMAP_FREE((void *)map->buckets);
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+}
+
+void hashmap_iterate(struct Hashmap *map, void *context)
+{
+	struct HashmapBucket *bucket = NULL;
+	size_t idx = 0;
+	unsigned int slot = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iterate but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->iteration_callback == NULL) {
+		return;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		bucket = &map->buckets[idx];
+
+		for (slot = 0; slot < HASHMAP_CUCKOO_BUCKET_SIZE; slot++) {
+			if ((bucket->occupied & (1U << slot)) == 0) {
+				continue;
+			}
+
+			if (map->iteration_callback(bucket->keys[slot],
+						    bucket->values[slot],
+						    context) == 0) {
+				return;
+			}
+		}
+	}
+
+	for (idx = 0; idx < map->stash_size; idx++) {
+		if (map->iteration_callback(map->stash[idx].key,
+					    map->stash[idx].value,
+					    context) == 0) {
+			return;
+		}
+	}
+}
+
+void hashmap_duplicate(struct Hashmap *RESTRICT dest,
+		       struct Hashmap *RESTRICT src)
+{
+	if (dest == NULL || src == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_duplicate but non-null argument expected.");
+	}
+	hashmap_assert(src);
+
+	if (src->capacity == 0) {
+		memset(dest, 0, sizeof(struct Hashmap));
+		return;
+	}
+
+	dest->buckets = hashmap_alloc_buckets(src->capacity);
+	dest->capacity = src->capacity;
+	dest->size = src->size;
+	dest->iteration_callback = src->iteration_callback;
+	dest->seed = src->seed;
+
+	memcpy((void *)dest->buckets, (const void *)src->buckets,
+	       src->capacity * sizeof(struct HashmapBucket));
+
+	memcpy((void *)dest->stash, (const void *)src->stash,
+	       src->stash_size * sizeof(struct HashmapEntry));
+	dest->stash_size = src->stash_size;
+
+	hashmap_assert(dest);
+}
+
+void hashmap_clear(struct Hashmap *map)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_clear but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		map->buckets[idx].occupied = 0;
+	}
+
+	map->stash_size = 0;
+	map->size = 0;
+}
+
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	const unsigned char *bend = bptr + len;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; bptr < bend; bptr++) {
+		hval ^= (unsigned long)bptr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_fnv1a_32_str(const char *str)
+{
+	const unsigned char *ustr = (const unsigned char *)str;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; ustr[0] != '\0'; ustr++) {
+		hval ^= (unsigned long)ustr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_hash_buf(const void *buf, size_t len)
+{
+	return hashmap_hash_buf_seeded(buf, len, 0);
+}
+
+unsigned long hashmap_hash_str(const char *str)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), 0);
+}
+
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	unsigned long hash = seed;
+	unsigned long word = 0;
+	size_t left = len;
+
+	/* A whole word per multiply, instead of a byte */
+	for (; left >= HASHMAP_HASH_WORD_SIZE;
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {
+		/* The seed also goes into each word, so that colliding
+		 * words cannot be chosen without knowing it */
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);
+		hash = HASHMAP_HASH_STEP(hash);
+	}
+
+	/* Remaining bytes, as the low bytes of a word */
+	if (left > 0) {
+		while (left > 0) {
+			left--;
+			word = (word << 8) | (unsigned long)bptr[left];
+		}
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);
+	}
+
+	hash ^= (unsigned long)len;
+	HASHMAP_HASH_FMIX(hash);
+
+	return hash;
+}
+
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), seed);
+}
+/* Definitions stop here */
+
+#endif /* HASHMAP_CUCKOO_IN_H */
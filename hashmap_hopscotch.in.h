@@ -0,0 +1,794 @@
+/* hashmap_hopscotch.in.h - Hopscotch engine template for hashmap.h */
+#ifndef HASHMAP_HOPSCOTCH_IN_H
+#define HASHMAP_HOPSCOTCH_IN_H
+
+/* Template of HASHMAP_DECLARE_HOPSCOTCH() and HASHMAP_DEFINE_HOPSCOTCH().
+ *
+ * Like hashmap.in.h, this is a version of the engine with hardcoded types and
+ * function names. libgen.py turns the code between the markers into macros
+ * and appends them to hashmap.h, which provides the shared configuration.
+ *
+ * Open addressing where every key lives within HASHMAP_HOPSCOTCH_NEIGHBORHOOD
+ * slots of its home slot. Each home slot keeps a hop bitmap of which slots
+ * in its neighborhood hold its keys, and the bit past the bitmap flags
+ * whether the slot itself holds a key, so a lookup only compares the keys
+ * flagged in one bitmap over contiguous memory. Inserting moves the closest
+ * free slot back towards the home slot by displacing entries within their
+ * own neighborhood, and grows the table when no such move exists.
+ *
+ * An entry finding no slot goes to the stash, an array of
+ * HASHMAP_HOPSCOTCH_STASH_SIZE entries scanned by lookups missing the
+ * neighborhood. Inserting into a full stash grows the table first, and
+ * growing doubles the capacity again while the entries left out overflow the
+ * new stash. Keys sharing a full hash collide at every capacity, so more of
+ * them than a neighborhood holds make hashmap_insert() panic once the table
+ * would have HASHMAP_STASH_MAX_SPREAD slots per entry.
+ *
+ * With a NULL hash function, keys are hashed with hashmap_hash_buf_seeded()
+ * and the seed hashmap_init() picks for each map, as in hashmap.in.h. A hash
+ * function passed in is called as is, without the seed.
+ */
+
+#include "hashmap.h"
+
+#ifndef HASH_CALLBACK
+#define HASH_CALLBACK NULL
+#endif /* HASH_CALLBACK */
+
+#ifndef COMPARISON_CALLBACK
+#define COMPARISON_CALLBACK NULL
+#endif /* COMPARISON_CALLBACK */
+
+typedef int CustomValue;
+typedef const char *CustomKey;
+
+/* Declarations start here */
+
+struct HashmapSlot {
+	CustomKey key;
+	CustomValue value;
+	/* Bit n is set if slot (this + n) holds a key whose home is this slot,
+	 * and HASHMAP_HOPSCOTCH_OCCUPIED if this slot holds a key */
+	HASHMAP_HOP hop;
+};
+
+struct HashmapEntry {
+	CustomKey key;
+	CustomValue value;
+};
+
+typedef struct Hashmap {
+	struct HashmapSlot *slots;
+	int (*iteration_callback)(CustomKey key, CustomValue value,
+				  void *context);
+	size_t size;
+	size_t capacity;
+	/* Entries placed in no neighborhood, counted in size */
+	struct HashmapEntry stash[HASHMAP_HOPSCOTCH_STASH_SIZE];
+	size_t stash_size;
+	/* Mixed into default hashes, picked by hashmap_init() */
+	unsigned long seed;
+} Hashmap;
+
+/* API functions */
+void hashmap_init(Hashmap *map);
+void hashmap_grow(Hashmap *map);
+int hashmap_insert(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_remove(Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out);
+int hashmap_get(const Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out);
+int hashmap_has(const Hashmap *map, CustomKey key);
+size_t hashmap_size(const Hashmap *map);
+void hashmap_free(Hashmap *map);
+void hashmap_iterate(Hashmap *map, void *context);
+void hashmap_duplicate(Hashmap *RESTRICT dest, Hashmap *RESTRICT src);
+void hashmap_clear(Hashmap *map);
+
+/* Internal functions */
+void hashmap_assert(const Hashmap *map);
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey);
+int hashmap_compare_keys(CustomKey key1, CustomKey key2);
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey);
+unsigned long hashmap_hash(const Hashmap *map, CustomKey key);
+size_t hashmap_hash_index(const Hashmap *map, CustomKey key);
+size_t hashmap_find(const Hashmap *map, CustomKey key);
+int hashmap_place(Hashmap *map, CustomKey key, CustomValue value);
+size_t hashmap_stash_find(const Hashmap *map, CustomKey key);
+int hashmap_stash_put(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_move_entries(Hashmap *RESTRICT new_map,
+			 const Hashmap *RESTRICT map);
+struct HashmapSlot *hashmap_alloc_slots(size_t capacity);
+void hashmap_rehash(Hashmap *map, size_t new_capacity);
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len);
+unsigned long hashmap_fnv1a_32_str(const char *str);
+unsigned long hashmap_hash_buf(const void *buf, size_t len);
+unsigned long hashmap_hash_str(const char *str);
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed);
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed);
+/* Declarations stop here */
+
+/* Definitions start here */
+struct Hashmap;
+struct HashmapSlot;
+struct HashmapEntry;
+HASHMAP_DEFINE_PANIC(hashmap)
+
+void hashmap_assert(const struct Hashmap *map)
+{
+	/* If slots is NULL, map should be in initial/freed state */
+	if (map->slots == NULL) {
+		assert(map->size == 0);
+		assert(map->capacity == 0);
+		return;
+	}
+
+	/* Capacity must be a power of 2 covering a whole neighborhood */
+	assert(map->capacity >= HASHMAP_HOPSCOTCH_NEIGHBORHOOD);
+	assert((map->capacity & (map->capacity - 1)) == 0);
+
+	assert(map->stash_size <= HASHMAP_HOPSCOTCH_STASH_SIZE);
+	assert(map->stash_size <= map->size);
+
+	/* At least one slot must stay free */
+	assert(map->size - map->stash_size < map->capacity);
+}
+
+struct HashmapSlot *hashmap_alloc_slots(size_t capacity)
+{
+	struct HashmapSlot *slots = (struct HashmapSlot *)HASHMAP_REALLOC(
+		NULL, capacity * sizeof(struct HashmapSlot));
+	if (slots == NULL) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	memset((void *)slots, 0, capacity * sizeof(struct HashmapSlot));
+
+	return slots;
+}
+
+void hashmap_init(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_init but non-null argument expected.");
+	}
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+
+	/* A power of 2 covering a whole neighborhood */
+	map->capacity = HASHMAP_DEFAULT_CAPACITY > HASHMAP_HOPSCOTCH_NEIGHBORHOOD ?
+				HASHMAP_DEFAULT_CAPACITY :
+				HASHMAP_HOPSCOTCH_NEIGHBORHOOD + 1;
+	map->slots = hashmap_alloc_slots(map->capacity);
+
+	/* Spread the raw entropy over every bit */
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));
+	HASHMAP_HASH_FMIX(map->seed);
+
+	hashmap_assert(map);
+}
+
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey)
+{
+	return COMPARISON_CALLBACK;
+}
+
+HASHMAP_INLINE int hashmap_compare_keys(CustomKey key1, CustomKey key2)
+{
+	int (*const callback)(CustomKey, CustomKey) = COMPARISON_CALLBACK;
+
+	if (callback == NULL) {
+		return memcmp((void *)&key1, (void *)&key2, sizeof(CustomKey));
+	}
+	return callback(key1, key2);
+}
+
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey)
+{
+	return HASH_CALLBACK;
+}
+
+HASHMAP_INLINE unsigned long hashmap_hash(const struct Hashmap *map,
+					  CustomKey key)
+{
+	unsigned long (*const callback)(CustomKey) = HASH_CALLBACK;
+
+	if (callback == NULL) {
+		return hashmap_hash_buf_seeded((const void *)&key,
+					       sizeof(CustomKey), map->seed);
+	}
+	return callback(key);
+}
+
+HASHMAP_INLINE size_t hashmap_hash_index(const struct Hashmap *map,
+					  CustomKey key)
+{
+	return hashmap_hash(map, key) & (map->capacity - 1);
+}
+
+/* Returns the slot holding key, or capacity if key is absent */
+size_t hashmap_find(const struct Hashmap *map, CustomKey key)
+{
+	size_t home = hashmap_hash_index(map, key);
+	size_t idx = 0;
+	size_t distance = 0;
+	HASHMAP_HOP hop = map->slots[home].hop & ~HASHMAP_HOPSCOTCH_OCCUPIED;
+
+	for (distance = 0; hop != 0; distance++, hop >>= 1) {
+		if ((hop & 1U) == 0) {
+			continue;
+		}
+
+		idx = (home + distance) & (map->capacity - 1);
+		if (hashmap_compare_keys(map->slots[idx].key, key) == 0) {
+			return idx;
+		}
+	}
+
+	return map->capacity;
+}
+
+/* Place an entry known to be absent. Returns 0 if no free slot can be moved
+ * into its neighborhood. */
+int hashmap_place(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	struct HashmapSlot *slots = map->slots;
+	size_t mask = map->capacity - 1;
+	size_t home = hashmap_hash_index(map, key);
+	size_t distance = 0;
+	size_t free_idx = 0;
+	size_t candidate = 0;
+	size_t offset = 0;
+	size_t moved = 0;
+
+	/* Find the closest free slot */
+	while ((slots[(home + distance) & mask].hop &
+		HASHMAP_HOPSCOTCH_OCCUPIED) != 0) {
+		distance++;
+		if (distance >= map->capacity) {
+			return 0;
+		}
+	}
+
+	/* Hop the free slot back until it is in the neighborhood of home */
+	while (distance >= HASHMAP_HOPSCOTCH_NEIGHBORHOOD) {
+		free_idx = (home + distance) & mask;
+
+		/* Farthest home slot with a key stored before the free slot */
+		for (offset = HASHMAP_HOPSCOTCH_NEIGHBORHOOD - 1; offset > 0;
+		     offset--) {
+			candidate = (free_idx - offset) & mask;
+
+			for (moved = 0; moved < offset; moved++) {
+				if (slots[candidate].hop &
+				    ((HASHMAP_HOP)1 << moved)) {
+					break;
+				}
+			}
+
+			if (moved < offset) {
+				break;
+			}
+		}
+
+		if (offset == 0) {
+			return 0;
+		}
+
+		/* Move that key to the free slot, freeing its own */
+		slots[free_idx].key = slots[(candidate + moved) & mask].key;
+		slots[free_idx].value = slots[(candidate + moved) & mask].value;
+		slots[free_idx].hop |= HASHMAP_HOPSCOTCH_OCCUPIED;
+		slots[(candidate + moved) & mask].hop &=
+			~HASHMAP_HOPSCOTCH_OCCUPIED;
+		slots[candidate].hop &= ~((HASHMAP_HOP)1 << moved);
+		slots[candidate].hop |= (HASHMAP_HOP)1 << offset;
+
+		distance -= offset - moved;
+	}
+
+	free_idx = (home + distance) & mask;
+	slots[free_idx].key = key;
+	slots[free_idx].value = value;
+	slots[free_idx].hop |= HASHMAP_HOPSCOTCH_OCCUPIED;
+	slots[home].hop |= (HASHMAP_HOP)1 << distance;
+
+	return 1;
+}
+
+/* Returns the stash index of key, or stash_size if key is not stashed */
+size_t hashmap_stash_find(const struct Hashmap *map, CustomKey key)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < map->stash_size; idx++) {
+		if (hashmap_compare_keys(map->stash[idx].key, key) == 0) {
+			return idx;
+		}
+	}
+
+	return map->stash_size;
+}
+
+/* Append an entry known to be absent to the stash. Returns 0 if the stash is
+ * full. */
+int hashmap_stash_put(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	if (map->stash_size == HASHMAP_HOPSCOTCH_STASH_SIZE) {
+		return 0;
+	}
+
+	map->stash[map->stash_size].key = key;
+	map->stash[map->stash_size].value = value;
+	map->stash_size++;
+
+	return 1;
+}
+
+/* Place every entry of map in new_map, stashing those finding no slot in
+ * their neighborhood. Returns 0 if the stash of new_map overflows. */
+int hashmap_move_entries(struct Hashmap *RESTRICT new_map,
+			 const struct Hashmap *RESTRICT map)
+{
+	const struct HashmapSlot *slot = NULL;
+	const struct HashmapEntry *entry = NULL;
+	size_t idx = 0;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		slot = &map->slots[idx];
+		if ((slot->hop & HASHMAP_HOPSCOTCH_OCCUPIED) == 0) {
+			continue;
+		}
+
+		if (!hashmap_place(new_map, slot->key, slot->value) &&
+		    !hashmap_stash_put(new_map, slot->key, slot->value)) {
+			return 0;
+		}
+	}
+
+	/* Stashed entries may fit now */
+	for (idx = 0; idx < map->stash_size; idx++) {
+		entry = &map->stash[idx];
+		if (!hashmap_place(new_map, entry->key, entry->value) &&
+		    !hashmap_stash_put(new_map, entry->key, entry->value)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Move every entry to a table of new_capacity slots, doubling it while the
+ * entries finding no slot overflow the stash */
+void hashmap_rehash(struct Hashmap *map, size_t new_capacity)
+{
+	struct Hashmap new_map = { 0 };
+
+	new_map.seed = map->seed;
+
+	for (;;) {
+		new_map.slots = hashmap_alloc_slots(new_capacity);
+		new_map.capacity = new_capacity;
+		new_map.stash_size = 0;
+
+		if (hashmap_move_entries(&new_map, map)) {
+			break;
+		}
+
+		HASHMAP_FREE((void *)new_map.slots);
+
+		new_capacity <<= 1;
+		if (new_capacity < new_map.capacity ||
+		    new_capacity > ((size_t)-1) / sizeof(struct HashmapSlot)) {
+			hashmap_panic("Cannot grow hashmap. Panic.");
+		}
+		/* Keys still left over share hashes no capacity tells apart */
+		if (new_capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {
+			hashmap_panic("Too many colliding keys. Panic.");
+		}
+	}
+
+	new_map.size = map->size;
+	new_map.iteration_callback = map->iteration_callback;
+
+	HASHMAP_FREE((void *)map->slots);
+	*map = new_map;
+
+	hashmap_assert(map);
+}
+
+void hashmap_grow(struct Hashmap *map)
+{
+	size_t new_capacity = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_grow but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	new_capacity = map->capacity << 1;
+
+	if (new_capacity < map->capacity) {
+		/* Overflow, do not grow */
+		return;
+	}
+	if (new_capacity > ((size_t)-1) / sizeof(struct HashmapSlot)) {
+		/* Would overflow, do not grow */
+		return;
+	}
+
+	hashmap_rehash(map, new_capacity);
+}
+
+int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	size_t idx = 0;
+	size_t capacity = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	idx = hashmap_find(map, key);
+	if (idx != map->capacity) {
+		/* Override existing value */
+		map->slots[idx].value = value;
+		return 1;
+	}
+
+	idx = hashmap_stash_find(map, key);
+	if (idx < map->stash_size) {
+		map->stash[idx].value = value;
+		return 1;
+	}
+
+	/* Check for being above load factor */
+	if ((float)(map->size + 1) / (float)map->capacity >
+	    HASHMAP_HOPSCOTCH_LOAD_FACTOR) {
+		hashmap_grow(map);
+	}
+
+	/* Make room in the stash for a key finding no slot in its
+	 * neighborhood */
+	while (map->stash_size == HASHMAP_HOPSCOTCH_STASH_SIZE) {
+		/* Stashed keys share hashes no capacity tells apart */
+		if (map->capacity / HASHMAP_STASH_MAX_SPREAD > map->size) {
+			hashmap_panic("Too many colliding keys. Panic.");
+		}
+
+		capacity = map->capacity;
+		hashmap_grow(map);
+		if (map->capacity == capacity) {
+			hashmap_panic("Cannot grow hashmap. Panic.");
+		}
+	}
+
+	if (!hashmap_place(map, key, value)) {
+		hashmap_stash_put(map, key, value);
+	}
+
+	map->size++;
+
+	hashmap_assert(map);
+
+	return 0;
+}
+
+int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+	size_t home = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key);
+	if (idx == map->capacity) {
+		idx = hashmap_stash_find(map, key);
+		if (idx == map->stash_size) {
+			return 0;
+		}
+
+		if (out != NULL) {
+			*out = map->stash[idx].value;
+		}
+
+		/* Fill the hole with the last stashed entry */
+		map->stash_size--;
+		map->stash[idx] = map->stash[map->stash_size];
+
+		assert(map->size > 0);
+		map->size--;
+
+		return 1;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	home = hashmap_hash_index(map, key);
+	map->slots[home].hop &=
+		~((HASHMAP_HOP)1 << ((idx - home) & (map->capacity - 1)));
+	map->slots[idx].hop &= ~HASHMAP_HOPSCOTCH_OCCUPIED;
+
+	assert(map->size > 0);
+	map->size--;
+
+	return 1;
+}
+
+int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key);
+	if (idx == map->capacity) {
+		idx = hashmap_stash_find(map, key);
+		if (idx == map->stash_size) {
+			return 0;
+		}
+
+		if (out != NULL) {
+			*out = map->stash[idx].value;
+		}
+
+		return 1;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	return 1;
+}
+
+int hashmap_has(const struct Hashmap *map, CustomKey key)
+{
+	return hashmap_get(map, key, NULL);
+}
+
+size_t hashmap_size(const Hashmap *map)
+{
+	return map->size;
+}
+
+void hashmap_free(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_free but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	HASHMAP_FREE((void *)map->slots);
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+}
+
+void hashmap_iterate(struct Hashmap *map, void *context)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iterate but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->iteration_callback == NULL) {
+		return;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if ((map->slots[idx].hop & HASHMAP_HOPSCOTCH_OCCUPIED) == 0) {
+			continue;
+		}
+
+		if (map->iteration_callback(map->slots[idx].key,
+					    map->slots[idx].value,
+					    context) == 0) {
+			return;
+		}
+	}
+
+	for (idx = 0; idx < map->stash_size; idx++) {
+		if (map->iteration_callback(map->stash[idx].key,
+					    map->stash[idx].value,
+					    context) == 0) {
+			return;
+		}
+	}
+}
+
+void hashmap_duplicate(struct Hashmap *RESTRICT dest,
+		       struct Hashmap *RESTRICT src)
+{
+	if (dest == NULL || src == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_duplicate but non-null argument expected.");
+	}
+	hashmap_assert(src);
+
+	if (src->capacity == 0) {
+		memset(dest, 0, sizeof(struct Hashmap));
+		return;
+	}
+
+	dest->slots = hashmap_alloc_slots(src->capacity);
+	dest->capacity = src->capacity;
+	dest->size = src->size;
+	dest->iteration_callback = src->iteration_callback;
+	dest->seed = src->seed;
+
+	memcpy((void *)dest->slots, (const void *)src->slots,
+	       src->capacity * sizeof(struct HashmapSlot));
+
+	memcpy((void *)dest->stash, (const void *)src->stash,
+	       src->stash_size * sizeof(struct HashmapEntry));
+	dest->stash_size = src->stash_size;
+
+	hashmap_assert(dest);
+}
+
+void hashmap_clear(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_clear but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots != NULL) {
+		memset((void *)map->slots, 0,
+		       map->capacity * sizeof(struct HashmapSlot));
+	}
+
+	map->stash_size = 0;
+	map->size = 0;
+}
+
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	const unsigned char *bend = bptr + len;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; bptr < bend; bptr++) {
+		hval ^= (unsigned long)bptr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_fnv1a_32_str(const char *str)
+{
+	const unsigned char *ustr = (const unsigned char *)str;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; ustr[0] != '\0'; ustr++) {
+		hval ^= (unsigned long)ustr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_hash_buf(const void *buf, size_t len)
+{
+	return hashmap_hash_buf_seeded(buf, len, 0);
+}
+
+unsigned long hashmap_hash_str(const char *str)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), 0);
+}
+
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	unsigned long hash = seed;
+	unsigned long word = 0;
+	size_t left = len;
+
+	/* A whole word per multiply, instead of a byte */
+	for (; left >= HASHMAP_HASH_WORD_SIZE;
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {
+		/* The seed also goes into each word, so that colliding
+		 * words cannot be chosen without knowing it */
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);
+		hash = HASHMAP_HASH_STEP(hash);
+	}
+
+	/* Remaining bytes, as the low bytes of a word */
+	if (left > 0) {
+		while (left > 0) {
+			left--;
+			word = (word << 8) | (unsigned long)bptr[left];
+		}
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);
+	}
+
+	hash ^= (unsigned long)len;
+	HASHMAP_HASH_FMIX(hash);
+
+	return hash;
+}
+
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), seed);
+}
+/* Definitions stop here */
+
+#endif /* HASHMAP_HOPSCOTCH_IN_H */
@@ -0,0 +1,616 @@
+/* hashmap_robinhood.in.h - Robin Hood engine template for hashmap.h */
+#ifndef HASHMAP_ROBINHOOD_IN_H
+#define HASHMAP_ROBINHOOD_IN_H
+
+/* Template of HASHMAP_DECLARE_ROBINHOOD() and HASHMAP_DEFINE_ROBINHOOD().
+ *
+ * Like hashmap.in.h, this is a version of the engine with hardcoded types and
+ * function names. libgen.py turns the code between the markers into macros
+ * and appends them to hashmap.h, which provides the shared configuration.
+ *
+ * Entries live in a flat array of slots using open addressing with linear
+ * probing. Each slot records its probe sequence length (distance from its
+ * home slot, plus one so that 0 marks an empty slot). Insertion steals the
+ * slot of any entry closer to its home than the entry being placed, which
+ * keeps probe sequences short and lets lookups stop early. Removal shifts the
+ * following entries back instead of leaving tombstones.
+ *
+ * With a NULL hash function, keys are hashed with hashmap_hash_buf_seeded()
+ * and the seed hashmap_init() picks for each map, as in hashmap.in.h. A hash
+ * function passed in is called as is, without the seed.
+ */
+
+#include "hashmap.h"
+
+#ifndef HASH_CALLBACK
+#define HASH_CALLBACK NULL
+#endif /* HASH_CALLBACK */
+
+#ifndef COMPARISON_CALLBACK
+#define COMPARISON_CALLBACK NULL
+#endif /* COMPARISON_CALLBACK */
+
+typedef int CustomValue;
+typedef const char *CustomKey;
+
+/* Declarations start here */
+
+struct HashmapSlot {
+	CustomKey key;
+	CustomValue value;
+	/* Distance from the home slot plus one, 0 if the slot is empty */
+	unsigned int psl;
+};
+
+typedef struct Hashmap {
+	struct HashmapSlot *slots;
+	int (*iteration_callback)(CustomKey key, CustomValue value,
+				  void *context);
+	size_t size;
+	size_t capacity;
+	/* Mixed into default hashes, picked by hashmap_init() */
+	unsigned long seed;
+} Hashmap;
+
+/* API functions */
+void hashmap_init(Hashmap *map);
+void hashmap_grow(Hashmap *map);
+int hashmap_insert(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_remove(Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out);
+int hashmap_get(const Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out);
+int hashmap_has(const Hashmap *map, CustomKey key);
+size_t hashmap_size(const Hashmap *map);
+void hashmap_free(Hashmap *map);
+void hashmap_iterate(Hashmap *map, void *context);
+void hashmap_duplicate(Hashmap *RESTRICT dest, Hashmap *RESTRICT src);
+void hashmap_clear(Hashmap *map);
+
+/* Internal functions */
+void hashmap_assert(const Hashmap *map);
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey);
+int hashmap_compare_keys(CustomKey key1, CustomKey key2);
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey);
+unsigned long hashmap_hash(const Hashmap *map, CustomKey key);
+size_t hashmap_hash_index(const Hashmap *map, CustomKey key);
+size_t hashmap_find(const Hashmap *map, CustomKey key);
+void hashmap_place(Hashmap *map, size_t idx, struct HashmapSlot entry);
+struct HashmapSlot *hashmap_alloc_slots(size_t capacity);
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len);
+unsigned long hashmap_fnv1a_32_str(const char *str);
+unsigned long hashmap_hash_buf(const void *buf, size_t len);
+unsigned long hashmap_hash_str(const char *str);
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed);
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed);
+/* Declarations stop here */
+
+/* Definitions start here */
+struct Hashmap;
+struct HashmapSlot;
+HASHMAP_DEFINE_PANIC(hashmap)
+
+void hashmap_assert(const struct Hashmap *map)
+{
+	/* If slots is NULL, map should be in initial/freed state */
+	if (map->slots == NULL) {
+		assert(map->size == 0);
+		assert(map->capacity == 0);
+		return;
+	}
+
+	/* Capacity must be a power of 2 and non-zero */
+	assert(map->capacity > 0);
+	assert((map->capacity & (map->capacity - 1)) == 0);
+
+	/* At least one slot is always empty, which ends every probe */
+	assert(map->size < map->capacity);
+}
+
+struct HashmapSlot *hashmap_alloc_slots(size_t capacity)
+{
+	struct HashmapSlot *slots = (struct HashmapSlot *)HASHMAP_REALLOC(
+		NULL, capacity * sizeof(struct HashmapSlot));
+	if (slots == NULL) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	memset((void *)slots, 0, capacity * sizeof(struct HashmapSlot));
+
+	return slots;
+}
+
+void hashmap_init(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_init but non-null argument expected.");
+	}
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+
+	map->slots = hashmap_alloc_slots(HASHMAP_DEFAULT_CAPACITY);
+	map->capacity = HASHMAP_DEFAULT_CAPACITY;
+
+	/* Spread the raw entropy over every bit */
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));
+	HASHMAP_HASH_FMIX(map->seed);
+
+	hashmap_assert(map);
+}
+
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey)
+{
+	return COMPARISON_CALLBACK;
+}
+
+HASHMAP_INLINE int hashmap_compare_keys(CustomKey key1, CustomKey key2)
+{
+	int (*const callback)(CustomKey, CustomKey) = COMPARISON_CALLBACK;
+
+	if (callback == NULL) {
+		return memcmp((void *)&key1, (void *)&key2, sizeof(CustomKey));
+	}
+	return callback(key1, key2);
+}
+
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey)
+{
+	return HASH_CALLBACK;
+}
+
+HASHMAP_INLINE unsigned long hashmap_hash(const struct Hashmap *map,
+					  CustomKey key)
+{
+	unsigned long (*const callback)(CustomKey) = HASH_CALLBACK;
+
+	if (callback == NULL) {
+		return hashmap_hash_buf_seeded((const void *)&key,
+					       sizeof(CustomKey), map->seed);
+	}
+	return callback(key);
+}
+
+HASHMAP_INLINE size_t hashmap_hash_index(const struct Hashmap *map,
+					  CustomKey key)
+{
+	return hashmap_hash(map, key) & (map->capacity - 1);
+}
+
+/* Return the slot index holding key, or map->capacity if it is absent */
+size_t hashmap_find(const struct Hashmap *map, CustomKey key)
+{
+	const struct HashmapSlot *slot = NULL;
+	size_t idx = hashmap_hash_index(map, key);
+	unsigned int psl = 1;
+
+	for (;; idx = (idx + 1) & (map->capacity - 1), psl++) {
+		slot = &map->slots[idx];
+
+		/* Key would have displaced this entry, it cannot be further */
+		if (slot->psl < psl) {
+			return map->capacity;
+		}
+
+		if (slot->psl == psl &&
+		    hashmap_compare_keys(slot->key, key) == 0) {
+			return idx;
+		}
+	}
+}
+
+/* Place an entry known to be absent, starting the probe at idx */
+void hashmap_place(struct Hashmap *map, size_t idx, struct HashmapSlot entry)
+{
+	struct HashmapSlot *slot = NULL;
+	struct HashmapSlot displaced;
+
+	for (;; idx = (idx + 1) & (map->capacity - 1), entry.psl++) {
+		if (entry.psl == (unsigned int)-1) {
+			hashmap_panic("Probe sequence too long. Panic.");
+		}
+
+		slot = &map->slots[idx];
+
+		if (slot->psl == 0) {
+			*slot = entry;
+			return;
+		}
+
+		/* Take from the rich: the resident is closer to its home */
+		if (slot->psl < entry.psl) {
+			displaced = *slot;
+			*slot = entry;
+			entry = displaced;
+		}
+	}
+}
+
+void hashmap_grow(struct Hashmap *map)
+{
+	size_t new_capacity = 0;
+	size_t idx = 0;
+	struct Hashmap new_map = { 0 };
+	struct HashmapSlot entry;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_grow but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	/* Calculate the next power of 2 */
+	new_capacity = map->capacity;
+	new_capacity |= new_capacity >> 1;
+	new_capacity |= new_capacity >> 2;
+	new_capacity |= new_capacity >> 4;
+	new_capacity |= new_capacity >> 8;
+	if (sizeof(size_t) >= 4) {
+		new_capacity |= new_capacity >> 16;
+	}
+	if (sizeof(size_t) >= 8) {
+		new_capacity |= new_capacity >> 32;
+	}
+	new_capacity++;
+
+	if (new_capacity < map->capacity) {
+		/* Overflow, do not grow */
+		return;
+	}
+	if (new_capacity > ((size_t)-1) / sizeof(struct HashmapSlot)) {
+		/* Would overflow, do not grow */
+		return;
+	}
+
+	new_map.slots = hashmap_alloc_slots(new_capacity);
+	new_map.capacity = new_capacity;
+	new_map.size = map->size;
+	new_map.iteration_callback = map->iteration_callback;
+	new_map.seed = map->seed;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if (map->slots[idx].psl == 0) {
+			continue;
+		}
+
+		entry = map->slots[idx];
+		entry.psl = 1;
+		hashmap_place(&new_map, hashmap_hash_index(&new_map, entry.key),
+			      entry);
+	}
+
+	HASHMAP_FREE((void *)map->slots);
+	*map = new_map;
+
+	hashmap_assert(map);
+}
+
+int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	struct HashmapSlot *slot = NULL;
+	struct HashmapSlot entry;
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	/* Check for being above load factor */
+	if ((float)(map->size + 1) / (float)map->capacity >
+	    HASHMAP_ROBINHOOD_LOAD_FACTOR) {
+		hashmap_grow(map);
+	}
+
+	entry.key = key;
+	entry.value = value;
+	entry.psl = 1;
+	idx = hashmap_hash_index(map, key);
+
+	/* Look for the key until the probe reaches a richer slot, which is
+	 * where the key would have been placed */
+	for (;; idx = (idx + 1) & (map->capacity - 1), entry.psl++) {
+		slot = &map->slots[idx];
+
+		if (slot->psl < entry.psl) {
+			break;
+		}
+
+		if (slot->psl == entry.psl &&
+		    hashmap_compare_keys(slot->key, key) == 0) {
+			/* Override existing value */
+			slot->value = value;
+			return 1;
+		}
+	}
+
+	assert(map->size + 1 < map->capacity);
+
+	hashmap_place(map, idx, entry);
+	map->size++;
+
+	return 0;
+}
+
+int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+	size_t next = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key);
+	if (idx == map->capacity) {
+		return 0;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	/* Backward shift deletion: pull the following displaced entries one
+	 * slot closer to their home instead of leaving a tombstone */
+	for (next = (idx + 1) & (map->capacity - 1); map->slots[next].psl > 1;
+	     idx = next, next = (next + 1) & (map->capacity - 1)) {
+		map->slots[idx] = map->slots[next];
+		map->slots[idx].psl--;
+	}
+
+	map->slots[idx].psl = 0;
+
+	assert(map->size > 0);
+	map->size--;
+
+	return 1;
+}
+
+int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key);
+	if (idx == map->capacity) {
+		return 0;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	return 1;
+}
+
+int hashmap_has(const struct Hashmap *map, CustomKey key)
+{
+	return hashmap_get(map, key, NULL);
+}
+
+size_t hashmap_size(const Hashmap *map)
+{
+	return map->size;
+}
+
+void hashmap_free(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_free but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	HASHMAP_FREE((void *)map->slots);
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+}
+
+void hashmap_iterate(struct Hashmap *map, void *context)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iterate but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->iteration_callback == NULL) {
+		return;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if (map->slots[idx].psl == 0) {
+			continue;
+		}
+
+		if (map->iteration_callback(map->slots[idx].key,
+					    map->slots[idx].value,
+					    context) == 0) {
+			break;
+		}
+	}
+}
+
+void hashmap_duplicate(struct Hashmap *RESTRICT dest,
+		       struct Hashmap *RESTRICT src)
+{
+	if (dest == NULL || src == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_duplicate but non-null argument expected.");
+	}
+	hashmap_assert(src);
+
+	if (src->capacity == 0) {
+		memset(dest, 0, sizeof(struct Hashmap));
+		return;
+	}
+
+	dest->slots = hashmap_alloc_slots(src->capacity);
+	dest->capacity = src->capacity;
+	dest->size = src->size;
+	dest->iteration_callback = src->iteration_callback;
+	dest->seed = src->seed;
+
+	memcpy((void *)dest->slots, (const void *)src->slots,
+	       src->capacity * sizeof(struct HashmapSlot));
+
+	hashmap_assert(dest);
+}
+
+void hashmap_clear(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_clear but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots != NULL) {
+		memset((void *)map->slots, 0,
+		       map->capacity * sizeof(struct HashmapSlot));
+	}
+
+	map->size = 0;
+}
+
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	const unsigned char *bend = bptr + len;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; bptr < bend; bptr++) {
+		hval ^= (unsigned long)bptr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_fnv1a_32_str(const char *str)
+{
+	const unsigned char *ustr = (const unsigned char *)str;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; ustr[0] != '\0'; ustr++) {
+		hval ^= (unsigned long)ustr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_hash_buf(const void *buf, size_t len)
+{
+	return hashmap_hash_buf_seeded(buf, len, 0);
+}
+
+unsigned long hashmap_hash_str(const char *str)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), 0);
+}
+
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	unsigned long hash = seed;
+	unsigned long word = 0;
+	size_t left = len;
+
+	/* A whole word per multiply, instead of a byte */
+	for (; left >= HASHMAP_HASH_WORD_SIZE;
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {
+		/* The seed also goes into each word, so that colliding
+		 * words cannot be chosen without knowing it */
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);
+		hash = HASHMAP_HASH_STEP(hash);
+	}
+
+	/* Remaining bytes, as the low bytes of a word */
+	if (left > 0) {
+		while (left > 0) {
+			left--;
+			word = (word << 8) | (unsigned long)bptr[left];
+		}
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);
+	}
+
+	hash ^= (unsigned long)len;
+	HASHMAP_HASH_FMIX(hash);
+
+	return hash;
+}
+
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), seed);
+}
+/* Definitions stop here */
+
+#endif /* HASHMAP_ROBINHOOD_IN_H */
@@ -0,0 +1,700 @@
+/* hashmap_swiss.in.h - SwissTable engine template for hashmap.h */
+#ifndef HASHMAP_SWISS_IN_H
+#define HASHMAP_SWISS_IN_H
+
+/* Template of HASHMAP_DECLARE_SWISS() and HASHMAP_DEFINE_SWISS().
+ *
+ * Like hashmap.in.h, this is a version of the engine with hardcoded types and
+ * function names. libgen.py turns the code between the markers into macros
+ * and appends them to hashmap.h, which provides the shared configuration.
+ *
+ * Slots are split in groups of HASHMAP_SWISS_GROUP_SIZE. Each slot has a
+ * control byte: HASHMAP_SWISS_EMPTY, HASHMAP_SWISS_DELETED, or the low 7 bits
+ * of the hash of its key (high bit clear). A lookup compares the fingerprint
+ * against a whole group of control bytes at once (SSE2, or SWAR without it),
+ * and only compares keys of the matching slots. Groups are probed with
+ * triangular steps until one holds an empty slot.
+ *
+ * With a NULL hash function, keys are hashed with hashmap_hash_buf_seeded()
+ * and the seed hashmap_init() picks for each map, as in hashmap.in.h. A hash
+ * function passed in is called as is, without the seed.
+ */
+
+#include "hashmap.h"
+
+#ifndef HASH_CALLBACK
+#define HASH_CALLBACK NULL
+#endif /* HASH_CALLBACK */
+
+#ifndef COMPARISON_CALLBACK
+#define COMPARISON_CALLBACK NULL
+#endif /* COMPARISON_CALLBACK */
+
+typedef int CustomValue;
+typedef const char *CustomKey;
+
+/* Declarations start here */
+
+struct HashmapSlot {
+	CustomKey key;
+	CustomValue value;
+};
+
+typedef struct Hashmap {
+	/* Single allocation: capacity slots followed by capacity control bytes */
+	struct HashmapSlot *slots;
+	unsigned char *ctrl;
+	int (*iteration_callback)(CustomKey key, CustomValue value,
+				  void *context);
+	size_t size;
+	size_t capacity;
+	size_t deleted;
+	/* Mixed into default hashes, picked by hashmap_init() */
+	unsigned long seed;
+} Hashmap;
+
+/* API functions */
+void hashmap_init(Hashmap *map);
+void hashmap_grow(Hashmap *map);
+int hashmap_insert(Hashmap *map, CustomKey key, CustomValue value);
+int hashmap_remove(Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out);
+int hashmap_get(const Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out);
+int hashmap_has(const Hashmap *map, CustomKey key);
+size_t hashmap_size(const Hashmap *map);
+void hashmap_free(Hashmap *map);
+void hashmap_iterate(Hashmap *map, void *context);
+void hashmap_duplicate(Hashmap *RESTRICT dest, Hashmap *RESTRICT src);
+void hashmap_clear(Hashmap *map);
+
+/* Internal functions */
+void hashmap_assert(const Hashmap *map);
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey);
+int hashmap_compare_keys(CustomKey key1, CustomKey key2);
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey);
+unsigned long hashmap_hash(const Hashmap *map, CustomKey key);
+unsigned long hashmap_group_word(const unsigned char *bytes);
+unsigned int hashmap_word_mask(unsigned long high_bits, size_t offset);
+unsigned int hashmap_group_match(const unsigned char *group,
+				 unsigned int byte);
+unsigned int hashmap_group_match_free(const unsigned char *group);
+size_t hashmap_find(const Hashmap *map, CustomKey key, unsigned long hash);
+size_t hashmap_find_free(const Hashmap *map, unsigned long hash);
+void hashmap_alloc(Hashmap *map, size_t capacity);
+void hashmap_rehash(Hashmap *map, size_t new_capacity);
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len);
+unsigned long hashmap_fnv1a_32_str(const char *str);
+unsigned long hashmap_hash_buf(const void *buf, size_t len);
+unsigned long hashmap_hash_str(const char *str);
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed);
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed);
+/* Declarations stop here */
+
+/* Definitions start here */
+struct Hashmap;
+struct HashmapSlot;
+HASHMAP_DEFINE_PANIC(hashmap)
+
+void hashmap_assert(const struct Hashmap *map)
+{
+	/* If slots is NULL, map should be in initial/freed state */
+	if (map->slots == NULL) {
+		assert(map->ctrl == NULL);
+		assert(map->size == 0);
+		assert(map->deleted == 0);
+		assert(map->capacity == 0);
+		return;
+	}
+
+	/* Capacity must be a power of 2 holding whole groups */
+	assert(map->capacity >= HASHMAP_SWISS_GROUP_SIZE);
+	assert((map->capacity & (map->capacity - 1)) == 0);
+	assert(map->ctrl == (unsigned char *)(map->slots + map->capacity));
+
+	/* Empty slots must remain so that every probe terminates */
+	assert(map->size + map->deleted < map->capacity);
+}
+
+/* Allocate an empty table, leaving size and tombstone counts untouched */
+void hashmap_alloc(struct Hashmap *map, size_t capacity)
+{
+	map->slots = (struct HashmapSlot *)HASHMAP_REALLOC(
+		NULL, capacity * (sizeof(struct HashmapSlot) + 1));
+	if (map->slots == NULL) {
+		hashmap_panic("Out of memory. Panic.");
+	}
+
+	map->ctrl = (unsigned char *)(map->slots + capacity);
+	map->capacity = capacity;
+
+	memset((void *)map->ctrl, HASHMAP_SWISS_EMPTY, capacity);
+}
+
+void hashmap_init(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_init but non-null argument expected.");
+	}
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+
+	if (HASHMAP_DEFAULT_CAPACITY > HASHMAP_SWISS_GROUP_SIZE) {
+		hashmap_alloc(map, HASHMAP_DEFAULT_CAPACITY);
+	} else {
+		hashmap_alloc(map, HASHMAP_SWISS_GROUP_SIZE);
+	}
+
+	/* Spread the raw entropy over every bit */
+	map->seed = (unsigned long)(HASHMAP_SEED_SOURCE(map));
+	HASHMAP_HASH_FMIX(map->seed);
+
+	hashmap_assert(map);
+}
+
+int (*hashmap_compare_comparison_callback(void))(CustomKey, CustomKey)
+{
+	return COMPARISON_CALLBACK;
+}
+
+HASHMAP_INLINE int hashmap_compare_keys(CustomKey key1, CustomKey key2)
+{
+	int (*const callback)(CustomKey, CustomKey) = COMPARISON_CALLBACK;
+
+	if (callback == NULL) {
+		return memcmp((void *)&key1, (void *)&key2, sizeof(CustomKey));
+	}
+	return callback(key1, key2);
+}
+
+unsigned long (*hashmap_compare_hash_callback(void))(CustomKey)
+{
+	return HASH_CALLBACK;
+}
+
+HASHMAP_INLINE unsigned long hashmap_hash(const struct Hashmap *map,
+					  CustomKey key)
+{
+	unsigned long (*const callback)(CustomKey) = HASH_CALLBACK;
+
+	if (callback == NULL) {
+		return hashmap_hash_buf_seeded((const void *)&key,
+					       sizeof(CustomKey), map->seed);
+	}
+	return callback(key);
+}
+
+/* Load bytes into a word in an endianness independent order */
+unsigned long hashmap_group_word(const unsigned char *bytes)
+{
+	unsigned long word = 0;
+	size_t idx = 0;
+
+	for (idx = 0; idx < sizeof(unsigned long); idx++) {
+		word |= (unsigned long)bytes[idx] << (8 * idx);
+	}
+
+	return word;
+}
+
+/* Gather the high bit of each byte of a word into a slot bitmask */
+unsigned int hashmap_word_mask(unsigned long high_bits, size_t offset)
+{
+	unsigned int mask = 0;
+	size_t idx = 0;
+
+	for (idx = 0; idx < sizeof(unsigned long); idx++) {
+		if ((high_bits >> (8 * idx + 7)) & 1UL) {
+			mask |= 1U << (offset + idx);
+		}
+	}
+
+	return mask;
+}
+
+/* Bitmask of the slots of a group whose control byte equals byte */
+unsigned int hashmap_group_match(const unsigned char *group, unsigned int byte)
+{
+	const unsigned long ones = (unsigned long)-1 / 0xFF;
+	const unsigned long low_bits = ones * 0x7F;
+	unsigned long word = 0;
+	unsigned int mask = 0;
+	size_t idx = 0;
+
+	if (HASHMAP_SSE2) {
+		return HASHMAP_SSE2_MATCH(group, byte);
+	}
+
+	/* SWAR fallback: bytes equal to byte become zero, then exactly the
+	 * zero bytes get their high bit set */
+	for (idx = 0; idx < HASHMAP_SWISS_GROUP_SIZE;
+	     idx += sizeof(unsigned long)) {
+		word = hashmap_group_word(group + idx) ^ (ones * byte);
+		word = ~(((word & low_bits) + low_bits) | word | low_bits);
+		mask |= hashmap_word_mask(word, idx);
+	}
+
+	return mask;
+}
+
+/* Bitmask of the empty or deleted slots of a group (high bit set) */
+unsigned int hashmap_group_match_free(const unsigned char *group)
+{
+	const unsigned long high_bits = (unsigned long)-1 / 0xFF * 0x80;
+	unsigned int mask = 0;
+	size_t idx = 0;
+
+	if (HASHMAP_SSE2) {
+		return HASHMAP_SSE2_MATCH_HIGH(group);
+	}
+
+	for (idx = 0; idx < HASHMAP_SWISS_GROUP_SIZE;
+	     idx += sizeof(unsigned long)) {
+		mask |= hashmap_word_mask(
+			hashmap_group_word(group + idx) & high_bits, idx);
+	}
+
+	return mask;
+}
+
+/* Return the slot index holding key, or map->capacity if it is absent */
+size_t hashmap_find(const struct Hashmap *map, CustomKey key,
+		    unsigned long hash)
+{
+	const size_t group_mask = map->capacity / HASHMAP_SWISS_GROUP_SIZE - 1;
+	size_t group = (hash >> 7) & group_mask;
+	size_t step = 0;
+	size_t base = 0;
+	unsigned int match = 0;
+	unsigned int bit = 0;
+
+	for (;; step++, group = (group + step) & group_mask) {
+		base = group * HASHMAP_SWISS_GROUP_SIZE;
+		match = hashmap_group_match(map->ctrl + base,
+					    (unsigned int)(hash & 0x7F));
+
+		for (bit = 0; match != 0; bit++, match >>= 1) {
+			if ((match & 1U) != 0 &&
+			    hashmap_compare_keys(map->slots[base + bit].key,
+						 key) == 0) {
+				return base + bit;
+			}
+		}
+
+		/* An empty slot ends the probe: key would have been there */
+		if (hashmap_group_match(map->ctrl + base,
+					HASHMAP_SWISS_EMPTY) != 0) {
+			return map->capacity;
+		}
+
+		assert(step < map->capacity / HASHMAP_SWISS_GROUP_SIZE);
+	}
+}
+
+/* Return the first empty or deleted slot on the probe sequence of hash */
+size_t hashmap_find_free(const struct Hashmap *map, unsigned long hash)
+{
+	const size_t group_mask = map->capacity / HASHMAP_SWISS_GROUP_SIZE - 1;
+	size_t group = (hash >> 7) & group_mask;
+	size_t step = 0;
+	size_t base = 0;
+	unsigned int match = 0;
+	unsigned int bit = 0;
+
+	for (;; step++, group = (group + step) & group_mask) {
+		base = group * HASHMAP_SWISS_GROUP_SIZE;
+		match = hashmap_group_match_free(map->ctrl + base);
+
+		if (match != 0) {
+			for (bit = 0; (match & 1U) == 0; bit++, match >>= 1) {
+			}
+			return base + bit;
+		}
+
+		assert(step < map->capacity / HASHMAP_SWISS_GROUP_SIZE);
+	}
+}
+
+/* Move every entry to a fresh table, dropping tombstones */
+void hashmap_rehash(struct Hashmap *map, size_t new_capacity)
+{
+	struct Hashmap new_map = { 0 };
+	unsigned long hash = 0;
+	size_t idx = 0;
+	size_t dest = 0;
+
+	hashmap_alloc(&new_map, new_capacity);
+	new_map.size = map->size;
+	new_map.iteration_callback = map->iteration_callback;
+	new_map.seed = map->seed;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if ((map->ctrl[idx] & 0x80) != 0) {
+			continue;
+		}
+
+		hash = hashmap_hash(map, map->slots[idx].key);
+		dest = hashmap_find_free(&new_map, hash);
+		new_map.ctrl[dest] = (unsigned char)(hash & 0x7F);
+		new_map.slots[dest] = map->slots[idx];
+	}
+
+	HASHMAP_FREE((void *)map->slots);
+	*map = new_map;
+
+	hashmap_assert(map);
+}
+
+void hashmap_grow(struct Hashmap *map)
+{
+	size_t new_capacity = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_grow but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	new_capacity = map->capacity << 1;
+
+	if (new_capacity < map->capacity) {
+		/* Overflow, do not grow */
+		return;
+	}
+	if (new_capacity >
+	    ((size_t)-1) / (sizeof(struct HashmapSlot) + 1)) {
+		/* Would overflow, do not grow */
+		return;
+	}
+
+	hashmap_rehash(map, new_capacity);
+}
+
+int hashmap_insert(struct Hashmap *map, CustomKey key, CustomValue value)
+{
+	unsigned long hash = 0;
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_insert but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		hashmap_init(map);
+	}
+
+	hash = hashmap_hash(map, key);
+
+	idx = hashmap_find(map, key, hash);
+	if (idx != map->capacity) {
+		/* Override existing value */
+		map->slots[idx].value = value;
+		return 1;
+	}
+
+	/* Check for being above load factor, counting tombstones. If live
+	 * entries alone are below it, purging tombstones is enough. */
+	if ((float)(map->size + 1) / (float)map->capacity >
+	    HASHMAP_SWISS_LOAD_FACTOR) {
+		hashmap_grow(map);
+	} else if ((float)(map->size + map->deleted + 1) /
+			   (float)map->capacity >
+		   HASHMAP_SWISS_LOAD_FACTOR) {
+		hashmap_rehash(map, map->capacity);
+	}
+
+	idx = hashmap_find_free(map, hash);
+	if (map->ctrl[idx] == HASHMAP_SWISS_DELETED) {
+		map->deleted--;
+	}
+
+	map->ctrl[idx] = (unsigned char)(hash & 0x7F);
+	map->slots[idx].key = key;
+	map->slots[idx].value = value;
+	map->size++;
+
+	hashmap_assert(map);
+
+	return 0;
+}
+
+int hashmap_remove(struct Hashmap *RESTRICT map, CustomKey key,
+		   CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+	size_t base = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_remove but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key, hashmap_hash(map, key));
+	if (idx == map->capacity) {
+		return 0;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	/* Probes never go past a group that has an empty slot, so the slot can
+	 * be emptied outright. Otherwise, leave a tombstone. */
+	base = idx - idx % HASHMAP_SWISS_GROUP_SIZE;
+	if (hashmap_group_match(map->ctrl + base, HASHMAP_SWISS_EMPTY) != 0) {
+		map->ctrl[idx] = HASHMAP_SWISS_EMPTY;
+	} else {
+		map->ctrl[idx] = HASHMAP_SWISS_DELETED;
+		map->deleted++;
+	}
+
+	assert(map->size > 0);
+	map->size--;
+
+	return 1;
+}
+
+int hashmap_get(const struct Hashmap *RESTRICT map, CustomKey key,
+		CustomValue *RESTRICT out)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return -1;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_get but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->slots == NULL) {
+		return 0;
+	}
+
+	idx = hashmap_find(map, key, hashmap_hash(map, key));
+	if (idx == map->capacity) {
+		return 0;
+	}
+
+	if (out != NULL) {
+		*out = map->slots[idx].value;
+	}
+
+	return 1;
+}
+
+int hashmap_has(const struct Hashmap *map, CustomKey key)
+{
+	return hashmap_get(map, key, NULL);
+}
+
+size_t hashmap_size(const Hashmap *map)
+{
+	return map->size;
+}
+
+void hashmap_free(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_free but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	HASHMAP_FREE((void *)map->slots);
+
+	memset((void *)map, 0, sizeof(struct Hashmap));
+}
+
+void hashmap_iterate(struct Hashmap *map, void *context)
+{
+	size_t idx = 0;
+
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_iterate but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->iteration_callback == NULL) {
+		return;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if ((map->ctrl[idx] & 0x80) != 0) {
+			continue;
+		}
+
+		if (map->iteration_callback(map->slots[idx].key,
+					    map->slots[idx].value,
+					    context) == 0) {
+			break;
+		}
+	}
+}
+
+void hashmap_duplicate(struct Hashmap *RESTRICT dest,
+		       struct Hashmap *RESTRICT src)
+{
+	if (dest == NULL || src == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_duplicate but non-null argument expected.");
+	}
+	hashmap_assert(src);
+
+	if (src->capacity == 0) {
+		memset(dest, 0, sizeof(struct Hashmap));
+		return;
+	}
+
+	hashmap_alloc(dest, src->capacity);
+	dest->size = src->size;
+	dest->deleted = src->deleted;
+	dest->iteration_callback = src->iteration_callback;
+	dest->seed = src->seed;
+
+	memcpy((void *)dest->slots, (const void *)src->slots,
+	       src->capacity * (sizeof(struct HashmapSlot) + 1));
+
+	hashmap_assert(dest);
+}
+
+void hashmap_clear(struct Hashmap *map)
+{
+	if (map == NULL) {
+		if (HASHMAP_NO_PANIC_ON_NULL) {
+			return;
+		}
+		hashmap_panic(
+			"Null passed to hashmap_clear but non-null argument expected.");
+	}
+
+	hashmap_assert(map);
+
+	if (map->ctrl != NULL) {
+		memset((void *)map->ctrl, HASHMAP_SWISS_EMPTY, map->capacity);
+	}
+
+	map->size = 0;
+	map->deleted = 0;
+}
+
+unsigned long hashmap_fnv1a_32_buf(const void *buf, size_t len)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	const unsigned char *bend = bptr + len;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; bptr < bend; bptr++) {
+		hval ^= (unsigned long)bptr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_fnv1a_32_str(const char *str)
+{
+	const unsigned char *ustr = (const unsigned char *)str;
+	unsigned long hval = 0x811c9dc5U;
+
+	for (; ustr[0] != '\0'; ustr++) {
+		hval ^= (unsigned long)ustr[0];
+		hval *= 0x01000193U;
+		hval &= 0xFFFFFFFFUL;
+	}
+
+	return hval;
+}
+
+unsigned long hashmap_hash_buf(const void *buf, size_t len)
+{
+	return hashmap_hash_buf_seeded(buf, len, 0);
+}
+
+unsigned long hashmap_hash_str(const char *str)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), 0);
+}
+
+unsigned long hashmap_hash_buf_seeded(const void *buf, size_t len,
+				      unsigned long seed)
+{
+	const unsigned char *bptr = (const unsigned char *)buf;
+	unsigned long hash = seed;
+	unsigned long word = 0;
+	size_t left = len;
+
+	/* A whole word per multiply, instead of a byte */
+	for (; left >= HASHMAP_HASH_WORD_SIZE;
+	     left -= HASHMAP_HASH_WORD_SIZE, bptr += HASHMAP_HASH_WORD_SIZE) {
+		/* The seed also goes into each word, so that colliding
+		 * words cannot be chosen without knowing it */
+		hash ^= HASHMAP_HASH_MIX(HASHMAP_HASH_LOAD(bptr) ^ seed);
+		hash = HASHMAP_HASH_STEP(hash);
+	}
+
+	/* Remaining bytes, as the low bytes of a word */
+	if (left > 0) {
+		while (left > 0) {
+			left--;
+			word = (word << 8) | (unsigned long)bptr[left];
+		}
+		hash ^= HASHMAP_HASH_MIX(word ^ seed);
+	}
+
+	hash ^= (unsigned long)len;
+	HASHMAP_HASH_FMIX(hash);
+
+	return hash;
+}
+
+unsigned long hashmap_hash_str_seeded(const char *str, unsigned long seed)
+{
+	return hashmap_hash_buf_seeded((const void *)str, strlen(str), seed);
+}
+/* Definitions stop here */
+
+#endif /* HASHMAP_SWISS_IN_H */
@@ -2,6 +2,22 @@
 
 import re
 
+# Additional engines, each generated from its own template. A template holds
+# the same hardcoded names as hashmap.in.h between its "Declarations" and
+# "Definitions" markers, and is spliced after HASHMAP_DEFINE in hashmap.h.
+ENGINES = [
+    ("hashmap_robinhood.in.h", "ROBINHOOD"),
+    ("hashmap_swiss.in.h", "SWISS"),
+    ("hashmap_cuckoo.in.h", "CUCKOO"),
+    ("hashmap_hopscotch.in.h", "HOPSCOTCH"),
+]
+
+MACRO_PARAMETERS = "(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\\\n"
+
+# The default engine also takes a hash function with a seed argument. Its
+# public macros, with one hash function or the other, wrap these.
+IMPL_MACRO_PARAMETERS = "(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Seeded_Hash_Func_, Custom_Comparison_Func_)\\\n"
+
 def read_file(filename):
     """Read the input C file"""
     with open(filename, 'r') as f:
@@ -26,11 +42,12 @@ def transform_line(line):
             token = token.replace("CustomKey", "\"#Custom_Key_Type_\"")
             token = token.replace("CustomValue", "\"#Custom_Value_Type_\"")
         else:
-            token = token.replace("HashmapList", "Struct_Name_##List")
+            token = re.sub(r"Hashmap(?=\w)", "Struct_Name_##", token)
             token = token.replace("Hashmap", "Struct_Name_")
             token = token.replace("hashmap", "Functions_Prefix_##")
             token = token.replace("CustomKey", "Custom_Key_Type_")
             token = token.replace("CustomValue", "Custom_Value_Type_")
+            token = token.replace("SEEDED_HASH_CALLBACK", "Custom_Seeded_Hash_Func_")
             token = token.replace("HASH_CALLBACK", "Custom_Hash_Func_")
             token = token.replace("COMPARISON_CALLBACK", "Custom_Comparison_Func_")
         new_tokenized.append(token)
@@ -38,6 +55,33 @@ def transform_line(line):
     return "".join(new_tokenized)
 
 
+def generate_macros(lines, suffix):
+    """Turn the marked regions of a template into DECLARE/DEFINE macros"""
+    result = []
+    in_macro = False
+    for line in lines:
+        if "/* Declarations start here */" in line:
+            in_macro = True
+            result.append("#define HASHMAP_DECLARE" + suffix + MACRO_PARAMETERS)
+            continue
+        elif "/* Definitions start here */" in line:
+            in_macro = True
+            result.append("#define HASHMAP_DEFINE" + suffix + MACRO_PARAMETERS)
+            continue
+        elif ("/* Declarations stop here */" in line or
+              "/* Definitions stop here */" in line):
+            in_macro = False
+            last_value = result.pop()
+            last_value = last_value[:-2] + last_value[-1]
+            result.append(last_value)
+            continue
+
+        if in_macro:
+            result.append(transform_line(line))
+
+    return result
+
+
 def main():
     lines = read_file("hashmap.in.h")
     result = []
@@ -53,6 +97,12 @@ def main():
             continue
         if "#endif /* HASH_CALLBACK */" in line:
             continue
+        if "#ifndef SEEDED_HASH_CALLBACK" in line:
+            continue
+        if "#define SEEDED_HASH_CALLBACK NULL" in line:
+            continue
+        if "#endif /* SEEDED_HASH_CALLBACK */" in line:
+            continue
         if "#ifndef COMPARISON_CALLBACK" in line:
             continue
         if "#define COMPARISON_CALLBACK NULL" in line:
@@ -61,8 +111,7 @@ def main():
             continue
         if "/* Declarations start here */" in line:
             in_macro = True
-            result.append("""#define HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\\
-""")
+            result.append("#define HASHMAP_DECLARE_IMPL" + IMPL_MACRO_PARAMETERS)
             continue
         elif "/* Declarations stop here */" in line:
             in_macro = False
@@ -72,14 +121,17 @@ def main():
             continue
         elif "/* Definitions start here */" in line:
             in_macro = True
-            result.append("""#define HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Key_Type_, Custom_Value_Type_, Custom_Hash_Func_, Custom_Comparison_Func_)\\
-""")
+            result.append("#define HASHMAP_DEFINE_IMPL" + IMPL_MACRO_PARAMETERS)
             continue
         elif "/* Definitions stop here */" in line:
             in_macro = False
             last_value = result.pop()
             last_value = last_value[:-2] + last_value[-1]
             result.append(last_value)
+            for filename, suffix in ENGINES:
+                result.append("\n")
+                result.extend(generate_macros(read_file(filename),
+                                              "_" + suffix))
             continue
 
         if in_macro:
@@ -0,0 +1,4 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE(Hashmap, hashmap, const char *, int, hashmap_fnv1a_32_str,
+	       strcmp)
@@ -0,0 +1,464 @@
+#include <assert.h>
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_STRESS_MULTIPLIER = 1000U };
+
+jmp_buf abort_jmp;
+
+const char *test_strings[] = {
+	"hello",    "world",	"dragons!", "testing", "hashmap",    "function",
+	"alice",    "bob",	"charlie",  "delta",   "echo",	     "foxtrot",
+	"apple",    "banana",	"cherry",   "date",    "elderberry", "fig",
+	"red",	    "green",	"blue",	    "yellow",  "purple",     "orange",
+	"cat",	    "dog",	"bird",	    "fish",    "rabbit",     "hamster",
+	"mountain", "river",	"ocean",    "forest",  "desert",     "valley",
+	"quick",    "brown",	"fox",	    "jumps",   "over",	     "lazy",
+	"alpha",    "beta",	"gamma",    "theta",   "omega",	     "sigma",
+	"one",	    "two",	"three",    "four",    "five",	     "six",
+	"january",  "february", "march",    "april",   "may",	     "june",
+	"coffee",   "tea",	"water",    "juice",   "milk",	     "soda",
+	"keyboard", "mouse",	"screen",   "laptop",  "desktop",    "tablet",
+	"happy",    "sad",	"angry",    "excited", "calm",	     "tired",
+	"north",    "south",	"east",	    "west",    "center",     "edge",
+	"start",    "middle",	"end",	    "begin",   "finish",     "complete",
+	"tiny",	    "small",	"medium",   "large",   "huge",	     "giant",
+	"fast",	    "slow",	"gauss",    "rapid",   "swift",	     "gradual",
+	"light",    "dark",	"bright",   "dim",     "shadow",     "glow"
+};
+const size_t test_strings_size = sizeof(test_strings) / sizeof(const char *);
+
+/* Insert test strings until a migration starts, returns how many were */
+size_t fill_until_migrating(Hashmap *map)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < test_strings_size && map->old_buckets == NULL;
+	     idx++) {
+		hashmap_insert(map, test_strings[idx], (int)idx);
+	}
+
+	TEST_ASSERT_NOT_NULL(map->old_buckets);
+
+	return idx;
+}
+
+/* buckets_filled must count the non-empty buckets of both arrays, and every
+ * key must sit in the array hashmap_bucket() picks for it */
+void assert_buckets(const Hashmap *map)
+{
+	struct HashmapListNode *node = NULL;
+	size_t idx = 0;
+	size_t filled = 0;
+	size_t size = 0;
+
+	for (idx = 0; idx < map->old_capacity; idx++) {
+		if (idx < map->rehash_idx) {
+			TEST_ASSERT_NULL(map->old_buckets[idx]);
+		}
+
+		for (node = map->old_buckets[idx]; node != NULL;
+		     node = node->next) {
+			TEST_ASSERT_EQUAL_PTR(
+				&map->old_buckets[idx],
+				hashmap_bucket(map,
+					       hashmap_hash(map, node->key)));
+			size++;
+		}
+
+		filled += map->old_buckets[idx] != NULL;
+	}
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		for (node = map->buckets[idx]; node != NULL;
+		     node = node->next) {
+			TEST_ASSERT_EQUAL_PTR(
+				&map->buckets[idx],
+				hashmap_bucket(map,
+					       hashmap_hash(map, node->key)));
+			size++;
+		}
+
+		filled += map->buckets[idx] != NULL;
+	}
+
+	TEST_ASSERT_EQUAL_UINT(map->buckets_filled, filled);
+	TEST_ASSERT_EQUAL_UINT(map->size, size);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_grow_starts_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY << 1, map.capacity);
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(0, map.rehash_idx);
+	TEST_ASSERT_EQUAL_UINT(inserted, map.size);
+	assert_buckets(&map);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_migration_bounded(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t previous_idx = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	while (map.old_buckets != NULL) {
+		TEST_ASSERT_LESS_THAN_UINT(test_strings_size, inserted);
+
+		previous_idx = map.rehash_idx;
+		hashmap_insert(&map, test_strings[inserted], (int)inserted);
+		inserted++;
+
+		if (map.old_buckets != NULL) {
+			TEST_ASSERT_EQUAL_UINT(previous_idx +
+						       HASHMAP_INCREMENTAL_REHASH,
+					       map.rehash_idx);
+		}
+		assert_buckets(&map);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(0, map.rehash_idx);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_remove_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int removed = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_remove(&map, test_strings[idx], &removed));
+		TEST_ASSERT_EQUAL_INT(idx, removed);
+		TEST_ASSERT_EQUAL_INT(0, hashmap_has(&map, test_strings[idx]));
+		assert_buckets(&map);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.buckets_filled);
+
+	hashmap_free(&map);
+}
+
+int test_iterate_count_callback(const char *key, int val, void *context)
+{
+	size_t *seen = (size_t *)context;
+
+	TEST_ASSERT_EQUAL_STRING(test_strings[val], key);
+
+	seen[val]++;
+
+	return 1;
+}
+
+void test_iterate_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t seen[sizeof(test_strings) / sizeof(const char *)] = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+
+	hashmap_init(&map);
+	map.iteration_callback = test_iterate_count_callback;
+	inserted = fill_until_migrating(&map);
+
+	/* Migrate some buckets so that both arrays hold keys */
+	hashmap_remove(&map, "not inserted", NULL);
+	TEST_ASSERT_NOT_NULL(map.old_buckets);
+	TEST_ASSERT_GREATER_THAN_UINT(0, map.rehash_idx);
+
+	hashmap_iterate(&map, seen);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_UINT(idx < inserted, seen[idx]);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_iter_during_migration(void)
+{
+	Hashmap map = { 0 };
+	HashmapIter iter;
+	char seen[sizeof(test_strings) / sizeof(const char *)] = { 0 };
+	int *value = NULL;
+	size_t inserted = 0;
+	size_t visited = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	hashmap_iter_begin(&map, &iter);
+	while (hashmap_iter_next(&iter, NULL, &value)) {
+		TEST_ASSERT_EQUAL_INT(0, seen[*value]);
+		seen[*value] = 1;
+		visited++;
+		if (*value % 2 == 0) {
+			hashmap_iter_remove(&iter);
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT(inserted, visited);
+	TEST_ASSERT_EQUAL_UINT(inserted / 2, map.size);
+	TEST_ASSERT_NOT_NULL(map.old_buckets);
+	assert_buckets(&map);
+
+	hashmap_free(&map);
+}
+
+void test_duplicate_during_migration(void)
+{
+	Hashmap src = { 0 };
+	Hashmap dest = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&src);
+	inserted = fill_until_migrating(&src);
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_EQUAL_UINT(src.size, dest.size);
+	TEST_ASSERT_EQUAL_UINT(src.buckets_filled, dest.buckets_filled);
+	TEST_ASSERT_EQUAL_UINT(src.old_capacity, dest.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(src.rehash_idx, dest.rehash_idx);
+	TEST_ASSERT_NOT_EQUAL(src.old_buckets, dest.old_buckets);
+	assert_buckets(&dest);
+
+	hashmap_clear(&src);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&dest, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&src);
+	hashmap_free(&dest);
+}
+
+void test_clear_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t capacity = 0;
+
+	hashmap_init(&map);
+	fill_until_migrating(&map);
+	capacity = map.capacity;
+
+	hashmap_clear(&map);
+
+	TEST_ASSERT_NULL(map.old_buckets);
+	TEST_ASSERT_EQUAL_UINT(0, map.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(0, map.rehash_idx);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.buckets_filled);
+	TEST_ASSERT_EQUAL_UINT(capacity, map.capacity);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_has(&map, test_strings[0]));
+
+	hashmap_free(&map);
+}
+
+void test_grow_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t capacity = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+	capacity = map.capacity;
+
+	hashmap_grow(&map);
+
+	TEST_ASSERT_EQUAL_UINT(capacity << 1, map.capacity);
+	TEST_ASSERT_EQUAL_UINT(capacity, map.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(0, map.rehash_idx);
+	assert_buckets(&map);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_reserve_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	/* Reserving migrates everything at once */
+	hashmap_reserve(&map, test_strings_size);
+
+	TEST_ASSERT_NULL(map.old_buckets);
+	TEST_ASSERT_EQUAL_UINT(0, map.old_capacity);
+	TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+		HASHMAP_LOAD_FACTOR,
+		(float)test_strings_size / (float)map.capacity);
+	assert_buckets(&map);
+
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_shrink_to_fit_during_migration(void)
+{
+	Hashmap map = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	inserted = fill_until_migrating(&map);
+
+	for (idx = 1; idx < inserted; idx++) {
+		hashmap_remove(&map, test_strings[idx], NULL);
+	}
+
+	hashmap_shrink_to_fit(&map);
+
+	TEST_ASSERT_NULL(map.old_buckets);
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.capacity);
+	assert_buckets(&map);
+
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map, test_strings[0], &gotten));
+	TEST_ASSERT_EQUAL_INT(0, gotten);
+
+	hashmap_free(&map);
+}
+
+void test_free_during_migration(void)
+{
+	Hashmap map = { 0 };
+	Hashmap map_zero = { 0 };
+
+	hashmap_init(&map);
+	fill_until_migrating(&map);
+
+	hashmap_free(&map);
+
+	TEST_ASSERT_EQUAL_MEMORY(&map_zero, &map, sizeof(Hashmap));
+}
+
+void test_insert_and_remove(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t inserting = 0;
+	int replaced = 0;
+	int added_total = 0;
+	int removed_total = 0;
+	int removed_value = 0;
+
+	const char *test_string = NULL;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		test_string = test_strings[idx % test_strings_size];
+
+		/* Randomly choose whether we insert or delete */
+		inserting = idx;
+		inserting ^= inserting >> 16;
+		inserting *= 0x85ebca6b;
+		inserting ^= inserting >> 13;
+		inserting *= 0xc2b2ae35;
+		inserting ^= inserting >> 16;
+
+		if (inserting % 2 == 0) {
+			replaced = hashmap_insert(&map, test_string, (int)idx);
+			if (replaced == 0) {
+				added_total++;
+			}
+		} else {
+			removed_total += hashmap_remove(&map, test_string,
+							&removed_value);
+		}
+
+		TEST_ASSERT_EQUAL_UINT(added_total - removed_total, map.size);
+	}
+
+	assert_buckets(&map);
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_grow_starts_migration);
+	RUN_TEST(test_migration_bounded);
+	RUN_TEST(test_remove_during_migration);
+	RUN_TEST(test_iterate_during_migration);
+	RUN_TEST(test_iter_during_migration);
+	RUN_TEST(test_duplicate_during_migration);
+	RUN_TEST(test_clear_during_migration);
+	RUN_TEST(test_grow_during_migration);
+	RUN_TEST(test_reserve_during_migration);
+	RUN_TEST(test_shrink_to_fit_during_migration);
+	RUN_TEST(test_free_during_migration);
+	RUN_TEST(test_insert_and_remove);
+
+	return UNITY_END();
+}
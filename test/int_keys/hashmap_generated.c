@@ -0,0 +1,4 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE_INT(Hashmap, hashmap, int, int)
+HASHMAP_DEFINE_INT(WideMap, wide_map, unsigned long, unsigned long)
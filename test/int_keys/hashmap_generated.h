@@ -0,0 +1,10 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#include "hashmap.h"
+
+HASHMAP_DECLARE_INT(Hashmap, hashmap, int, int)
+HASHMAP_DECLARE_INT(WideMap, wide_map, unsigned long, unsigned long)
+
+#endif /* HASHMAP_GENERATED_H */
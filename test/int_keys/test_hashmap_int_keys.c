@@ -0,0 +1,193 @@
+#include <limits.h>
+#include <stdlib.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_KEYS = 1000, TEST_HIGH_BITS = 16 };
+
+jmp_buf abort_jmp;
+
+size_t longest_chain(const Hashmap *map)
+{
+	const struct HashmapListNode *node = NULL;
+	size_t longest = 0;
+	size_t length = 0;
+	size_t idx = 0;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		length = 0;
+		for (node = map->buckets[idx]; node != NULL;
+		     node = node->next) {
+			length++;
+		}
+		if (length > longest) {
+			longest = length;
+		}
+	}
+
+	return longest;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_hash_int(void)
+{
+	/* The MurmurHash3 finalizer of the key */
+#if ULONG_MAX > 0xFFFFFFFFUL
+	TEST_ASSERT_TRUE(hashmap_hash_int(1, 0) == 0xB456BCFC34C2CB2CUL);
+#else
+	TEST_ASSERT_TRUE(hashmap_hash_int(1, 0) == 0x514E28B7UL);
+#endif
+	TEST_ASSERT_TRUE(hashmap_hash_int(0, 0) == 0);
+
+	/* The seed is mixed in with the key */
+	TEST_ASSERT_TRUE(hashmap_hash_int(1, 1) != hashmap_hash_int(1, 0));
+
+	TEST_ASSERT_EQUAL_INT(0, hashmap_compare_int(-1, -1));
+	TEST_ASSERT_TRUE(hashmap_compare_int(-1, 1) != 0);
+}
+
+void test_insert_get_remove(void)
+{
+	Hashmap map = { 0 };
+	int key = 0;
+	int gotten = 0;
+
+	for (key = -TEST_KEYS; key < TEST_KEYS; key++) {
+		TEST_ASSERT_EQUAL_INT(0, hashmap_insert(&map, key, key * 2));
+	}
+	TEST_ASSERT_EQUAL_UINT(2 * TEST_KEYS, map.size);
+
+	for (key = -TEST_KEYS; key < TEST_KEYS; key += 2) {
+		TEST_ASSERT_EQUAL_INT(1, hashmap_remove(&map, key, &gotten));
+		TEST_ASSERT_EQUAL_INT(key * 2, gotten);
+	}
+
+	for (key = -TEST_KEYS; key < TEST_KEYS; key++) {
+		TEST_ASSERT_EQUAL_INT(key % 2 != 0,
+				      hashmap_get(&map, key, &gotten));
+		if (key % 2 != 0) {
+			TEST_ASSERT_EQUAL_INT(key * 2, gotten);
+		}
+	}
+
+	hashmap_free(&map);
+}
+
+void test_sequential_spread(void)
+{
+	Hashmap map = { 0 };
+	int key = 0;
+
+	hashmap_init(&map);
+	map.seed = 0;
+	hashmap_reserve(&map, TEST_KEYS);
+
+	/* Sequential keys spread like random ones */
+	for (key = 0; key < TEST_KEYS; key++) {
+		hashmap_insert(&map, key, key);
+	}
+
+	TEST_ASSERT_LESS_OR_EQUAL_UINT(8, longest_chain(&map));
+
+	hashmap_free(&map);
+}
+
+void test_strided_spread(void)
+{
+	Hashmap map = { 0 };
+	int key = 0;
+
+	hashmap_init(&map);
+	map.seed = 0;
+	hashmap_reserve(&map, TEST_KEYS);
+
+	/* Multiples of the capacity share their low bits, their hashes do
+	 * not */
+	for (key = 0; key < TEST_KEYS; key++) {
+		hashmap_insert(&map, key * (int)map.capacity, key);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(TEST_KEYS, map.size);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT(8, longest_chain(&map));
+
+	hashmap_free(&map);
+}
+
+void test_high_bits_spread(void)
+{
+	WideMap map = { 0 };
+	size_t *chains = NULL;
+	size_t longest = 0;
+	size_t idx = 0;
+	unsigned long key = 0;
+	const size_t keys = (size_t)1 << TEST_HIGH_BITS;
+	const size_t shift = sizeof(unsigned long) * CHAR_BIT - TEST_HIGH_BITS;
+
+	/* Keys differing only in their top bits */
+	for (idx = 0; idx < keys; idx++) {
+		wide_map_insert(&map, (unsigned long)idx << shift, 0);
+	}
+	TEST_ASSERT_EQUAL_UINT(keys, map.size);
+
+	chains = (size_t *)calloc(map.capacity, sizeof(size_t));
+	TEST_ASSERT_NOT_NULL(chains);
+
+	for (idx = 0; idx < keys; idx++) {
+		key = (unsigned long)idx << shift;
+		chains[wide_map_hash(&map, key) & (map.capacity - 1)]++;
+	}
+	for (idx = 0; idx < map.capacity; idx++) {
+		if (chains[idx] > longest) {
+			longest = chains[idx];
+		}
+	}
+
+	/* Random keys give about 6 at this load, a hash ignoring the top
+	 * bits would chain them all in one bucket */
+	TEST_ASSERT_LESS_OR_EQUAL_UINT(12, longest);
+
+	free(chains);
+	wide_map_free(&map);
+}
+
+void test_wide_keys(void)
+{
+	WideMap map = { 0 };
+	unsigned long key = 0;
+	unsigned long gotten = 0;
+
+	for (key = 0; key < TEST_KEYS; key++) {
+		wide_map_insert(&map, ULONG_MAX - key, key);
+	}
+
+	for (key = 0; key < TEST_KEYS; key++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, wide_map_get(&map, ULONG_MAX - key, &gotten));
+		TEST_ASSERT_TRUE(gotten == key);
+	}
+	TEST_ASSERT_EQUAL_INT(0, wide_map_has(&map, 0));
+
+	wide_map_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_hash_int);
+	RUN_TEST(test_insert_get_remove);
+	RUN_TEST(test_sequential_spread);
+	RUN_TEST(test_strided_spread);
+	RUN_TEST(test_high_bits_spread);
+	RUN_TEST(test_wide_keys);
+
+	return UNITY_END();
+}
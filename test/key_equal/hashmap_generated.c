@@ -0,0 +1,15 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE_EQUAL(Hashmap, hashmap, struct TestKey, int, test_key_hash,
+		     TEST_KEY_EQUAL)
+HASHMAP_DEFINE_EQUAL(PtrMap, ptr_map, const void *, int, NULL,
+		     HASHMAP_EQUAL_SCALAR)
+HASHMAP_DEFINE_EQUAL(ZeroedMap, zeroed_map, struct TestKey, int, NULL,
+		     TEST_KEY_EQUAL)
+
+unsigned long test_key_hash(struct TestKey key, unsigned long seed)
+{
+	/* Fields only, never the padding */
+	return hashmap_hash_buf_seeded(&key.id, sizeof(key.id),
+				       seed ^ (unsigned long)key.tag);
+}
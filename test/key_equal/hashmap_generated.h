@@ -0,0 +1,26 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#include "hashmap.h"
+
+/* Padded between tag and id on every common ABI */
+struct TestKey {
+	char tag;
+	long id;
+};
+
+#define TEST_KEY_EQUAL(key1, key2) \
+	((key1).tag == (key2).tag && (key1).id == (key2).id)
+
+unsigned long test_key_hash(struct TestKey key, unsigned long seed);
+
+HASHMAP_DECLARE_EQUAL(Hashmap, hashmap, struct TestKey, int, test_key_hash,
+		      TEST_KEY_EQUAL)
+HASHMAP_DECLARE_EQUAL(PtrMap, ptr_map, const void *, int, NULL,
+		      HASHMAP_EQUAL_SCALAR)
+/* Hashed by their bytes: padding must be zeroed */
+HASHMAP_DECLARE_EQUAL(ZeroedMap, zeroed_map, struct TestKey, int, NULL,
+		      TEST_KEY_EQUAL)
+
+#endif /* HASHMAP_GENERATED_H */
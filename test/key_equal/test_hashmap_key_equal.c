@@ -0,0 +1,140 @@
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_KEYS = 500 };
+
+jmp_buf abort_jmp;
+
+/* Key with its padding bytes filled with garbage */
+struct TestKey make_key(char tag, long id, unsigned char garbage)
+{
+	struct TestKey key;
+
+	memset((void *)&key, garbage, sizeof(key));
+	key.tag = tag;
+	key.id = id;
+
+	return key;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_compare_equal(void)
+{
+	struct TestKey key1 = make_key('a', 1, 0x00);
+	struct TestKey key2 = make_key('a', 1, 0xFF);
+
+	TEST_ASSERT_EQUAL_INT(0, hashmap_compare_equal(key1, key2));
+	TEST_ASSERT_TRUE(hashmap_compare_equal(key1, make_key('b', 1, 0)) != 0);
+	TEST_ASSERT_TRUE(hashmap_compare_equal(key1, make_key('a', 2, 0)) != 0);
+	TEST_ASSERT_EQUAL(hashmap_compare_equal,
+			  hashmap_compare_comparison_callback());
+}
+
+void test_padding_ignored(void)
+{
+	Hashmap map = { 0 };
+	long id = 0;
+	int gotten = 0;
+
+	for (id = 0; id < TEST_KEYS; id++) {
+		hashmap_insert(&map, make_key('a', id, 0x00), (int)id);
+		hashmap_insert(&map, make_key('b', id, 0x00), -(int)id);
+	}
+
+	/* Same fields, other padding bytes: same keys */
+	for (id = 0; id < TEST_KEYS; id++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, make_key('a', id, 0xA5), &gotten));
+		TEST_ASSERT_EQUAL_INT(id, gotten);
+		TEST_ASSERT_EQUAL_INT(1, hashmap_insert(&map,
+							make_key('b', id, 0x5A),
+							(int)id));
+	}
+	TEST_ASSERT_EQUAL_UINT(2 * TEST_KEYS, map.size);
+
+	for (id = 0; id < TEST_KEYS; id++) {
+		TEST_ASSERT_EQUAL_INT(1, hashmap_remove(&map,
+							make_key('b', id, 0xFF),
+							&gotten));
+		TEST_ASSERT_EQUAL_INT(id, gotten);
+	}
+	TEST_ASSERT_EQUAL_UINT(TEST_KEYS, map.size);
+
+	hashmap_free(&map);
+}
+
+void test_padding_zeroed(void)
+{
+	ZeroedMap map = { 0 };
+	struct TestKey key1;
+	struct TestKey key2;
+	long id = 0;
+	int gotten = 0;
+
+	for (id = 0; id < TEST_KEYS; id++) {
+		zeroed_map_insert(&map, make_key('a', id, 0x00), (int)id);
+	}
+
+	/* Equal keys built alike hash alike */
+	for (id = 0; id < TEST_KEYS; id++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, zeroed_map_get(&map, make_key('a', id, 0x00),
+					  &gotten));
+		TEST_ASSERT_EQUAL_INT(id, gotten);
+		TEST_ASSERT_EQUAL_INT(
+			1, zeroed_map_remove(&map, make_key('a', id, 0x00),
+					     NULL));
+	}
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+
+	/* Other padding bytes: equal keys, other hash, hence the zeroing */
+	key1 = make_key('a', 1, 0x00);
+	key2 = make_key('a', 1, 0xFF);
+	TEST_ASSERT_EQUAL_INT(0, zeroed_map_compare_equal(key1, key2));
+	TEST_ASSERT_TRUE(zeroed_map_hash(&map, key1) !=
+			 zeroed_map_hash(&map, key2));
+
+	zeroed_map_free(&map);
+}
+
+void test_scalar_keys(void)
+{
+	PtrMap map = { 0 };
+	char objects[TEST_KEYS];
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < TEST_KEYS; idx++) {
+		ptr_map_insert(&map, &objects[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < TEST_KEYS; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, ptr_map_get(&map, &objects[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+	TEST_ASSERT_EQUAL_INT(0, ptr_map_has(&map, &gotten));
+
+	ptr_map_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_compare_equal);
+	RUN_TEST(test_padding_ignored);
+	RUN_TEST(test_padding_zeroed);
+	RUN_TEST(test_scalar_keys);
+
+	return UNITY_END();
+}
@@ -24,25 +24,25 @@ void *return_null(void *ptr, size_t size)
 
 void test_grow_out_of_mem(void)
 {
-	/* TODO: add implement hashmap_grow and this test */
-	/* Hashmap map = { 0 };
-	 * 
-	 * /\* Bypass would-be-failing initialization *\/
-	 * map.capacity = HASHMAP_DEFAULT_CAPACITY;
-	 * map.buckets = (struct HashmapListNode **)realloc(
-	 * 	NULL, map.capacity * sizeof(struct HashmapListNode *));
-	 * memset((void *)map.buckets, 0,
-	 *        map.capacity * sizeof(struct HashmapListNode *));
-	 * 
-	 * if (setjmp(abort_jmp) == 0) {
-	 * 	hashmap_grow(&map);
-	 * } else {
-	 * 	hashmap_free(&map);
-	 * 	return;
-	 * }
-	 * 
-	 * hashmap_free(&map);
-	 * TEST_FAIL(); */
+	Hashmap map = { 0 };
+	const char *key = "hello";
+
+	hashmap_init(&map);
+	hashmap_insert(&map, key, 10);
+	disabled_realloc = 1;
+
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_grow(&map);
+	} else {
+		/* The map is left untouched */
+		TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.capacity);
+		TEST_ASSERT_EQUAL_INT(1, hashmap_has(&map, key));
+		hashmap_free(&map);
+		return;
+	}
+
+	hashmap_free(&map);
+	TEST_FAIL();
 }
 
 void test_init_out_of_mem(void)
@@ -21,6 +21,16 @@ void test_init_pass_null_abort(void)
 	TEST_FAIL();
 }
 
+void test_init_seeded_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_init_seeded(NULL, 1);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
 void test_grow_pass_null_abort(void)
 {
 	if (setjmp(abort_jmp) == 0) {
@@ -41,6 +51,48 @@ void test_insert_pass_null_abort(void)
 	TEST_FAIL();
 }
 
+void test_insert_unique_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_insert_unique(NULL, "hello", 10);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_build_from_arrays_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_build_from_arrays(NULL, NULL, NULL, 0);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_get_or_insert_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_get_or_insert(NULL, "hello", 10, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_upsert_pass_null_abort(void)
+{
+	Hashmap map = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_upsert(&map, "hello", NULL, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
 void test_remove_pass_null_abort(void)
 {
 	if (setjmp(abort_jmp) == 0) {
@@ -61,6 +113,26 @@ void test_get_pass_null_abort(void)
 	TEST_FAIL();
 }
 
+void test_get_many_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_get_many(NULL, NULL, 0, NULL, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_get_ptr_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_get_ptr(NULL, "hello");
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
 void test_has_pass_null_abort(void)
 {
 	if (setjmp(abort_jmp) == 0) {
@@ -71,6 +143,46 @@ void test_has_pass_null_abort(void)
 	TEST_FAIL();
 }
 
+void test_hash_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_hash(NULL, "hello");
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_insert_hashed_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_insert_hashed(NULL, "hello", 0, 10);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_get_hashed_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_get_hashed(NULL, "hello", 0, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_remove_hashed_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_remove_hashed(NULL, "hello", 0, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
 void test_free_pass_null_abort(void)
 {
 	if (setjmp(abort_jmp) == 0) {
@@ -91,6 +203,36 @@ void test_iterate_pass_null_abort(void)
 	TEST_FAIL();
 }
 
+void test_iter_begin_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_iter_begin(NULL, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_iter_next_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_iter_next(NULL, NULL, NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
+void test_iter_remove_pass_null_abort(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		hashmap_iter_remove(NULL);
+	} else {
+		return;
+	}
+	TEST_FAIL();
+}
+
 void test_duplicate_pass_null_abort_src(void)
 {
 	/* TODO: implement duplicating and this test */
@@ -142,13 +284,27 @@ int main(void)
 	UNITY_BEGIN();
 
 	RUN_TEST(test_init_pass_null_abort);
+	RUN_TEST(test_init_seeded_pass_null_abort);
 	RUN_TEST(test_grow_pass_null_abort);
 	RUN_TEST(test_insert_pass_null_abort);
+	RUN_TEST(test_insert_unique_pass_null_abort);
+	RUN_TEST(test_build_from_arrays_pass_null_abort);
+	RUN_TEST(test_get_or_insert_pass_null_abort);
+	RUN_TEST(test_upsert_pass_null_abort);
 	RUN_TEST(test_remove_pass_null_abort);
 	RUN_TEST(test_get_pass_null_abort);
+	RUN_TEST(test_get_many_pass_null_abort);
+	RUN_TEST(test_get_ptr_pass_null_abort);
 	RUN_TEST(test_has_pass_null_abort);
+	RUN_TEST(test_hash_pass_null_abort);
+	RUN_TEST(test_insert_hashed_pass_null_abort);
+	RUN_TEST(test_get_hashed_pass_null_abort);
+	RUN_TEST(test_remove_hashed_pass_null_abort);
 	RUN_TEST(test_free_pass_null_abort);
 	RUN_TEST(test_iterate_pass_null_abort);
+	RUN_TEST(test_iter_begin_pass_null_abort);
+	RUN_TEST(test_iter_next_pass_null_abort);
+	RUN_TEST(test_iter_remove_pass_null_abort);
 	RUN_TEST(test_duplicate_pass_null_abort_src);
 	RUN_TEST(test_duplicate_pass_null_abort_dest);
 	RUN_TEST(test_duplicate_pass_null_abort_both);
@@ -14,6 +14,11 @@ void test_init_pass_null_ignore(void)
 	hashmap_init(NULL);
 }
 
+void test_init_seeded_pass_null_ignore(void)
+{
+	hashmap_init_seeded(NULL, 1);
+}
+
 void test_grow_pass_null_ignore(void)
 {
 	hashmap_grow(NULL);
@@ -24,6 +29,31 @@ void test_insert_pass_null_ignore(void)
 	hashmap_insert(NULL, "hello", 10);
 }
 
+void test_insert_unique_pass_null_ignore(void)
+{
+	hashmap_insert_unique(NULL, "hello", 10);
+}
+
+void test_build_from_arrays_pass_null_ignore(void)
+{
+	Hashmap map = { 0 };
+	hashmap_build_from_arrays(NULL, NULL, NULL, 0);
+	hashmap_build_from_arrays(&map, NULL, NULL, 1);
+	TEST_ASSERT_NULL(map.buckets);
+}
+
+void test_get_or_insert_pass_null_ignore(void)
+{
+	TEST_ASSERT_NULL(hashmap_get_or_insert(NULL, "hello", 10, NULL));
+}
+
+void test_upsert_pass_null_ignore(void)
+{
+	Hashmap map = { 0 };
+	hashmap_upsert(&map, "hello", NULL, NULL);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+}
+
 void test_remove_pass_null_ignore(void)
 {
 	hashmap_remove(NULL, "hello", NULL);
@@ -34,11 +64,31 @@ void test_get_pass_null_ignore(void)
 	hashmap_get(NULL, "hello", NULL);
 }
 
+void test_get_many_pass_null_ignore(void)
+{
+	Hashmap map = { 0 };
+	TEST_ASSERT_EQUAL_UINT(0, hashmap_get_many(NULL, NULL, 0, NULL, NULL));
+	TEST_ASSERT_EQUAL_UINT(0, hashmap_get_many(&map, NULL, 1, NULL, NULL));
+}
+
+void test_get_ptr_pass_null_ignore(void)
+{
+	TEST_ASSERT_NULL(hashmap_get_ptr(NULL, "hello"));
+}
+
 void test_has_pass_null_ignore(void)
 {
 	hashmap_has(NULL, "hello");
 }
 
+void test_hashed_pass_null_ignore(void)
+{
+	TEST_ASSERT_EQUAL_UINT(0, hashmap_hash(NULL, "hello"));
+	hashmap_insert_hashed(NULL, "hello", 0, 10);
+	hashmap_get_hashed(NULL, "hello", 0, NULL);
+	hashmap_remove_hashed(NULL, "hello", 0, NULL);
+}
+
 void test_free_pass_null_ignore(void)
 {
 	hashmap_free(NULL);
@@ -49,6 +99,15 @@ void test_iterate_pass_null_ignore(void)
 	hashmap_iterate(NULL, NULL);
 }
 
+void test_iter_pass_null_ignore(void)
+{
+	Hashmap map = { 0 };
+	hashmap_iter_begin(NULL, NULL);
+	hashmap_iter_begin(&map, NULL);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_next(NULL, NULL, NULL));
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_remove(NULL));
+}
+
 void test_duplicate_pass_null_ignore_src(void)
 {
 	/* TODO: implement duplicating and this test */
@@ -80,13 +139,22 @@ int main(void)
 	UNITY_BEGIN();
 
 	RUN_TEST(test_init_pass_null_ignore);
+	RUN_TEST(test_init_seeded_pass_null_ignore);
 	RUN_TEST(test_grow_pass_null_ignore);
 	RUN_TEST(test_insert_pass_null_ignore);
+	RUN_TEST(test_insert_unique_pass_null_ignore);
+	RUN_TEST(test_build_from_arrays_pass_null_ignore);
+	RUN_TEST(test_get_or_insert_pass_null_ignore);
+	RUN_TEST(test_upsert_pass_null_ignore);
 	RUN_TEST(test_remove_pass_null_ignore);
 	RUN_TEST(test_get_pass_null_ignore);
+	RUN_TEST(test_get_many_pass_null_ignore);
+	RUN_TEST(test_get_ptr_pass_null_ignore);
 	RUN_TEST(test_has_pass_null_ignore);
+	RUN_TEST(test_hashed_pass_null_ignore);
 	RUN_TEST(test_free_pass_null_ignore);
 	RUN_TEST(test_iterate_pass_null_ignore);
+	RUN_TEST(test_iter_pass_null_ignore);
 	RUN_TEST(test_duplicate_pass_null_ignore_src);
 	RUN_TEST(test_duplicate_pass_null_ignore_dest);
 	RUN_TEST(test_duplicate_pass_null_ignore_both);
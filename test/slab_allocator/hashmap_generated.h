@@ -0,0 +1,11 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#define HASHMAP_SLAB_SIZE 16
+#include "hashmap.h"
+
+HASHMAP_DECLARE(Hashmap, hashmap, const char *, int, hashmap_fnv1a_32_str,
+		strcmp)
+
+#endif /* HASHMAP_GENERATED_H */
@@ -0,0 +1,299 @@
+#include <assert.h>
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_STRESS_MULTIPLIER = 1000U };
+
+jmp_buf abort_jmp;
+
+const char *test_strings[] = {
+	"hello",    "world",	"dragons!", "testing", "hashmap",    "function",
+	"alice",    "bob",	"charlie",  "delta",   "echo",	     "foxtrot",
+	"apple",    "banana",	"cherry",   "date",    "elderberry", "fig",
+	"red",	    "green",	"blue",	    "yellow",  "purple",     "orange",
+	"cat",	    "dog",	"bird",	    "fish",    "rabbit",     "hamster",
+	"mountain", "river",	"ocean",    "forest",  "desert",     "valley",
+	"quick",    "brown",	"fox",	    "jumps",   "over",	     "lazy",
+	"alpha",    "beta",	"gamma",    "theta",   "omega",	     "sigma",
+	"one",	    "two",	"three",    "four",    "five",	     "six",
+	"january",  "february", "march",    "april",   "may",	     "june",
+	"coffee",   "tea",	"water",    "juice",   "milk",	     "soda",
+	"keyboard", "mouse",	"screen",   "laptop",  "desktop",    "tablet",
+	"happy",    "sad",	"angry",    "excited", "calm",	     "tired",
+	"north",    "south",	"east",	    "west",    "center",     "edge",
+	"start",    "middle",	"end",	    "begin",   "finish",     "complete",
+	"tiny",	    "small",	"medium",   "large",   "huge",	     "giant",
+	"fast",	    "slow",	"gauss",    "rapid",   "swift",	     "gradual",
+	"light",    "dark",	"bright",   "dim",     "shadow",     "glow"
+};
+const size_t test_strings_size = sizeof(test_strings) / sizeof(const char *);
+
+size_t count_slabs(const Hashmap *map)
+{
+	const union HashmapSlab *slab = NULL;
+	size_t count = 0;
+
+	for (slab = map->slabs; slab != NULL; slab = slab->header.next) {
+		count++;
+	}
+
+	return count;
+}
+
+struct HashmapListNode *find_node(const Hashmap *map, const char *key)
+{
+	struct HashmapListNode *node = NULL;
+
+	for (node = *hashmap_bucket(map, hashmap_hash(map, key)); node != NULL;
+	     node = node->next) {
+		if (strcmp(node->key, key) == 0) {
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_nodes_from_slab(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode *first = NULL;
+	size_t idx = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < HASHMAP_SLAB_SIZE; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(1, count_slabs(&map));
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_SLAB_SIZE, map.slabs->header.used);
+
+	/* Nodes are contiguous in the slab, in insertion order */
+	first = find_node(&map, test_strings[0]);
+	for (idx = 0; idx < HASHMAP_SLAB_SIZE; idx++) {
+		TEST_ASSERT_EQUAL_PTR(first + idx,
+				      find_node(&map, test_strings[idx]));
+	}
+
+	hashmap_insert(&map, test_strings[HASHMAP_SLAB_SIZE], 0);
+
+	TEST_ASSERT_EQUAL_UINT(2, count_slabs(&map));
+	TEST_ASSERT_EQUAL_UINT(1, map.slabs->header.used);
+
+	hashmap_free(&map);
+}
+
+void test_remove_reuses_node(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode *node = NULL;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size / 2; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	node = find_node(&map, test_strings[0]);
+	TEST_ASSERT_EQUAL_INT(1, hashmap_remove(&map, test_strings[0], NULL));
+	TEST_ASSERT_EQUAL_PTR(node, map.free_nodes);
+
+	hashmap_insert(&map, test_strings[test_strings_size - 1], 42);
+
+	TEST_ASSERT_NULL(map.free_nodes);
+	TEST_ASSERT_EQUAL_PTR(node,
+			      find_node(&map,
+					test_strings[test_strings_size - 1]));
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_get(&map, test_strings[test_strings_size - 1],
+			       &gotten));
+	TEST_ASSERT_EQUAL_INT(42, gotten);
+
+	hashmap_free(&map);
+}
+
+void test_clear_releases_slabs(void)
+{
+	Hashmap map = { 0 };
+	size_t capacity = 0;
+	size_t idx = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+	hashmap_remove(&map, test_strings[0], NULL);
+	capacity = map.capacity;
+
+	hashmap_clear(&map);
+
+	TEST_ASSERT_NULL(map.slabs);
+	TEST_ASSERT_NULL(map.free_nodes);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(capacity, map.capacity);
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		TEST_ASSERT_NULL(map.buckets[idx]);
+	}
+
+	hashmap_insert(&map, test_strings[1], 1);
+	TEST_ASSERT_EQUAL_UINT(1, count_slabs(&map));
+	TEST_ASSERT_EQUAL_INT(1, hashmap_has(&map, test_strings[1]));
+
+	hashmap_free(&map);
+}
+
+void test_duplicate_own_slabs(void)
+{
+	Hashmap src = { 0 };
+	Hashmap dest = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&src, test_strings[idx], (int)idx);
+	}
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_NOT_NULL(dest.slabs);
+	TEST_ASSERT_NOT_EQUAL(src.slabs, dest.slabs);
+	TEST_ASSERT_NULL(dest.free_nodes);
+
+	hashmap_free(&src);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&dest, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&dest);
+}
+
+/* Allocation order of a node, counting from the first node of the oldest
+ * slab */
+size_t node_order(const Hashmap *map, const struct HashmapListNode *node)
+{
+	const union HashmapSlab *slab = NULL;
+	const struct HashmapListNode *first = NULL;
+	size_t later_slabs = 0;
+
+	for (slab = map->slabs; slab != NULL; slab = slab->header.next) {
+		first = (const struct HashmapListNode *)(const void *)(slab + 1);
+		if (node >= first && node < first + HASHMAP_SLAB_SIZE) {
+			return (count_slabs(map) - 1 - later_slabs) *
+				       HASHMAP_SLAB_SIZE +
+			       (size_t)(node - first);
+		}
+		later_slabs++;
+	}
+
+	TEST_FAIL();
+	return 0;
+}
+
+void test_build_from_arrays_contiguous(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode *node = NULL;
+	size_t expected = 0;
+	size_t idx = 0;
+	int values[sizeof(test_strings) / sizeof(const char *)];
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		values[idx] = (int)idx;
+	}
+
+	hashmap_build_from_arrays(&map, test_strings, values,
+				  test_strings_size);
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+
+	/* Nodes are laid out bucket after bucket, chain after chain */
+	for (idx = 0; idx < map.capacity; idx++) {
+		for (node = map.buckets[idx]; node != NULL;
+		     node = node->next) {
+			TEST_ASSERT_EQUAL_UINT(expected, node_order(&map, node));
+			expected++;
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, expected);
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_remove(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t inserting = 0;
+	int replaced = 0;
+	int added_total = 0;
+	int removed_total = 0;
+	int removed_value = 0;
+
+	const char *test_string = NULL;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		test_string = test_strings[idx % test_strings_size];
+
+		/* Randomly choose whether we insert or delete */
+		inserting = idx;
+		inserting ^= inserting >> 16;
+		inserting *= 0x85ebca6b;
+		inserting ^= inserting >> 13;
+		inserting *= 0xc2b2ae35;
+		inserting ^= inserting >> 16;
+
+		if (inserting % 2 == 0) {
+			replaced = hashmap_insert(&map, test_string, (int)idx);
+			if (replaced == 0) {
+				added_total++;
+			}
+		} else {
+			removed_total += hashmap_remove(&map, test_string,
+							&removed_value);
+		}
+
+		TEST_ASSERT_EQUAL_UINT(added_total - removed_total, map.size);
+	}
+
+	/* Removed nodes are reused, so slabs never outnumber the keys */
+	TEST_ASSERT_LESS_OR_EQUAL_UINT(
+		(test_strings_size + HASHMAP_SLAB_SIZE - 1) / HASHMAP_SLAB_SIZE,
+		count_slabs(&map));
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_nodes_from_slab);
+	RUN_TEST(test_remove_reuses_node);
+	RUN_TEST(test_clear_releases_slabs);
+	RUN_TEST(test_duplicate_own_slabs);
+	RUN_TEST(test_build_from_arrays_contiguous);
+	RUN_TEST(test_insert_and_remove);
+
+	return UNITY_END();
+}
@@ -0,0 +1,3 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE_STRING_KEY(Hashmap, hashmap, int)
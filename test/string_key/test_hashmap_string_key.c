@@ -0,0 +1,155 @@
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_MAX_LEN = 100 };
+
+jmp_buf abort_jmp;
+
+const char *test_strings[] = { "alice", "bob", "charlie", "delta", "echo",
+			       "foxtrot" };
+const size_t test_strings_size = sizeof(test_strings) / sizeof(const char *);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_string_key(void)
+{
+	Hashmap map = { 0 };
+	HashmapStringKey key = hashmap_string_key(&map, "hello");
+
+	/* Building a key picks the seed of the map */
+	TEST_ASSERT_NOT_NULL(map.buckets);
+
+	TEST_ASSERT_EQUAL_PTR("hello", key.ptr);
+	TEST_ASSERT_EQUAL_UINT(5, key.len);
+	TEST_ASSERT_TRUE(key.hash ==
+			 hashmap_hash_str_seeded("hello", map.seed));
+	TEST_ASSERT_TRUE(hashmap_hash(&map, key) == key.hash);
+
+	hashmap_free(&map);
+}
+
+void test_lookup_from_copies(void)
+{
+	Hashmap map = { 0 };
+	char buffer[16];
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map,
+			       hashmap_string_key(&map, test_strings[idx]),
+			       (int)idx);
+	}
+
+	/* Same bytes at another address */
+	for (idx = 0; idx < test_strings_size; idx++) {
+		strcpy(buffer, test_strings[idx]);
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, hashmap_string_key(&map, buffer),
+				       &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	/* Prefix, not terminated where the key is */
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_has(&map, hashmap_string_key_len(&map, "bobby", 3)));
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_key_len(&map, "bob", 2)));
+
+	hashmap_free(&map);
+}
+
+void test_compare(void)
+{
+	Hashmap map = { 0 };
+	char first[TEST_MAX_LEN];
+	char second[TEST_MAX_LEN];
+	HashmapStringKey key1;
+	HashmapStringKey key2;
+	size_t len = 0;
+	size_t pos = 0;
+
+	memset(first, 'x', sizeof(first));
+	memset(second, 'x', sizeof(second));
+
+	/* Shorter than a block, one or several blocks, and a last block
+	 * overlapping the previous one */
+	for (len = 0; len < TEST_MAX_LEN; len++) {
+		key1 = hashmap_string_key_len(&map, first, len);
+		key2 = hashmap_string_key_len(&map, second, len);
+		TEST_ASSERT_EQUAL_INT(0,
+				      hashmap_string_key_compare(key1, key2));
+		TEST_ASSERT_EQUAL_INT(1,
+				      hashmap_bytes_equal(first, second, len));
+
+		/* A difference at any position is found */
+		for (pos = 0; pos < len; pos++) {
+			second[pos] = 'y';
+			TEST_ASSERT_EQUAL_INT(
+				0, hashmap_bytes_equal(first, second, len));
+			second[pos] = 'x';
+		}
+
+		/* Same hash and length, other bytes: compared nonetheless */
+		if (len > 0) {
+			second[len - 1] = 'y';
+			key2.ptr = second;
+			TEST_ASSERT_NOT_EQUAL(
+				0, hashmap_string_key_compare(key1, key2));
+			second[len - 1] = 'x';
+		}
+	}
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_remove(void)
+{
+	Hashmap map = { 0 };
+	char keys[TEST_MAX_LEN][TEST_MAX_LEN];
+	HashmapStringKey key;
+	size_t idx = 0;
+	int gotten = 0;
+
+	/* Long keys sharing prefixes, differing only in their last byte */
+	for (idx = 0; idx < TEST_MAX_LEN; idx++) {
+		memset(keys[idx], 'k', TEST_MAX_LEN);
+		keys[idx][TEST_MAX_LEN - 1] = (char)idx;
+		key = hashmap_string_key_len(&map, keys[idx], TEST_MAX_LEN);
+		hashmap_insert(&map, key, (int)idx);
+	}
+	TEST_ASSERT_EQUAL_UINT(TEST_MAX_LEN, map.size);
+
+	for (idx = 0; idx < TEST_MAX_LEN; idx += 2) {
+		key = hashmap_string_key_len(&map, keys[idx], TEST_MAX_LEN);
+		TEST_ASSERT_EQUAL_INT(1, hashmap_remove(&map, key, &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	for (idx = 0; idx < TEST_MAX_LEN; idx++) {
+		key = hashmap_string_key_len(&map, keys[idx], TEST_MAX_LEN);
+		TEST_ASSERT_EQUAL_INT(idx % 2, hashmap_has(&map, key));
+	}
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_string_key);
+	RUN_TEST(test_lookup_from_copies);
+	RUN_TEST(test_compare);
+	RUN_TEST(test_insert_and_remove);
+
+	return UNITY_END();
+}
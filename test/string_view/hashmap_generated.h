@@ -0,0 +1,9 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#include "hashmap.h"
+
+HASHMAP_DECLARE_STRING_VIEW(Hashmap, hashmap, int)
+
+#endif /* HASHMAP_GENERATED_H */
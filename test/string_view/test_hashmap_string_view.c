@@ -0,0 +1,159 @@
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+jmp_buf abort_jmp;
+
+/* Keys as they would arrive in a packet: length-delimited, not terminated */
+const char packet[] = "alicebobcharliealphabetalpha\0nul\0";
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_lookup_from_other_buffer(void)
+{
+	Hashmap map = { 0 };
+	char buffer[sizeof(packet)];
+	int gotten = 0;
+
+	hashmap_insert(&map, hashmap_string_view(packet, 5), 1);
+	hashmap_insert(&map, hashmap_string_view(packet + 5, 3), 2);
+	hashmap_insert(&map, hashmap_string_view(packet + 8, 7), 3);
+
+	/* Same bytes elsewhere, no terminator after them */
+	memcpy(buffer, packet, sizeof(packet));
+	buffer[5] = 'X';
+
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_get(&map, hashmap_string_view(buffer, 5), &gotten));
+	TEST_ASSERT_EQUAL_INT(1, gotten);
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_get(&map, hashmap_string_view("bob", 3), &gotten));
+	TEST_ASSERT_EQUAL_INT(2, gotten);
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map,
+					     hashmap_string_view(buffer + 8, 7),
+					     &gotten));
+	TEST_ASSERT_EQUAL_INT(3, gotten);
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_view(buffer + 5, 3)));
+
+	hashmap_free(&map);
+}
+
+void test_prefixes_differ(void)
+{
+	Hashmap map = { 0 };
+	int gotten = 0;
+
+	/* "alphabet" and its prefix "alpha" */
+	hashmap_insert(&map, hashmap_string_view(packet + 15, 8), 8);
+	hashmap_insert(&map, hashmap_string_view(packet + 15, 5), 5);
+
+	TEST_ASSERT_EQUAL_UINT(2, map.size);
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map,
+					     hashmap_string_view("alpha", 5),
+					     &gotten));
+	TEST_ASSERT_EQUAL_INT(5, gotten);
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map,
+					     hashmap_string_view(packet + 23, 5),
+					     &gotten));
+	TEST_ASSERT_EQUAL_INT(5, gotten);
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_view("alph", 4)));
+
+	hashmap_free(&map);
+}
+
+void test_embedded_nul(void)
+{
+	Hashmap map = { 0 };
+	int gotten = 0;
+
+	/* "alpha\0nul" is not "alpha" */
+	hashmap_insert(&map, hashmap_string_view(packet + 23, 9), 9);
+
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_view("alpha", 5)));
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_view("alpha\0nux", 9)));
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_get(&map, hashmap_string_view("alpha\0nul", 9),
+			       &gotten));
+	TEST_ASSERT_EQUAL_INT(9, gotten);
+
+	hashmap_free(&map);
+}
+
+void test_empty_key(void)
+{
+	Hashmap map = { 0 };
+	int gotten = 0;
+
+	hashmap_insert(&map, hashmap_string_view(NULL, 0), 42);
+
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_get(&map, hashmap_string_view(packet, 0), &gotten));
+	TEST_ASSERT_EQUAL_INT(42, gotten);
+	TEST_ASSERT_EQUAL_INT(
+		0, hashmap_has(&map, hashmap_string_view(packet, 1)));
+
+	TEST_ASSERT_EQUAL_INT(
+		1, hashmap_remove(&map, hashmap_string_view("", 0), NULL));
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+
+	hashmap_free(&map);
+}
+
+void test_many_keys(void)
+{
+	Hashmap map = { 0 };
+	HashmapIter iter;
+	const HashmapStringView *key = NULL;
+	int *value = NULL;
+	size_t len = 0;
+	size_t visited = 0;
+	int gotten = 0;
+
+	/* Every prefix of the packet is a distinct key */
+	for (len = 0; len <= sizeof(packet); len++) {
+		hashmap_insert(&map, hashmap_string_view(packet, len), (int)len);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(sizeof(packet) + 1, map.size);
+
+	for (len = 0; len <= sizeof(packet); len++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, hashmap_string_view(packet, len),
+				       &gotten));
+		TEST_ASSERT_EQUAL_INT(len, gotten);
+	}
+
+	hashmap_iter_begin(&map, &iter);
+	while (hashmap_iter_next(&iter, &key, &value)) {
+		TEST_ASSERT_EQUAL_UINT(*value, key->len);
+		TEST_ASSERT_EQUAL_PTR(packet, key->ptr);
+		visited++;
+	}
+	TEST_ASSERT_EQUAL_UINT(map.size, visited);
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_lookup_from_other_buffer);
+	RUN_TEST(test_prefixes_differ);
+	RUN_TEST(test_embedded_nul);
+	RUN_TEST(test_empty_key);
+	RUN_TEST(test_many_keys);
+
+	return UNITY_END();
+}
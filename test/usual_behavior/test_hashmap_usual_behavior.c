@@ -196,6 +196,553 @@ void test_grow(void)
 	hashmap_free(&map);
 }
 
+/* Growing relinks the existing nodes instead of allocating new ones */
+void test_grow_keeps_nodes(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode *nodes[sizeof(test_strings) /
+				      sizeof(const char *)];
+	struct HashmapListNode *node = NULL;
+	size_t idx = 0;
+	size_t bucket = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (bucket = 0; bucket < map.capacity; bucket++) {
+		for (node = map.buckets[bucket]; node != NULL;
+		     node = node->next) {
+			nodes[node->value] = node;
+		}
+	}
+
+	hashmap_grow(&map);
+
+	for (bucket = 0; bucket < map.capacity; bucket++) {
+		for (node = map.buckets[bucket]; node != NULL;
+		     node = node->next) {
+			TEST_ASSERT_EQUAL_PTR(nodes[node->value], node);
+			TEST_ASSERT_EQUAL_UINT(
+				bucket, hashmap_hash_index(&map, node->key));
+		}
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, hashmap_has(&map, test_strings[idx]));
+	}
+
+	hashmap_free(&map);
+}
+
+void test_reserve_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_reserve(&map, 100);
+	TEST_ASSERT_NOT_NULL(map.buckets);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.buckets_filled);
+	/* 100 / 128 is above 0.75, 100 / 256 is not */
+	TEST_ASSERT_EQUAL_UINT(256, map.capacity);
+	hashmap_free(&map);
+}
+
+void test_reserve(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode **buckets = NULL;
+	size_t capacity = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size / 2; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_reserve(&map, test_strings_size);
+	TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+		HASHMAP_LOAD_FACTOR,
+		(float)test_strings_size / (float)map.capacity);
+	TEST_ASSERT_GREATER_THAN_FLOAT(
+		HASHMAP_LOAD_FACTOR,
+		(float)test_strings_size / (float)(map.capacity >> 1));
+	TEST_ASSERT_NULL(map.old_buckets);
+
+	/* Reserving less than the capacity is a no-op */
+	buckets = map.buckets;
+	capacity = map.capacity;
+	hashmap_reserve(&map, 1);
+	TEST_ASSERT_EQUAL_PTR(buckets, map.buckets);
+	TEST_ASSERT_EQUAL_UINT(capacity, map.capacity);
+
+	/* Inserting up to the reserved count never grows */
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		TEST_ASSERT_EQUAL_PTR(buckets, map.buckets);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_shrink_to_fit_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_shrink_to_fit(&map);
+	TEST_ASSERT_NULL(map.buckets);
+	TEST_ASSERT_EQUAL_UINT(0, map.capacity);
+}
+
+void test_shrink_to_fit(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_reserve(&map, 1000);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+	for (idx = 0; idx < test_strings_size - 6; idx++) {
+		hashmap_remove(&map, test_strings[idx], NULL);
+	}
+
+	hashmap_shrink_to_fit(&map);
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.capacity);
+	TEST_ASSERT_EQUAL_UINT(6, map.size);
+
+	for (; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	/* Already fitting, no-op */
+	hashmap_insert(&map, test_strings[0], 0);
+	hashmap_shrink_to_fit(&map);
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.capacity);
+
+	hashmap_clear(&map);
+	hashmap_reserve(&map, test_strings_size);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+	for (idx = 0; idx < test_strings_size / 2; idx++) {
+		hashmap_remove(&map, test_strings[idx], NULL);
+	}
+
+	hashmap_shrink_to_fit(&map);
+	TEST_ASSERT_LESS_OR_EQUAL_FLOAT(HASHMAP_LOAD_FACTOR,
+					(float)map.size / (float)map.capacity);
+	TEST_ASSERT_GREATER_THAN_FLOAT(
+		HASHMAP_LOAD_FACTOR,
+		(float)map.size / (float)(map.capacity >> 1));
+
+	for (; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_get_many_from_zero(void)
+{
+	Hashmap map = { 0 };
+	int found[3] = { 1, 1, 1 };
+
+	TEST_ASSERT_EQUAL_UINT(
+		0, hashmap_get_many(&map, test_strings, 3, NULL, found));
+	TEST_ASSERT_EQUAL_INT(0, found[0]);
+	TEST_ASSERT_EQUAL_INT(0, found[1]);
+	TEST_ASSERT_EQUAL_INT(0, found[2]);
+	TEST_ASSERT_NULL(map.buckets);
+}
+
+void test_get_many(void)
+{
+	Hashmap map = { 0 };
+	int values[sizeof(test_strings) / sizeof(const char *)];
+	int found[sizeof(test_strings) / sizeof(const char *)];
+	size_t idx = 0;
+
+	/* Only even keys, so batches mix hits and misses */
+	for (idx = 0; idx < test_strings_size; idx += 2) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		values[idx] = -1;
+	}
+
+	TEST_ASSERT_EQUAL_UINT((test_strings_size + 1) / 2,
+			       hashmap_get_many(&map, test_strings,
+						test_strings_size, values,
+						found));
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx % 2 == 0, found[idx]);
+		TEST_ASSERT_EQUAL_INT(idx % 2 == 0 ? (int)idx : -1,
+				      values[idx]);
+	}
+
+	/* Outputs are optional */
+	TEST_ASSERT_EQUAL_UINT(
+		1, hashmap_get_many(&map, test_strings, 1, NULL, NULL));
+	TEST_ASSERT_EQUAL_UINT(0,
+			       hashmap_get_many(&map, NULL, 0, values, found));
+
+	hashmap_free(&map);
+}
+
+void test_get_ptr_from_zero(void)
+{
+	Hashmap map = { 0 };
+	TEST_ASSERT_NULL(hashmap_get_ptr(&map, test_strings[0]));
+	TEST_ASSERT_NULL(map.buckets);
+}
+
+void test_get_ptr(void)
+{
+	Hashmap map = { 0 };
+	int *values[sizeof(test_strings) / sizeof(const char *)];
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		values[idx] = hashmap_get_ptr(&map, test_strings[idx]);
+		TEST_ASSERT_NOT_NULL(values[idx]);
+		TEST_ASSERT_EQUAL_INT(idx, *values[idx]);
+	}
+
+	/* Pointers survive growth, and update the stored value in place */
+	hashmap_grow(&map);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_PTR(values[idx],
+				      hashmap_get_ptr(&map, test_strings[idx]));
+		*values[idx] += 1000;
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx + 1000, gotten);
+	}
+
+	hashmap_remove(&map, test_strings[0], NULL);
+	TEST_ASSERT_NULL(hashmap_get_ptr(&map, test_strings[0]));
+
+	hashmap_free(&map);
+}
+
+void test_insert_unique(void)
+{
+	Hashmap map = { 0 };
+	struct HashmapListNode *node = NULL;
+	size_t idx = 0;
+	size_t filled = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert_unique(&map, test_strings[idx], (int)idx);
+		TEST_ASSERT_EQUAL_UINT(idx + 1, map.size);
+
+		/* Pushed at the head of its chain */
+		node = map.buckets[hashmap_hash_index(&map, test_strings[idx])];
+		TEST_ASSERT_EQUAL_STRING(test_strings[idx], node->key);
+	}
+
+	TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+		HASHMAP_LOAD_FACTOR,
+		(float)(map.size - 1) / (float)map.capacity);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		filled += map.buckets[idx] != NULL;
+	}
+	TEST_ASSERT_EQUAL_UINT(map.buckets_filled, filled);
+
+	hashmap_free(&map);
+}
+
+void test_build_from_arrays(void)
+{
+	Hashmap map = { 0 };
+	const char *keys[sizeof(test_strings) / sizeof(const char *) + 1];
+	int values[sizeof(test_strings) / sizeof(const char *) + 1];
+	size_t filled = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		keys[idx] = test_strings[idx];
+		values[idx] = (int)idx;
+	}
+	/* Duplicates keep the last value, like hashmap_insert() */
+	keys[test_strings_size] = test_strings[0];
+	values[test_strings_size] = 42;
+
+	hashmap_insert(&map, test_strings[1], -1);
+	hashmap_build_from_arrays(&map, keys, values, test_strings_size + 1);
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+	TEST_ASSERT_LESS_OR_EQUAL_FLOAT(HASHMAP_LOAD_FACTOR,
+					(float)map.size / (float)map.capacity);
+
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map, test_strings[0], &gotten));
+	TEST_ASSERT_EQUAL_INT(42, gotten);
+	for (idx = 1; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		filled += map.buckets[idx] != NULL;
+	}
+	TEST_ASSERT_EQUAL_UINT(map.buckets_filled, filled);
+
+	/* Nothing to build, but still initializes */
+	hashmap_free(&map);
+	hashmap_build_from_arrays(&map, NULL, NULL, 0);
+	TEST_ASSERT_NOT_NULL(map.buckets);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+
+	hashmap_free(&map);
+}
+
+void test_hash_buf(void)
+{
+	const char *quick = "The quick brown fox jumps over the lazy dog";
+	char shifted[64];
+	size_t idx = 0;
+
+	/* Pinned so that hashes stay stable across platforms and releases */
+#if ULONG_MAX > 0xFFFFFFFFUL
+	TEST_ASSERT_TRUE(hashmap_hash_str("hello") == 0xD35FDE0222AD4F2FUL);
+	TEST_ASSERT_TRUE(hashmap_hash_str(quick) == 0xCF34F44701D96F19UL);
+#else
+	/* MurmurHash3_x86_32 reference values, seed 0 */
+	TEST_ASSERT_TRUE(hashmap_hash_str("hello") == 0x248BFA47UL);
+	TEST_ASSERT_TRUE(hashmap_hash_str(quick) == 0x2E4FF723UL);
+#endif
+	TEST_ASSERT_TRUE(hashmap_hash_str("") == 0);
+
+	/* Same bytes hash the same wherever they are */
+	for (idx = 0; idx < 8; idx++) {
+		strcpy(shifted + idx, quick);
+		TEST_ASSERT_TRUE(hashmap_hash_str(shifted + idx) ==
+				 hashmap_hash_str(quick));
+		TEST_ASSERT_TRUE(hashmap_hash_buf(shifted + idx,
+						  strlen(quick)) ==
+				 hashmap_hash_str(quick));
+	}
+
+	/* Every length goes through the tail path once */
+	for (idx = 1; idx < 16; idx++) {
+		TEST_ASSERT_TRUE(hashmap_hash_buf(quick, idx) !=
+				 hashmap_hash_buf(quick, idx - 1));
+	}
+}
+
+void test_seed(void)
+{
+	Hashmap first = { 0 };
+	Hashmap second = { 0 };
+	Hashmap copy = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&first);
+	hashmap_init(&second);
+	second.seed = first.seed ^ 1UL;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&first, test_strings[idx], (int)idx);
+		hashmap_insert(&second, test_strings[idx], (int)idx);
+
+		/* Same key, other seed, other hash */
+		TEST_ASSERT_TRUE(hashmap_hash(&first, test_strings[idx]) !=
+				 hashmap_hash(&second, test_strings[idx]));
+		TEST_ASSERT_TRUE(
+			hashmap_hash_buf_seeded(test_strings[idx],
+						strlen(test_strings[idx]),
+						first.seed) !=
+			hashmap_hash_buf_seeded(test_strings[idx],
+						strlen(test_strings[idx]),
+						second.seed));
+	}
+
+	/* Seed 0 is the unseeded hash */
+	TEST_ASSERT_TRUE(hashmap_hash_str_seeded(test_strings[0], 0) ==
+			 hashmap_hash_str(test_strings[0]));
+
+	/* Growth and duplicates keep the seed */
+	hashmap_duplicate(&copy, &first);
+	TEST_ASSERT_TRUE(copy.seed == first.seed);
+	hashmap_clear(&first);
+	TEST_ASSERT_TRUE(copy.seed == first.seed);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&second, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&copy, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&first);
+	hashmap_free(&second);
+	hashmap_free(&copy);
+}
+
+void test_hashed(void)
+{
+	Hashmap first = { 0 };
+	Hashmap second = { 0 };
+	unsigned long hashes[sizeof(test_strings) / sizeof(const char *)];
+	size_t idx = 0;
+	int gotten = 0;
+
+	/* Hash once, use in both maps and across their grows. Hashes depend
+	 * on the seed picked by hashmap_init(), so both maps share it. */
+	hashmap_init(&first);
+	hashmap_init_seeded(&second, first.seed);
+	TEST_ASSERT_TRUE(second.seed == first.seed);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashes[idx] = hashmap_hash(&first, test_strings[idx]);
+		TEST_ASSERT_EQUAL_INT(0, hashmap_insert_hashed(
+						 &first, test_strings[idx],
+						 hashes[idx], (int)idx));
+		TEST_ASSERT_EQUAL_INT(0, hashmap_insert_hashed(
+						 &second, test_strings[idx],
+						 hashes[idx], -(int)idx));
+	}
+	TEST_ASSERT_EQUAL_INT(1, hashmap_insert_hashed(&first, test_strings[0],
+						       hashes[0], 0));
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, hashmap_get_hashed(&first,
+							    test_strings[idx],
+							    hashes[idx],
+							    &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+		TEST_ASSERT_EQUAL_INT(1, hashmap_get_hashed(&second,
+							    test_strings[idx],
+							    hashes[idx],
+							    &gotten));
+		TEST_ASSERT_EQUAL_INT(-(int)idx, gotten);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx += 2) {
+		TEST_ASSERT_EQUAL_INT(1, hashmap_remove_hashed(
+						 &first, test_strings[idx],
+						 hashes[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+		TEST_ASSERT_EQUAL_INT(0, hashmap_remove_hashed(
+						 &first, test_strings[idx],
+						 hashes[idx], NULL));
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx % 2,
+				      hashmap_has(&first, test_strings[idx]));
+		TEST_ASSERT_EQUAL_INT(1,
+				      hashmap_has(&second, test_strings[idx]));
+	}
+
+	hashmap_free(&first);
+	hashmap_free(&second);
+}
+
+void test_get_or_insert(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int inserted = 0;
+	int *value = NULL;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size * 3; idx++) {
+		value = hashmap_get_or_insert(
+			&map, test_strings[idx % test_strings_size], 0,
+			&inserted);
+		TEST_ASSERT_NOT_NULL(value);
+		TEST_ASSERT_EQUAL_INT(idx < test_strings_size, inserted);
+		(*value)++;
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(3, gotten);
+	}
+
+	/* Existing values are kept, inserted may be NULL */
+	value = hashmap_get_or_insert(&map, test_strings[0], 42, NULL);
+	TEST_ASSERT_EQUAL_INT(3, *value);
+	TEST_ASSERT_EQUAL_PTR(value, hashmap_get_ptr(&map, test_strings[0]));
+
+	hashmap_free(&map);
+}
+
+void count_upsert(const char *key, int *value, int existed, void *context)
+{
+	TEST_ASSERT_NOT_NULL(key);
+	if (!existed) {
+		TEST_ASSERT_EQUAL_INT(0, *value);
+		(*(size_t *)context)++;
+	}
+	(*value)++;
+}
+
+void test_upsert(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t inserted = 0;
+	int existed = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size * 2; idx++) {
+		existed = hashmap_upsert(&map,
+					 test_strings[idx % test_strings_size],
+					 count_upsert, &inserted);
+		TEST_ASSERT_EQUAL_INT(idx >= test_strings_size, existed);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, inserted);
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(2, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
 void test_insert_from_zero(void)
 {
 	Hashmap map = { 0 };
@@ -756,6 +1303,102 @@ void test_iterate_from_zero(void)
 	TEST_ASSERT_EQUAL_MEMORY(&map, &expected, sizeof(Hashmap));
 }
 
+void test_iter_from_zero(void)
+{
+	Hashmap map = { 0 };
+	HashmapIter iter;
+
+	hashmap_iter_begin(&map, &iter);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_next(&iter, NULL, NULL));
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_remove(&iter));
+	TEST_ASSERT_NULL(map.buckets);
+}
+
+void test_iter(void)
+{
+	Hashmap map = { 0 };
+	HashmapIter iter;
+	char seen[sizeof(test_strings) / sizeof(const char *)] = { 0 };
+	const char *const *key = NULL;
+	int *value = NULL;
+	size_t visited = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_iter_begin(&map, &iter);
+	while (hashmap_iter_next(&iter, &key, &value)) {
+		TEST_ASSERT_EQUAL_STRING(test_strings[*value], *key);
+		TEST_ASSERT_EQUAL_INT(0, seen[*value]);
+		seen[*value] = 1;
+		*value += 1000;
+		visited++;
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, visited);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_next(&iter, &key, &value));
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx + 1000, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_iter_remove(void)
+{
+	Hashmap map = { 0 };
+	HashmapIter iter;
+	int *value = NULL;
+	size_t filled = 0;
+	size_t visited = 0;
+	size_t idx = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	/* Remove odd values, every element is still visited once */
+	hashmap_iter_begin(&map, &iter);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_iter_remove(&iter));
+	while (hashmap_iter_next(&iter, NULL, &value)) {
+		visited++;
+		if (*value % 2 == 1) {
+			TEST_ASSERT_EQUAL_INT(1, hashmap_iter_remove(&iter));
+			TEST_ASSERT_EQUAL_INT(0, hashmap_iter_remove(&iter));
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, visited);
+	TEST_ASSERT_EQUAL_UINT((test_strings_size + 1) / 2, map.size);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx % 2 == 0,
+				      hashmap_has(&map, test_strings[idx]));
+	}
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		filled += map.buckets[idx] != NULL;
+	}
+	TEST_ASSERT_EQUAL_UINT(map.buckets_filled, filled);
+
+	/* Remove everything left */
+	hashmap_iter_begin(&map, &iter);
+	while (hashmap_iter_next(&iter, NULL, NULL)) {
+		hashmap_iter_remove(&iter);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.buckets_filled);
+
+	hashmap_free(&map);
+}
+
 void test_duplicate_from_zero(void)
 {
 	Hashmap expected = { 0 };
@@ -827,6 +1470,22 @@ int main(void)
 	RUN_TEST(test_grow_overflow1);
 	RUN_TEST(test_grow_overflow2);
 	RUN_TEST(test_grow);
+	RUN_TEST(test_grow_keeps_nodes);
+	RUN_TEST(test_reserve_from_zero);
+	RUN_TEST(test_reserve);
+	RUN_TEST(test_shrink_to_fit_from_zero);
+	RUN_TEST(test_shrink_to_fit);
+	RUN_TEST(test_get_many_from_zero);
+	RUN_TEST(test_get_many);
+	RUN_TEST(test_get_ptr_from_zero);
+	RUN_TEST(test_get_ptr);
+	RUN_TEST(test_insert_unique);
+	RUN_TEST(test_build_from_arrays);
+	RUN_TEST(test_hash_buf);
+	RUN_TEST(test_seed);
+	RUN_TEST(test_hashed);
+	RUN_TEST(test_get_or_insert);
+	RUN_TEST(test_upsert);
 	RUN_TEST(test_insert_from_zero);
 	RUN_TEST(test_insert_and_find);
 	RUN_TEST(test_insert_and_find_no_get_out);
@@ -846,6 +1505,9 @@ int main(void)
 	RUN_TEST(test_iterate_break);
 	RUN_TEST(test_iterate_from_zero);
 	RUN_TEST(test_iterate_from_almost_zero);
+	RUN_TEST(test_iter_from_zero);
+	RUN_TEST(test_iter);
+	RUN_TEST(test_iter_remove);
 	RUN_TEST(test_duplicate_from_zero);
 	RUN_TEST(test_duplicate_to_zero);
 	RUN_TEST(test_clear_zero);
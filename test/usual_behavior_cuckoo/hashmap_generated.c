@@ -0,0 +1,23 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE_CUCKOO(Hashmap, hashmap, const char *, int,
+		      hashmap_fnv1a_32_str, strcmp)
+
+unsigned long colliding_hash(const char *key)
+{
+	(void)key;
+	return 42;
+}
+
+HASHMAP_DEFINE_CUCKOO(CollidingMap, colliding_map, const char *, int,
+		      colliding_hash, strcmp)
+
+unsigned long identity_hash(unsigned long key)
+{
+	return key;
+}
+
+HASHMAP_DEFINE_CUCKOO(IdentityMap, identity_map, unsigned long, int,
+		      identity_hash, NULL)
+
+HASHMAP_DEFINE_CUCKOO(PtrMap, ptr_map, const void *, int, NULL, NULL)
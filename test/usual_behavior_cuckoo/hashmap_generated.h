@@ -0,0 +1,25 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#include "hashmap.h"
+
+HASHMAP_DECLARE_CUCKOO(Hashmap, hashmap, const char *, int,
+		       hashmap_fnv1a_32_str, strcmp)
+
+/* Every key hashes the same */
+unsigned long colliding_hash(const char *key);
+
+HASHMAP_DECLARE_CUCKOO(CollidingMap, colliding_map, const char *, int,
+		       colliding_hash, strcmp)
+
+/* Keys are their own hash */
+unsigned long identity_hash(unsigned long key);
+
+HASHMAP_DECLARE_CUCKOO(IdentityMap, identity_map, unsigned long, int,
+		       identity_hash, NULL)
+
+/* Keys hashed by their bytes, with the seed of the map */
+HASHMAP_DECLARE_CUCKOO(PtrMap, ptr_map, const void *, int, NULL, NULL)
+
+#endif /* HASHMAP_GENERATED_H */
@@ -58,7 +58,16 @@ void test_custom_comparison(void)
 
 void test_custom_hash(void)
 {
-	TEST_ASSERT_EQUAL(hashmap_fnv1a_32_str, hashmap_compare_hash_callback());
+	Hashmap map = { 0 };
+
+	TEST_ASSERT_NULL(hashmap_compare_hash_callback());
+	TEST_ASSERT_EQUAL(hashmap_hash_str_seeded,
+			  hashmap_compare_seeded_hash_callback());
+
+	hashmap_init(&map);
+	TEST_ASSERT_TRUE(hashmap_hash(&map, "hello") ==
+			 hashmap_hash_str_seeded("hello", map.seed));
+	hashmap_free(&map);
 }
 
 void test_init_from_zero(void)
@@ -206,6 +215,101 @@ void test_grow(void)
 	hashmap_free(&map);
 }
 
+void test_max_load_factor(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	map.max_load_factor = 2.0f;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+			2.0f, (float)(map.size - 1) / (float)map.capacity);
+	}
+
+	TEST_ASSERT_GREATER_THAN_FLOAT(
+		HASHMAP_LOAD_FACTOR, (float)map.size / (float)map.capacity);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_growth_factor(void)
+{
+	Hashmap map = { 0 };
+	size_t previous_capacity = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	map.growth_factor = 4;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		previous_capacity = map.capacity;
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		if (previous_capacity != map.capacity) {
+			TEST_ASSERT_EQUAL_UINT(previous_capacity * 4,
+					       map.capacity);
+		}
+	}
+
+	TEST_ASSERT_GREATER_THAN_UINT(HASHMAP_DEFAULT_CAPACITY * 4,
+				      map.capacity);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_min_load_factor(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t remaining = 0;
+	int gotten = 0;
+
+	hashmap_init(&map);
+	map.min_load_factor = 0.25f;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_remove(&map, test_strings[idx], NULL);
+
+		if (map.capacity > HASHMAP_DEFAULT_CAPACITY) {
+			TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(
+				0.25f, (float)map.size / (float)map.capacity);
+		}
+
+		for (remaining = idx + 1; remaining < test_strings_size;
+		     remaining++) {
+			TEST_ASSERT_EQUAL_INT(
+				1, hashmap_get(&map, test_strings[remaining],
+					       &gotten));
+			TEST_ASSERT_EQUAL_INT(remaining, gotten);
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_DEFAULT_CAPACITY, map.capacity);
+	TEST_ASSERT_EQUAL_UINT(0, map.buckets_filled);
+
+	hashmap_free(&map);
+}
+
 void test_insert_from_zero(void)
 {
 	Hashmap map = { 0 };
@@ -838,6 +942,9 @@ int main(void)
 	RUN_TEST(test_grow_overflow1);
 	RUN_TEST(test_grow_overflow2);
 	RUN_TEST(test_grow);
+	RUN_TEST(test_max_load_factor);
+	RUN_TEST(test_growth_factor);
+	RUN_TEST(test_min_load_factor);
 	RUN_TEST(test_insert_from_zero);
 	RUN_TEST(test_insert_and_find);
 	RUN_TEST(test_insert_and_find_no_get_out);
@@ -0,0 +1,782 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_STRESS_MULTIPLIER = 1000U, TEST_ITERATIONS_BREAK = 50U };
+enum {
+	TEST_INITIAL_CAPACITY =
+		HASHMAP_DEFAULT_CAPACITY > HASHMAP_HOPSCOTCH_NEIGHBORHOOD ?
+			HASHMAP_DEFAULT_CAPACITY :
+			HASHMAP_HOPSCOTCH_NEIGHBORHOOD + 1,
+	TEST_KEY_LENGTH = 16,
+	TEST_GENERATED_KEYS = 20000,
+	TEST_CROWDED_KEYS = 48,
+	TEST_CROWDED_SLOTS = 1024
+};
+
+jmp_buf abort_jmp;
+
+const char *test_strings[] = {
+	"hello",    "world",	"dragons!", "testing", "hashmap",    "function",
+	"alice",    "bob",	"charlie",  "delta",   "echo",	     "foxtrot",
+	"apple",    "banana",	"cherry",   "date",    "elderberry", "fig",
+	"red",	    "green",	"blue",	    "yellow",  "purple",     "orange",
+	"cat",	    "dog",	"bird",	    "fish",    "rabbit",     "hamster",
+	"mountain", "river",	"ocean",    "forest",  "desert",     "valley",
+	"quick",    "brown",	"fox",	    "jumps",   "over",	     "lazy",
+	"alpha",    "beta",	"gamma",    "theta",   "omega",	     "sigma",
+	"one",	    "two",	"three",    "four",    "five",	     "six",
+	"january",  "february", "march",    "april",   "may",	     "june",
+	"coffee",   "tea",	"water",    "juice",   "milk",	     "soda",
+	"keyboard", "mouse",	"screen",   "laptop",  "desktop",    "tablet",
+	"happy",    "sad",	"angry",    "excited", "calm",	     "tired",
+	"north",    "south",	"east",	    "west",    "center",     "edge",
+	"start",    "middle",	"end",	    "begin",   "finish",     "complete",
+	"tiny",	    "small",	"medium",   "large",   "huge",	     "giant",
+	"fast",	    "slow",	"gauss",    "rapid",   "swift",	     "gradual",
+	"light",    "dark",	"bright",   "dim",     "shadow",     "glow"
+};
+const size_t test_strings_size = sizeof(test_strings) / sizeof(const char *);
+
+Hashmap get_garbage_map(void)
+{
+	Hashmap map = { 0 };
+
+	map.slots = (struct HashmapSlot *)0xDEADBEEF;
+	map.iteration_callback = (int (*)(const char *, int, void *))0xDEADBEEF;
+	map.size = 0xDEADBEEF;
+	map.capacity = 0xDEADBEEF;
+
+	return map;
+}
+
+/* Every entry must sit in the neighborhood of its home slot, flagged in the
+ * hop bitmap of that home slot, and every flag must point to an entry */
+void assert_neighborhoods(const Hashmap *map)
+{
+	size_t idx = 0;
+	size_t home = 0;
+	size_t distance = 0;
+	size_t occupied = 0;
+	size_t flagged = 0;
+	HASHMAP_HOP hop = 0;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		for (hop = map->slots[idx].hop & ~HASHMAP_HOPSCOTCH_OCCUPIED;
+		     hop != 0; hop >>= 1) {
+			flagged += hop & 1U;
+		}
+
+		if ((map->slots[idx].hop & HASHMAP_HOPSCOTCH_OCCUPIED) == 0) {
+			continue;
+		}
+
+		occupied++;
+		home = hashmap_hash_index(map, map->slots[idx].key);
+		distance = (idx - home) & (map->capacity - 1);
+		TEST_ASSERT_LESS_THAN_UINT(HASHMAP_HOPSCOTCH_NEIGHBORHOOD,
+					   distance);
+		TEST_ASSERT_TRUE(map->slots[home].hop &
+				 ((HASHMAP_HOP)1 << distance));
+	}
+
+	TEST_ASSERT_EQUAL_UINT(map->size, occupied + map->stash_size);
+	TEST_ASSERT_EQUAL_UINT(map->size, flagged + map->stash_size);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* Occupancy lives in the hop word, so a slot is a key, a value and 32 bits */
+void test_slot_size(void)
+{
+	TEST_ASSERT_LESS_OR_EQUAL_UINT(sizeof(const char *) + 2 * sizeof(int),
+				       sizeof(struct HashmapSlot));
+}
+
+void test_init_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_init(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_init_from_garbage(void)
+{
+	Hashmap map = get_garbage_map();
+
+	hashmap_init(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_grow_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_grow(&map);
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY << 1, map.capacity);
+	hashmap_free(&map);
+}
+
+void test_grow(void)
+{
+	Hashmap map = { 0 };
+	size_t previous_capacity = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		previous_capacity = map.capacity;
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		if (previous_capacity != 0 &&
+		    previous_capacity != map.capacity) {
+			TEST_ASSERT_EQUAL_UINT(previous_capacity << 1,
+					       map.capacity);
+		}
+		TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+			HASHMAP_HOPSCOTCH_LOAD_FACTOR,
+			(float)map.size / (float)map.capacity);
+	}
+
+	assert_neighborhoods(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_insert_from_zero(void)
+{
+	Hashmap map = { 0 };
+	int out = 0;
+
+	hashmap_insert(&map, "hello", 10);
+
+	TEST_ASSERT_EQUAL_UINT(1, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map, "hello", &out));
+	TEST_ASSERT_EQUAL_INT(10, out);
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_find(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int replaced = 0;
+	int found = 0;
+	int gotten = 0;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		gotten = -1;
+		if (idx < test_strings_size) {
+			found = hashmap_get(
+				&map, test_strings[idx % test_strings_size],
+				&gotten);
+			TEST_ASSERT_EQUAL_INT(0, found);
+			TEST_ASSERT_EQUAL_INT(-1, gotten);
+		}
+
+		replaced = hashmap_insert(
+			&map, test_strings[idx % test_strings_size], (int)idx);
+
+		if (idx < test_strings_size) {
+			TEST_ASSERT_EQUAL_UINT(idx + 1, map.size);
+			TEST_ASSERT_EQUAL_INT(0, replaced);
+		} else {
+			TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+			TEST_ASSERT_EQUAL_INT(1, replaced);
+		}
+
+		found = hashmap_get(&map, test_strings[idx % test_strings_size],
+				    &gotten);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	for (idx = 0; idx < max_idx; idx++) {
+		found = hashmap_get(&map, test_strings[idx % test_strings_size],
+				    &gotten);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(max_idx - test_strings_size +
+					      (idx % test_strings_size),
+				      gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_insert_no_init(void)
+{
+	Hashmap map = { 0 };
+
+	hashmap_insert(&map, "hello", 10);
+
+	TEST_ASSERT_EQUAL_UINT(1, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_NOT_NULL(map.slots);
+
+	hashmap_free(&map);
+}
+
+void test_remove_from_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap expected = { 0 };
+	int out = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, hashmap_remove(&map, "hello", &out));
+	TEST_ASSERT_EQUAL_INT(0, out);
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &map, sizeof(Hashmap));
+}
+
+void test_remove_half_even(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+	int gotten = 0;
+	int found = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx += 2) {
+		found = hashmap_remove(&map, test_strings[idx], &removed);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, removed);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size / 2, map.size);
+	assert_neighborhoods(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		found = hashmap_get(&map, test_strings[idx], &gotten);
+
+		if (idx % 2 == 0) {
+			TEST_ASSERT_EQUAL_INT(0, found);
+		} else {
+			TEST_ASSERT_EQUAL_INT(1, found);
+			TEST_ASSERT_EQUAL_INT(idx, gotten);
+		}
+	}
+
+	hashmap_free(&map);
+}
+
+void test_remove_all(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+	int found = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		found = hashmap_remove(&map, test_strings[idx], &removed);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, removed);
+		assert_neighborhoods(&map);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_GREATER_THAN_UINT(0, map.capacity);
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		TEST_ASSERT_EQUAL_UINT(0, map.slots[idx].hop);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_remove_not_inserted(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			0, hashmap_remove(&map, test_strings[idx], &removed));
+		TEST_ASSERT_EQUAL_INT(0, removed);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_remove(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t inserting = 0;
+	int replaced = 0;
+	int added_total = 0;
+	int removed_total = 0;
+	int removed_value = 0;
+
+	const char *test_string = NULL;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		test_string = test_strings[idx % test_strings_size];
+
+		/* Randomly choose whether we insert or delete */
+		inserting = idx;
+		inserting ^= inserting >> 16;
+		inserting *= 0x85ebca6b;
+		inserting ^= inserting >> 13;
+		inserting *= 0xc2b2ae35;
+		inserting ^= inserting >> 16;
+
+		if (inserting % 2 == 0) {
+			replaced = hashmap_insert(&map, test_string, (int)idx);
+			if (replaced == 0) {
+				added_total++;
+			}
+		} else {
+			removed_total += hashmap_remove(&map, test_string,
+							&removed_value);
+		}
+
+		TEST_ASSERT_EQUAL_UINT(added_total - removed_total, map.size);
+	}
+
+	assert_neighborhoods(&map);
+
+	hashmap_free(&map);
+}
+
+/* Fill the table enough for inserts to hop free slots back */
+void test_insert_many_hops(void)
+{
+	Hashmap map = { 0 };
+	char *keys = NULL;
+	size_t idx = 0;
+	int gotten = 0;
+
+	keys = (char *)malloc(TEST_GENERATED_KEYS * TEST_KEY_LENGTH);
+	TEST_ASSERT_NOT_NULL(keys);
+
+	for (idx = 0; idx < TEST_GENERATED_KEYS; idx++) {
+		sprintf(keys + idx * TEST_KEY_LENGTH, "key%lu",
+			(unsigned long)idx);
+		TEST_ASSERT_EQUAL_INT(
+			0, hashmap_insert(&map, keys + idx * TEST_KEY_LENGTH,
+					  (int)idx));
+		TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+			HASHMAP_HOPSCOTCH_LOAD_FACTOR,
+			(float)map.size / (float)map.capacity);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(TEST_GENERATED_KEYS, map.size);
+	assert_neighborhoods(&map);
+
+	for (idx = 0; idx < TEST_GENERATED_KEYS; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, keys + idx * TEST_KEY_LENGTH,
+				       &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+	free(keys);
+}
+
+/* Insert test_strings until an insert panics, returning how many went in */
+size_t insert_colliding_until_panic(CollidingMap *map)
+{
+	volatile size_t idx = 0;
+
+	if (setjmp(abort_jmp) == 0) {
+		for (idx = 0; idx < test_strings_size; idx++) {
+			colliding_map_insert(map, test_strings[idx], (int)idx);
+		}
+		TEST_FAIL();
+	}
+
+	return idx;
+}
+
+/* Keys sharing a hash overflow their neighborhood and the stash at any
+ * capacity */
+void test_insert_colliding(void)
+{
+	CollidingMap map = { 0 };
+	CollidingMap copy = { 0 };
+	size_t inserted = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	inserted = insert_colliding_until_panic(&map);
+
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_HOPSCOTCH_NEIGHBORHOOD +
+				       HASHMAP_HOPSCOTCH_STASH_SIZE,
+			       inserted);
+	TEST_ASSERT_EQUAL_UINT(inserted, map.size);
+	TEST_ASSERT_EQUAL_UINT(HASHMAP_HOPSCOTCH_STASH_SIZE, map.stash_size);
+
+	/* The panicking insert left the map as it was */
+	TEST_ASSERT_EQUAL_INT(0,
+			      colliding_map_has(&map, test_strings[inserted]));
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, colliding_map_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	/* Overwrite a stashed entry */
+	TEST_ASSERT_EQUAL_INT(1,
+			      colliding_map_insert(&map, map.stash[0].key, -1));
+	TEST_ASSERT_EQUAL_INT(
+		1, colliding_map_get(&map, map.stash[0].key, &gotten));
+	TEST_ASSERT_EQUAL_INT(-1, gotten);
+
+	colliding_map_duplicate(&copy, &map);
+
+	/* Remove from slots and stash alike */
+	for (idx = 0; idx < inserted; idx += 2) {
+		TEST_ASSERT_EQUAL_INT(
+			1, colliding_map_remove(&map, test_strings[idx], NULL));
+	}
+	for (idx = 0; idx < inserted; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			idx % 2, colliding_map_has(&map, test_strings[idx]));
+		TEST_ASSERT_EQUAL_INT(
+			1, colliding_map_has(&copy, test_strings[idx]));
+	}
+	TEST_ASSERT_EQUAL_UINT(inserted / 2, map.size);
+
+	colliding_map_free(&map);
+	colliding_map_free(&copy);
+}
+
+/* Keys crowding the same neighborhood beyond the stash grow the table until
+ * they spread */
+void test_insert_crowded(void)
+{
+	IdentityMap map = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	/* All keys share home slot 0 up to TEST_CROWDED_SLOTS slots */
+	for (idx = 0; idx < TEST_CROWDED_KEYS; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			0, identity_map_insert(&map, idx * TEST_CROWDED_SLOTS,
+					       (int)idx));
+		TEST_ASSERT_LESS_OR_EQUAL_UINT(HASHMAP_HOPSCOTCH_STASH_SIZE,
+					       map.stash_size);
+	}
+
+	/* The load factor alone would have kept 64 slots */
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT(2 * TEST_CROWDED_SLOTS,
+					  map.capacity);
+	TEST_ASSERT_EQUAL_UINT(TEST_CROWDED_KEYS, map.size);
+
+	for (idx = 0; idx < TEST_CROWDED_KEYS; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, identity_map_get(
+						 &map, idx * TEST_CROWDED_SLOTS,
+						 &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	identity_map_free(&map);
+}
+
+/* The seed of the map picks the home slots of keys hashed by their bytes */
+void test_seed(void)
+{
+	PtrMap first = { 0 };
+	PtrMap second = { 0 };
+	PtrMap copy = { 0 };
+	unsigned long seed = 0;
+	size_t home = 0;
+	size_t slot = 0;
+	size_t moved = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	ptr_map_init(&first);
+	ptr_map_init(&second);
+	second.seed = first.seed ^ 1UL;
+	seed = first.seed;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		ptr_map_insert(&first, test_strings[idx], (int)idx);
+		ptr_map_insert(&second, test_strings[idx], (int)idx);
+	}
+
+	/* Same keys and capacity, other home slots, each key still within the
+	 * neighborhood of the home slot of its own map */
+	TEST_ASSERT_EQUAL_UINT(first.capacity, second.capacity);
+	for (idx = 0; idx < test_strings_size; idx++) {
+		home = ptr_map_hash_index(&second, test_strings[idx]);
+		slot = ptr_map_find(&second, test_strings[idx]);
+		TEST_ASSERT_TRUE(slot < second.capacity);
+		TEST_ASSERT_TRUE(((slot - home) & (second.capacity - 1)) <
+				 HASHMAP_HOPSCOTCH_NEIGHBORHOOD);
+		if (home != ptr_map_hash_index(&first, test_strings[idx])) {
+			moved++;
+		}
+	}
+	TEST_ASSERT_GREATER_THAN_UINT(test_strings_size / 2, moved);
+
+	/* Growth and duplicates keep the seed */
+	TEST_ASSERT_TRUE(first.seed == seed);
+	ptr_map_duplicate(&copy, &first);
+	TEST_ASSERT_TRUE(copy.seed == seed);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, ptr_map_get(&copy, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+		TEST_ASSERT_EQUAL_INT(
+			1, ptr_map_get(&second, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	ptr_map_free(&first);
+	ptr_map_free(&second);
+	ptr_map_free(&copy);
+}
+
+void test_free(void)
+{
+	Hashmap map = { 0 };
+	Hashmap map_zero = { 0 };
+	hashmap_init(&map);
+	hashmap_free(&map);
+	TEST_ASSERT_EQUAL_MEMORY(&map_zero, &map, sizeof(Hashmap));
+}
+
+void test_free_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap map_zero = { 0 };
+	hashmap_free(&map);
+	TEST_ASSERT_EQUAL_MEMORY(&map_zero, &map, sizeof(Hashmap));
+}
+
+int test_iterate_with_context_callback(const char *key, int val, void *context)
+{
+	size_t *seen = (size_t *)context;
+
+	TEST_ASSERT_NOT_NULL(key);
+	TEST_ASSERT_EQUAL_STRING(test_strings[val], key);
+
+	*seen += 1;
+
+	return 1;
+}
+
+int test_iterate_break_after_x_iter(const char *key, int val, void *context)
+{
+	size_t *total_iteration_count = (size_t *)context;
+
+	(void)key;
+	(void)val;
+
+	if (*total_iteration_count >= TEST_ITERATIONS_BREAK) {
+		return 0;
+	}
+
+	*total_iteration_count += 1;
+
+	return 1;
+}
+
+void test_iterate_with_context(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t seen = 0;
+
+	hashmap_init(&map);
+
+	map.iteration_callback = test_iterate_with_context_callback;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_iterate(&map, &seen);
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, seen);
+
+	hashmap_free(&map);
+}
+
+void test_iterate_break(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t iterations = 0;
+
+	hashmap_init(&map);
+
+	map.iteration_callback = test_iterate_break_after_x_iter;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_iterate(&map, &iterations);
+
+	TEST_ASSERT_EQUAL_UINT(TEST_ITERATIONS_BREAK, iterations);
+
+	hashmap_free(&map);
+}
+
+void test_iterate_from_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap expected = { 0 };
+
+	hashmap_iterate(&map, NULL);
+
+	TEST_ASSERT_EQUAL_MEMORY(&map, &expected, sizeof(Hashmap));
+}
+
+void test_duplicate_from_zero(void)
+{
+	Hashmap expected = { 0 };
+	Hashmap src = { 0 };
+	Hashmap dest = get_garbage_map(); /* To be overwritten */
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &src, sizeof(Hashmap));
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &dest, sizeof(Hashmap));
+}
+
+void test_duplicate_to_zero(void)
+{
+	Hashmap src = { 0 };
+	Hashmap dest = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&src, test_strings[idx], (int)idx);
+	}
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_EQUAL_UINT(src.size, dest.size);
+	TEST_ASSERT_EQUAL_UINT(src.capacity, dest.capacity);
+	TEST_ASSERT_EQUAL(src.iteration_callback, dest.iteration_callback);
+	TEST_ASSERT_NOT_EQUAL(src.slots, dest.slots);
+
+	hashmap_clear(&src);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&dest, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&src);
+	hashmap_free(&dest);
+}
+
+void test_clear_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_clear(&map);
+	TEST_ASSERT_NULL(map.slots);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.capacity);
+}
+
+void test_clear(void)
+{
+	Hashmap map = { 0 };
+
+	hashmap_insert(&map, "hello", 10);
+	hashmap_clear(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_has(&map, "hello"));
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_slot_size);
+	RUN_TEST(test_init_from_zero);
+	RUN_TEST(test_init_from_garbage);
+	RUN_TEST(test_grow_from_zero);
+	RUN_TEST(test_grow);
+	RUN_TEST(test_insert_from_zero);
+	RUN_TEST(test_insert_and_find);
+	RUN_TEST(test_insert_no_init);
+	RUN_TEST(test_insert_and_remove);
+	RUN_TEST(test_insert_many_hops);
+	RUN_TEST(test_insert_colliding);
+	RUN_TEST(test_insert_crowded);
+	RUN_TEST(test_remove_from_zero);
+	RUN_TEST(test_remove_half_even);
+	RUN_TEST(test_remove_all);
+	RUN_TEST(test_remove_not_inserted);
+	RUN_TEST(test_seed);
+	RUN_TEST(test_free);
+	RUN_TEST(test_free_zero);
+	RUN_TEST(test_iterate_with_context);
+	RUN_TEST(test_iterate_break);
+	RUN_TEST(test_iterate_from_zero);
+	RUN_TEST(test_duplicate_from_zero);
+	RUN_TEST(test_duplicate_to_zero);
+	RUN_TEST(test_clear_zero);
+	RUN_TEST(test_clear);
+
+	return UNITY_END();
+}
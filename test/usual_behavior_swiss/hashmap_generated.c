@@ -0,0 +1,6 @@
+#include "hashmap_generated.h"
+
+HASHMAP_DEFINE_SWISS(Hashmap, hashmap, const char *, int, hashmap_fnv1a_32_str,
+		     strcmp)
+
+HASHMAP_DEFINE_SWISS(PtrMap, ptr_map, const void *, int, NULL, NULL)
@@ -0,0 +1,13 @@
+#ifndef HASHMAP_GENERATED_H
+#define HASHMAP_GENERATED_H
+
+#define HASHMAP_LONG_JUMP_NO_ABORT
+#include "hashmap.h"
+
+HASHMAP_DECLARE_SWISS(Hashmap, hashmap, const char *, int,
+		      hashmap_fnv1a_32_str, strcmp)
+
+/* Keys hashed by their bytes, with the seed of the map */
+HASHMAP_DECLARE_SWISS(PtrMap, ptr_map, const void *, int, NULL, NULL)
+
+#endif /* HASHMAP_GENERATED_H */
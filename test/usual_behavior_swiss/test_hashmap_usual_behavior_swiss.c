@@ -0,0 +1,703 @@
+#include <assert.h>
+#include <string.h>
+
+#include "unity/unity.h"
+#include "hashmap_generated.h"
+
+enum { TEST_STRESS_MULTIPLIER = 1000U, TEST_ITERATIONS_BREAK = 50U };
+enum { TEST_INITIAL_CAPACITY = HASHMAP_SWISS_GROUP_SIZE };
+
+jmp_buf abort_jmp;
+
+const char *test_strings[] = {
+	"hello",    "world",	"dragons!", "testing", "hashmap",    "function",
+	"alice",    "bob",	"charlie",  "delta",   "echo",	     "foxtrot",
+	"apple",    "banana",	"cherry",   "date",    "elderberry", "fig",
+	"red",	    "green",	"blue",	    "yellow",  "purple",     "orange",
+	"cat",	    "dog",	"bird",	    "fish",    "rabbit",     "hamster",
+	"mountain", "river",	"ocean",    "forest",  "desert",     "valley",
+	"quick",    "brown",	"fox",	    "jumps",   "over",	     "lazy",
+	"alpha",    "beta",	"gamma",    "theta",   "omega",	     "sigma",
+	"one",	    "two",	"three",    "four",    "five",	     "six",
+	"january",  "february", "march",    "april",   "may",	     "june",
+	"coffee",   "tea",	"water",    "juice",   "milk",	     "soda",
+	"keyboard", "mouse",	"screen",   "laptop",  "desktop",    "tablet",
+	"happy",    "sad",	"angry",    "excited", "calm",	     "tired",
+	"north",    "south",	"east",	    "west",    "center",     "edge",
+	"start",    "middle",	"end",	    "begin",   "finish",     "complete",
+	"tiny",	    "small",	"medium",   "large",   "huge",	     "giant",
+	"fast",	    "slow",	"gauss",    "rapid",   "swift",	     "gradual",
+	"light",    "dark",	"bright",   "dim",     "shadow",     "glow"
+};
+const size_t test_strings_size = sizeof(test_strings) / sizeof(const char *);
+
+Hashmap get_garbage_map(void)
+{
+	Hashmap map = { 0 };
+
+	map.slots = (struct HashmapSlot *)0xDEADBEEF;
+	map.ctrl = (unsigned char *)0xDEADBEEF;
+	map.iteration_callback = (int (*)(const char *, int, void *))0xDEADBEEF;
+	map.size = 0xDEADBEEF;
+	map.capacity = 0xDEADBEEF;
+	map.deleted = 0xDEADBEEF;
+
+	return map;
+}
+
+/* Every full control byte must hold the fingerprint of its key */
+void assert_control_bytes(const Hashmap *map)
+{
+	size_t idx = 0;
+	size_t occupied = 0;
+	size_t deleted = 0;
+
+	for (idx = 0; idx < map->capacity; idx++) {
+		if (map->ctrl[idx] == HASHMAP_SWISS_DELETED) {
+			deleted++;
+			continue;
+		}
+		if (map->ctrl[idx] == HASHMAP_SWISS_EMPTY) {
+			continue;
+		}
+
+		occupied++;
+		TEST_ASSERT_EQUAL_HEX8(
+			hashmap_hash(map, map->slots[idx].key) & 0x7F,
+			map->ctrl[idx]);
+		TEST_ASSERT_EQUAL_INT(1, hashmap_has(map, map->slots[idx].key));
+	}
+
+	TEST_ASSERT_EQUAL_UINT(map->size, occupied);
+	TEST_ASSERT_EQUAL_UINT(map->deleted, deleted);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_init_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_init(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_init_from_garbage(void)
+{
+	Hashmap map = get_garbage_map();
+
+	hashmap_init(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_grow_from_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_grow(&map);
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY << 1, map.capacity);
+	hashmap_free(&map);
+}
+
+void test_grow(void)
+{
+	Hashmap map = { 0 };
+	size_t previous_capacity = 0;
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		previous_capacity = map.capacity;
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+		if (previous_capacity != 0 &&
+		    previous_capacity != map.capacity) {
+			TEST_ASSERT_EQUAL_UINT(previous_capacity << 1,
+					       map.capacity);
+		}
+		TEST_ASSERT_LESS_OR_EQUAL_FLOAT(
+			HASHMAP_SWISS_LOAD_FACTOR,
+			(float)map.size / (float)map.capacity);
+	}
+
+	assert_control_bytes(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&map, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_insert_from_zero(void)
+{
+	Hashmap map = { 0 };
+	int out = 0;
+
+	hashmap_insert(&map, "hello", 10);
+
+	TEST_ASSERT_EQUAL_UINT(1, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.iteration_callback);
+
+	TEST_ASSERT_EQUAL_INT(1, hashmap_get(&map, "hello", &out));
+	TEST_ASSERT_EQUAL_INT(10, out);
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_find(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int replaced = 0;
+	int found = 0;
+	int gotten = 0;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		gotten = -1;
+		if (idx < test_strings_size) {
+			found = hashmap_get(
+				&map, test_strings[idx % test_strings_size],
+				&gotten);
+			TEST_ASSERT_EQUAL_INT(0, found);
+			TEST_ASSERT_EQUAL_INT(-1, gotten);
+		}
+
+		replaced = hashmap_insert(
+			&map, test_strings[idx % test_strings_size], (int)idx);
+
+		if (idx < test_strings_size) {
+			TEST_ASSERT_EQUAL_UINT(idx + 1, map.size);
+			TEST_ASSERT_EQUAL_INT(0, replaced);
+		} else {
+			TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+			TEST_ASSERT_EQUAL_INT(1, replaced);
+		}
+
+		found = hashmap_get(&map, test_strings[idx % test_strings_size],
+				    &gotten);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	for (idx = 0; idx < max_idx; idx++) {
+		found = hashmap_get(&map, test_strings[idx % test_strings_size],
+				    &gotten);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(max_idx - test_strings_size +
+					      (idx % test_strings_size),
+				      gotten);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_insert_no_init(void)
+{
+	Hashmap map = { 0 };
+
+	hashmap_insert(&map, "hello", 10);
+
+	TEST_ASSERT_EQUAL_UINT(1, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_NOT_NULL(map.slots);
+
+	hashmap_free(&map);
+}
+
+void test_remove_from_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap expected = { 0 };
+	int out = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, hashmap_remove(&map, "hello", &out));
+	TEST_ASSERT_EQUAL_INT(0, out);
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &map, sizeof(Hashmap));
+}
+
+void test_remove_half_even(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+	int gotten = 0;
+	int found = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx += 2) {
+		found = hashmap_remove(&map, test_strings[idx], &removed);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, removed);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size / 2, map.size);
+	assert_control_bytes(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		found = hashmap_get(&map, test_strings[idx], &gotten);
+
+		if (idx % 2 == 0) {
+			TEST_ASSERT_EQUAL_INT(0, found);
+		} else {
+			TEST_ASSERT_EQUAL_INT(1, found);
+			TEST_ASSERT_EQUAL_INT(idx, gotten);
+		}
+	}
+
+	hashmap_free(&map);
+}
+
+void test_remove_all(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+	int found = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		found = hashmap_remove(&map, test_strings[idx], &removed);
+		TEST_ASSERT_EQUAL_INT(1, found);
+		TEST_ASSERT_EQUAL_INT(idx, removed);
+		assert_control_bytes(&map);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_GREATER_THAN_UINT(0, map.capacity);
+
+	for (idx = 0; idx < map.capacity; idx++) {
+		TEST_ASSERT_BITS_HIGH(0x80, map.ctrl[idx]);
+	}
+
+	hashmap_free(&map);
+}
+
+void test_remove_not_inserted(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	int removed = 0;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			0, hashmap_remove(&map, test_strings[idx], &removed));
+		TEST_ASSERT_EQUAL_INT(0, removed);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+
+	hashmap_free(&map);
+}
+
+void test_insert_and_remove(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t inserting = 0;
+	int replaced = 0;
+	int added_total = 0;
+	int removed_total = 0;
+	int removed_value = 0;
+
+	const char *test_string = NULL;
+	const size_t max_idx = test_strings_size * TEST_STRESS_MULTIPLIER;
+
+	hashmap_init(&map);
+
+	for (idx = 0; idx < max_idx; idx++) {
+		test_string = test_strings[idx % test_strings_size];
+
+		/* Randomly choose whether we insert or delete */
+		inserting = idx;
+		inserting ^= inserting >> 16;
+		inserting *= 0x85ebca6b;
+		inserting ^= inserting >> 13;
+		inserting *= 0xc2b2ae35;
+		inserting ^= inserting >> 16;
+
+		if (inserting % 2 == 0) {
+			replaced = hashmap_insert(&map, test_string, (int)idx);
+			if (replaced == 0) {
+				added_total++;
+			}
+		} else {
+			removed_total += hashmap_remove(&map, test_string,
+							&removed_value);
+		}
+
+		TEST_ASSERT_EQUAL_UINT(added_total - removed_total, map.size);
+	}
+
+	assert_control_bytes(&map);
+
+	hashmap_free(&map);
+}
+
+/* The seed of the map picks the control bytes of keys hashed by their
+ * bytes */
+void test_seed(void)
+{
+	PtrMap first = { 0 };
+	PtrMap second = { 0 };
+	PtrMap copy = { 0 };
+	unsigned long seed = 0;
+	unsigned long hash = 0;
+	size_t slot = 0;
+	size_t changed = 0;
+	size_t idx = 0;
+	int gotten = 0;
+	unsigned char fingerprint = 0;
+
+	ptr_map_init(&first);
+	ptr_map_init(&second);
+	second.seed = first.seed ^ 1UL;
+	seed = first.seed;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		ptr_map_insert(&first, test_strings[idx], (int)idx);
+		ptr_map_insert(&second, test_strings[idx], (int)idx);
+	}
+
+	/* Each control byte holds the fingerprint of the seeded hash, so most
+	 * of them differ under the other seed */
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hash = ptr_map_hash(&first, test_strings[idx]);
+		slot = ptr_map_find(&first, test_strings[idx], hash);
+		TEST_ASSERT_TRUE(slot < first.capacity);
+		fingerprint = first.ctrl[slot];
+		TEST_ASSERT_EQUAL_HEX8(hash & 0x7F, fingerprint);
+
+		hash = ptr_map_hash(&second, test_strings[idx]);
+		slot = ptr_map_find(&second, test_strings[idx], hash);
+		TEST_ASSERT_TRUE(slot < second.capacity);
+		TEST_ASSERT_EQUAL_HEX8(hash & 0x7F, second.ctrl[slot]);
+		if (second.ctrl[slot] != fingerprint) {
+			changed++;
+		}
+	}
+	TEST_ASSERT_GREATER_THAN_UINT(test_strings_size / 2, changed);
+
+	/* Growth and duplicates keep the seed */
+	TEST_ASSERT_TRUE(first.seed == seed);
+	ptr_map_duplicate(&copy, &first);
+	TEST_ASSERT_TRUE(copy.seed == seed);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, ptr_map_get(&copy, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+		TEST_ASSERT_EQUAL_INT(
+			1, ptr_map_get(&second, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	ptr_map_free(&first);
+	ptr_map_free(&second);
+	ptr_map_free(&copy);
+}
+
+void test_free(void)
+{
+	Hashmap map = { 0 };
+	Hashmap map_zero = { 0 };
+	hashmap_init(&map);
+	hashmap_free(&map);
+	TEST_ASSERT_EQUAL_MEMORY(&map_zero, &map, sizeof(Hashmap));
+}
+
+void test_free_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap map_zero = { 0 };
+	hashmap_free(&map);
+	TEST_ASSERT_EQUAL_MEMORY(&map_zero, &map, sizeof(Hashmap));
+}
+
+int test_iterate_with_context_callback(const char *key, int val, void *context)
+{
+	size_t *seen = (size_t *)context;
+
+	TEST_ASSERT_NOT_NULL(key);
+	TEST_ASSERT_EQUAL_STRING(test_strings[val], key);
+
+	*seen += 1;
+
+	return 1;
+}
+
+int test_iterate_break_after_x_iter(const char *key, int val, void *context)
+{
+	size_t *total_iteration_count = (size_t *)context;
+
+	(void)key;
+	(void)val;
+
+	if (*total_iteration_count >= TEST_ITERATIONS_BREAK) {
+		return 0;
+	}
+
+	*total_iteration_count += 1;
+
+	return 1;
+}
+
+void test_iterate_with_context(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t seen = 0;
+
+	hashmap_init(&map);
+
+	map.iteration_callback = test_iterate_with_context_callback;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_iterate(&map, &seen);
+
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, seen);
+
+	hashmap_free(&map);
+}
+
+void test_iterate_break(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t iterations = 0;
+
+	hashmap_init(&map);
+
+	map.iteration_callback = test_iterate_break_after_x_iter;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+
+	hashmap_iterate(&map, &iterations);
+
+	TEST_ASSERT_EQUAL_UINT(TEST_ITERATIONS_BREAK, iterations);
+
+	hashmap_free(&map);
+}
+
+void test_iterate_from_zero(void)
+{
+	Hashmap map = { 0 };
+	Hashmap expected = { 0 };
+
+	hashmap_iterate(&map, NULL);
+
+	TEST_ASSERT_EQUAL_MEMORY(&map, &expected, sizeof(Hashmap));
+}
+
+void test_duplicate_from_zero(void)
+{
+	Hashmap expected = { 0 };
+	Hashmap src = { 0 };
+	Hashmap dest = get_garbage_map(); /* To be overwritten */
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &src, sizeof(Hashmap));
+	TEST_ASSERT_EQUAL_MEMORY(&expected, &dest, sizeof(Hashmap));
+}
+
+void test_duplicate_to_zero(void)
+{
+	Hashmap src = { 0 };
+	Hashmap dest = { 0 };
+	size_t idx = 0;
+	int gotten = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&src, test_strings[idx], (int)idx);
+	}
+
+	hashmap_duplicate(&dest, &src);
+
+	TEST_ASSERT_EQUAL_UINT(src.size, dest.size);
+	TEST_ASSERT_EQUAL_UINT(src.capacity, dest.capacity);
+	TEST_ASSERT_EQUAL(src.iteration_callback, dest.iteration_callback);
+	TEST_ASSERT_NOT_EQUAL(src.slots, dest.slots);
+
+	hashmap_clear(&src);
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		TEST_ASSERT_EQUAL_INT(
+			1, hashmap_get(&dest, test_strings[idx], &gotten));
+		TEST_ASSERT_EQUAL_INT(idx, gotten);
+	}
+
+	hashmap_free(&src);
+	hashmap_free(&dest);
+}
+
+void test_clear_zero(void)
+{
+	Hashmap map = { 0 };
+	hashmap_clear(&map);
+	TEST_ASSERT_NULL(map.slots);
+	TEST_ASSERT_NULL(map.ctrl);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(0, map.capacity);
+}
+
+void test_clear(void)
+{
+	Hashmap map = { 0 };
+
+	hashmap_insert(&map, "hello", 10);
+	hashmap_clear(&map);
+
+	TEST_ASSERT_NOT_NULL(map.slots);
+	TEST_ASSERT_EQUAL_UINT(0, map.size);
+	TEST_ASSERT_EQUAL_UINT(TEST_INITIAL_CAPACITY, map.capacity);
+	TEST_ASSERT_EQUAL_INT(0, hashmap_has(&map, "hello"));
+
+	hashmap_free(&map);
+}
+
+void test_group_match(void)
+{
+	unsigned char group[HASHMAP_SWISS_GROUP_SIZE];
+	unsigned int expected = 0;
+	unsigned int expected_free = 0;
+	unsigned long state = 1;
+	size_t round = 0;
+	size_t idx = 0;
+
+	for (round = 0; round < TEST_STRESS_MULTIPLIER; round++) {
+		expected = 0;
+		expected_free = 0;
+
+		for (idx = 0; idx < HASHMAP_SWISS_GROUP_SIZE; idx++) {
+			state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+			switch ((state >> 16) % 4) {
+			case 0:
+				group[idx] = HASHMAP_SWISS_EMPTY;
+				break;
+			case 1:
+				group[idx] = HASHMAP_SWISS_DELETED;
+				break;
+			default:
+				group[idx] = (unsigned char)((state >> 8) % 4);
+				break;
+			}
+
+			if (group[idx] == 0x02) {
+				expected |= 1U << idx;
+			}
+			if ((group[idx] & 0x80) != 0) {
+				expected_free |= 1U << idx;
+			}
+		}
+
+		TEST_ASSERT_EQUAL_HEX16(expected,
+					hashmap_group_match(group, 0x02));
+		TEST_ASSERT_EQUAL_HEX16(expected_free,
+					hashmap_group_match_free(group));
+	}
+}
+
+void test_tombstones_purged(void)
+{
+	Hashmap map = { 0 };
+	size_t idx = 0;
+	size_t round = 0;
+	size_t capacity = 0;
+
+	for (idx = 0; idx < test_strings_size; idx++) {
+		hashmap_insert(&map, test_strings[idx], (int)idx);
+	}
+	capacity = map.capacity;
+
+	/* Churn through the same keys: capacity must not keep growing */
+	for (round = 0; round < TEST_STRESS_MULTIPLIER / 10; round++) {
+		for (idx = 0; idx < test_strings_size; idx += 3) {
+			TEST_ASSERT_EQUAL_INT(
+				1, hashmap_remove(&map, test_strings[idx],
+						  NULL));
+		}
+		for (idx = 0; idx < test_strings_size; idx += 3) {
+			TEST_ASSERT_EQUAL_INT(
+				0, hashmap_insert(&map, test_strings[idx],
+						  (int)idx));
+		}
+		assert_control_bytes(&map);
+	}
+
+	TEST_ASSERT_EQUAL_UINT(capacity, map.capacity);
+	TEST_ASSERT_EQUAL_UINT(test_strings_size, map.size);
+
+	hashmap_free(&map);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_init_from_zero);
+	RUN_TEST(test_init_from_garbage);
+	RUN_TEST(test_grow_from_zero);
+	RUN_TEST(test_grow);
+	RUN_TEST(test_insert_from_zero);
+	RUN_TEST(test_insert_and_find);
+	RUN_TEST(test_insert_no_init);
+	RUN_TEST(test_insert_and_remove);
+	RUN_TEST(test_remove_from_zero);
+	RUN_TEST(test_remove_half_even);
+	RUN_TEST(test_remove_all);
+	RUN_TEST(test_remove_not_inserted);
+	RUN_TEST(test_seed);
+	RUN_TEST(test_free);
+	RUN_TEST(test_free_zero);
+	RUN_TEST(test_iterate_with_context);
+	RUN_TEST(test_iterate_break);
+	RUN_TEST(test_iterate_from_zero);
+	RUN_TEST(test_duplicate_from_zero);
+	RUN_TEST(test_duplicate_to_zero);
+	RUN_TEST(test_clear_zero);
+	RUN_TEST(test_clear);
+	RUN_TEST(test_group_match);
+	RUN_TEST(test_tombstones_purged);
+
+	return UNITY_END();
+}